@@ -670,6 +670,35 @@ void PrintHeaderServerMethodGeneric(
   printer->Print(*vars, "};\n");
 }
 
+// For each streaming method, emit a writer typedef that bundles a reusable
+// FlatBufferBuilder with the stream (flatbuffers::GrpcStreamWriter), so per-
+// message overhead on a stream is just the serialize itself. Server-side
+// streams write the response type, client-side streams the request type.
+void PrintHeaderStreamWriters(grpc_generator::Printer *printer,
+                              const grpc_generator::Method *method,
+                              std::map<grpc::string, grpc::string> *vars) {
+  (*vars)["Method"] = method->name();
+  (*vars)["RequestName"] = method->input_name();
+  (*vars)["ResponseName"] = method->output_name();
+  if (method->ServerOnlyStreaming()) {
+    printer->Print(*vars,
+                   "typedef flatbuffers::GrpcStreamWriter< $ResponseName$> "
+                   "$Method$Writer;\n");
+  } else if (method->ClientOnlyStreaming()) {
+    printer->Print(*vars,
+                   "typedef flatbuffers::GrpcStreamWriter< $RequestName$> "
+                   "$Method$Writer;\n");
+  } else if (method->BidiStreaming()) {
+    // Both ends of a bidi stream write, each with its own message type.
+    printer->Print(*vars,
+                   "typedef flatbuffers::GrpcStreamWriter< $RequestName$> "
+                   "$Method$RequestWriter;\n");
+    printer->Print(*vars,
+                   "typedef flatbuffers::GrpcStreamWriter< $ResponseName$> "
+                   "$Method$ResponseWriter;\n");
+  }
+}
+
 void PrintHeaderService(grpc_generator::Printer *printer,
                         const grpc_generator::Service *service,
                         std::map<grpc::string, grpc::string> *vars) {
@@ -680,6 +709,11 @@ void PrintHeaderService(grpc_generator::Printer *printer,
                  " public:\n");
   printer->Indent();
 
+  // Per-stream writers with builder reuse.
+  for (int i = 0; i < service->method_count(); ++i) {
+    PrintHeaderStreamWriters(printer, service->method(i).get(), vars);
+  }
+
   // Client side
   printer->Print(
       "class StubInterface {\n"
@@ -18,11 +18,60 @@
 #define FLATBUFFERS_CODE_GENERATORS_H_
 
 #include <map>
-#include <sstream>
 #include "flatbuffers/idl.h"
 
 namespace flatbuffers {
 
+// Append-only rope for code emission. Generated files can run to many
+// megabytes, and growing one contiguous string repeatedly copies the whole
+// tail on reallocation; this buffer appends into fixed-size chunks instead
+// and only materializes the file once, so emission stays linear in output
+// size. ToString() makes a single exact-sized allocation.
+class CodeBuffer {
+ public:
+  CodeBuffer() : size_(0) {}
+
+  void Clear() {
+    chunks_.clear();
+    size_ = 0;
+  }
+
+  void Append(const char *str, size_t len) {
+    while (len) {
+      if (chunks_.empty() || chunks_.back().size() == kChunkSize) {
+        chunks_.push_back(std::string());
+        chunks_.back().reserve(kChunkSize);
+      }
+      auto &chunk = chunks_.back();
+      auto n = len < kChunkSize - chunk.size() ? len
+                                               : kChunkSize - chunk.size();
+      chunk.append(str, n);
+      str += n;
+      len -= n;
+      size_ += n;
+    }
+  }
+
+  void Append(const std::string &str) { Append(str.data(), str.size()); }
+
+  void Append(char c) { Append(&c, 1); }
+
+  size_t size() const { return size_; }
+
+  std::string ToString() const {
+    std::string result;
+    result.reserve(size_);
+    for (auto it = chunks_.begin(); it != chunks_.end(); ++it) result += *it;
+    return result;
+  }
+
+ private:
+  static const size_t kChunkSize = 64 * 1024;
+
+  std::vector<std::string> chunks_;
+  size_t size_;
+};
+
 // Utility class to assist in generating code through use of text templates.
 //
 // Example code:
@@ -41,10 +90,7 @@ class CodeWriter {
   CodeWriter() {}
 
   // Clears the current "written" code.
-  void Clear() {
-    stream_.str("");
-    stream_.clear();
-  }
+  void Clear() { buffer_.Clear(); }
 
   // Associates a key with a value.  All subsequent calls to operator+=, where
   // the specified key is contained in {{ and }} delimiters will be replaced by
@@ -60,11 +106,11 @@ class CodeWriter {
   void operator+=(std::string text);
 
   // Returns the current contents of the CodeWriter as a std::string.
-  std::string ToString() const { return stream_.str(); }
+  std::string ToString() const { return buffer_.ToString(); }
 
  private:
   std::map<std::string, std::string> value_map_;
-  std::stringstream stream_;
+  CodeBuffer buffer_;
 };
 
 class BaseGenerator {
@@ -33,7 +33,6 @@
 #endif
 #include <type_traits>
 #include <vector>
-#include <set>
 #include <algorithm>
 #include <memory>
 
@@ -41,7 +40,10 @@
   #define FLATBUFFERS_CPP98_STL
 #endif
 #ifndef FLATBUFFERS_CPP98_STL
+  #include <atomic>
   #include <functional>
+  #include <unordered_map>
+  #include <unordered_set>
 #endif
 
 /// @cond FLATBUFFERS_INTERNAL
@@ -120,6 +122,13 @@
   #define FLATBUFFERS_NOEXCEPT
 #endif
 
+// Software prefetch hint; falls back to a no-op where unsupported.
+#if defined(__GNUC__) || defined(__clang__)
+  #define FLATBUFFERS_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+  #define FLATBUFFERS_PREFETCH(addr) ((void)(addr))
+#endif
+
 #if defined(_MSC_VER)
 #pragma warning(push)
 #pragma warning(disable: 4127) // C4127: conditional expression is constant
@@ -191,14 +200,25 @@ template<typename T> T EndianSwap(T t) {
   if (sizeof(T) == 1) {   // Compile-time if-then's.
     return t;
   } else if (sizeof(T) == 2) {
-    auto r = FLATBUFFERS_BYTESWAP16(*reinterpret_cast<uint16_t *>(&t));
-    return *reinterpret_cast<T *>(&r);
+    // Type-pun through memcpy rather than reinterpret_cast: it is free of
+    // aliasing UB and compiles to the same single bswap instruction.
+    uint16_t u;
+    memcpy(&u, &t, sizeof(T));
+    u = FLATBUFFERS_BYTESWAP16(u);
+    memcpy(&t, &u, sizeof(T));
+    return t;
   } else if (sizeof(T) == 4) {
-    auto r = FLATBUFFERS_BYTESWAP32(*reinterpret_cast<uint32_t *>(&t));
-    return *reinterpret_cast<T *>(&r);
+    uint32_t u;
+    memcpy(&u, &t, sizeof(T));
+    u = FLATBUFFERS_BYTESWAP32(u);
+    memcpy(&t, &u, sizeof(T));
+    return t;
   } else if (sizeof(T) == 8) {
-    auto r = FLATBUFFERS_BYTESWAP64(*reinterpret_cast<uint64_t *>(&t));
-    return *reinterpret_cast<T *>(&r);
+    uint64_t u;
+    memcpy(&u, &t, sizeof(T));
+    u = FLATBUFFERS_BYTESWAP64(u);
+    memcpy(&t, &u, sizeof(T));
+    return t;
   } else {
     assert(0);
   }
@@ -220,6 +240,29 @@ template<typename T> void WriteScalar(void *p, T t) {
   *reinterpret_cast<T *>(p) = EndianScalar(t);
 }
 
+// Swap the byte order of "len" scalars in place, in a single pass.
+// The loop body reduces to one bswap (or equivalent) instruction per
+// element and is trivially unrollable / vectorizable by the compiler,
+// unlike going through EndianScalar one element at a time.
+template<typename T> void EndianSwapBuffer(T *data, size_t len) {
+  for (size_t i = 0; i < len; i++) data[i] = EndianSwap(data[i]);
+}
+
+// Copy "len" scalars from "src" to "dst", converting between native and
+// wire (little endian) byte order. On little endian targets this is a
+// plain memcpy.
+template<typename T> void EndianCopy(T *dst, const T *src, size_t len) {
+  #if FLATBUFFERS_LITTLEENDIAN
+    memcpy(dst, src, len * sizeof(T));
+  #else
+    if (sizeof(T) == 1) {
+      memcpy(dst, src, len);
+    } else {
+      for (size_t i = 0; i < len; i++) dst[i] = EndianSwap(src[i]);
+    }
+  #endif
+}
+
 template<typename T> size_t AlignOf() {
   #ifdef _MSC_VER
     return __alignof(T);
@@ -433,6 +476,30 @@ public:
   const T *data() const { return reinterpret_cast<const T *>(Data()); }
   T *data() { return reinterpret_cast<T *>(Data()); }
 
+  // Bulk-read "count" elements starting at "start" into "dst" in native
+  // byte order, converting from the wire format in a single pass rather
+  // than through Get() per element. Scalars only.
+  void CopyToNative(T *dst, uoffset_t start, uoffset_t count) const {
+    assert(start + count <= size());
+    EndianCopy(dst, data() + start, count);
+  }
+
+  // Resolve a batch of elements in one pass: "dst" receives what Get()
+  // would return for each of the "count" elements starting at "start".
+  // For vectors of tables/strings, each resolved target is prefetched as
+  // its offset is read, so a scan's dependent loads overlap in the memory
+  // system instead of serializing, and the caller can then walk the batch
+  // with the data already on its way to cache.
+  void GetBatch(uoffset_t start, uoffset_t count, return_type *dst) const {
+    assert(start + count <= size());
+    for (uoffset_t i = 0; i < count; i++) {
+      dst[i] = IndirectHelper<T>::Read(Data(), start + i);
+      Prefetch(dst[i],
+               std::integral_constant<bool,
+                                      std::is_pointer<return_type>::value>());
+    }
+  }
+
   template<typename K> return_type LookupByKey(K key) const {
     void *search_result = std::bsearch(&key, Data(), size(),
         IndirectHelper<T>::element_stride, KeyCompare<K>);
@@ -458,6 +525,13 @@ private:
   // Private and unimplemented copy constructor.
   Vector(const Vector&);
 
+  // GetBatch prefetches resolved pointers; scalar elements were already
+  // loaded by the batch read itself.
+  template<typename U> static void Prefetch(U p, std::true_type) {
+    FLATBUFFERS_PREFETCH(p);
+  }
+  template<typename U> static void Prefetch(U, std::false_type) {}
+
   template<typename K> static int KeyCompare(const void *ap, const void *bp) {
     const K *key = reinterpret_cast<const K *>(ap);
     const uint8_t *data = reinterpret_cast<const uint8_t *>(bp);
@@ -490,6 +564,28 @@ private:
   VectorOfAny(const VectorOfAny&);
 };
 
+// Swap the byte order of every element of an untyped vector of scalars in
+// place, for when the element size is only known at runtime (used with
+// reflection.h). A no-op for 1-byte elements.
+inline void EndianSwapAnyVector(VectorOfAny *vec, size_t elem_size) {
+  switch (elem_size) {
+    case 1: break;
+    case 2:
+      EndianSwapBuffer(reinterpret_cast<uint16_t *>(vec->Data()),
+                       vec->size());
+      break;
+    case 4:
+      EndianSwapBuffer(reinterpret_cast<uint32_t *>(vec->Data()),
+                       vec->size());
+      break;
+    case 8:
+      EndianSwapBuffer(reinterpret_cast<uint64_t *>(vec->Data()),
+                       vec->size());
+      break;
+    default: assert(0);
+  }
+}
+
 #ifndef FLATBUFFERS_CPP98_STL
 template<typename T, typename U>
 Vector<Offset<T>> *VectorCast(Vector<Offset<U>> *ptr) {
@@ -510,6 +606,56 @@ template<typename T> static inline size_t VectorLength(const Vector<T> *v) {
   return v ? v->Length() : 0;
 }
 
+// Eytzinger (BFS-ordered) search index support. Binary searching a huge
+// vector of tables through LookupByKey costs a cache miss per probe, since
+// every comparison dereferences a table. An Eytzinger index is a compact
+// side array of just the keys, laid out so each search step descends one
+// level of an implicit tree; probes stay within a few cache lines until
+// the very end, and only the final match dereferences a table.
+// Build the two index vectors with FlatBufferBuilder::CreateEytzingerIndex
+// and store them as siblings of the sorted vector they index.
+
+// Internal: fill keys/positions in BFS order from a sorted key column.
+// "node" is the 1-based index of the current tree node, "in" walks the
+// sorted input (an in-order traversal of the tree visits it in order).
+template<typename K> void EytzingerFill(const K *sorted, uoffset_t len,
+                                        uoffset_t node, uoffset_t *in,
+                                        K *keys, uoffset_t *positions) {
+  if (node > len) return;
+  EytzingerFill(sorted, len, node * 2, in, keys, positions);
+  keys[node - 1] = sorted[*in];
+  positions[node - 1] = *in;
+  ++*in;
+  EytzingerFill(sorted, len, node * 2 + 1, in, keys, positions);
+}
+
+// Search an Eytzinger-ordered key vector. Returns the position of the key
+// in the original sorted vector, or -1 if it is not present.
+template<typename K> soffset_t EytzingerLookup(
+    const Vector<K> *keys, const Vector<uoffset_t> *positions, K key) {
+  auto len = keys->size();
+  uoffset_t node = 1;
+  while (node <= len) {
+    auto v = keys->Get(node - 1);
+    if (v == key) return static_cast<soffset_t>(positions->Get(node - 1));
+    // Descend left on smaller keys, right on bigger ones; the index of a
+    // node's children is a shift away, so there is no branch on the path
+    // taken beyond this comparison.
+    node = node * 2 + static_cast<uoffset_t>(v < key);
+  }
+  return -1;
+}
+
+// Look up a table in "vec" (sorted by key) through its Eytzinger index,
+// dereferencing only the final match. The alternative to LookupByKey for
+// very large sorted vectors.
+template<typename T, typename K> const T *LookupByKeyFast(
+    const Vector<Offset<T>> *vec, const Vector<K> *index_keys,
+    const Vector<uoffset_t> *index_positions, K key) {
+  auto pos = EytzingerLookup(index_keys, index_positions, key);
+  return pos < 0 ? nullptr : vec->Get(static_cast<uoffset_t>(pos));
+}
+
 struct String : public Vector<char> {
   const char *c_str() const { return reinterpret_cast<const char *>(Data()); }
   std::string str() const { return std::string(c_str(), Length()); }
@@ -526,6 +672,191 @@ class simple_allocator {
   virtual ~simple_allocator() {}
   virtual uint8_t *allocate(size_t size) const { return new uint8_t[size]; }
   virtual void deallocate(uint8_t *p) const { delete[] p; }
+
+  // Called when a buffer that grows from high to low addresses (see
+  // vector_downward below) runs out of space. The default implementation
+  // allocates a bigger block and copies the in-use tail (the "in_use_back"
+  // bytes ending at old_p + old_size) to the end of the new block.
+  // Allocators that can extend a block downwards in place (keeping the end
+  // address fixed) may override this to avoid the copy entirely.
+  virtual uint8_t *reallocate_downward(uint8_t *old_p, size_t old_size,
+                                       size_t new_size,
+                                       size_t in_use_back) const {
+    assert(new_size > old_size);  // vector_downward only grows.
+    auto new_p = allocate(new_size);
+    memcpy(new_p + new_size - in_use_back, old_p + old_size - in_use_back,
+           in_use_back);
+    deallocate(old_p);
+    return new_p;
+  }
+};
+
+// An allocator that hands out memory from a single block (the "arena"),
+// top-down. Because vector_downward keeps its in-use bytes at the end of its
+// allocation, growing the most recent arena allocation simply extends it
+// downwards in place: the end address is unchanged, so no bytes are copied.
+// This removes the realloc-copy cost from buffer growth entirely, at the
+// price of committing the arena up front.
+// The arena may be owned (first constructor) or caller-owned (second
+// constructor), the latter allowing many builders to share pooled pages.
+// Individual deallocations are no-ops; all memory is reclaimed when the
+// arena is destroyed or reset().
+class arena_allocator : public simple_allocator {
+ public:
+  explicit arena_allocator(size_t arena_size)
+    : arena_(new uint8_t[arena_size]), cur_(arena_ + arena_size),
+      end_(arena_ + arena_size), owned_(true) {}
+
+  // Use a caller-owned block of memory as the arena. The block must outlive
+  // this allocator and any builders using it.
+  arena_allocator(uint8_t *arena, size_t arena_size)
+    : arena_(arena), cur_(arena + arena_size), end_(arena + arena_size),
+      owned_(false) {}
+
+  ~arena_allocator() { if (owned_) delete[] arena_; }
+
+  // Make the whole arena available again. Only call this when no buffers
+  // allocated from it are alive anymore.
+  void reset() { cur_ = end_; }
+
+  size_t space_remaining() const {
+    return static_cast<size_t>(cur_ - arena_);
+  }
+
+  uint8_t *allocate(size_t size) const {
+    // If you hit this assert, the arena was sized too small for the buffers
+    // built from it. Grow it, or fall back to the default allocator.
+    assert(size <= space_remaining());
+    cur_ -= size;
+    return cur_;
+  }
+
+  void deallocate(uint8_t *) const {
+    // Arena memory is reclaimed wholesale in reset() / the destructor.
+  }
+
+  uint8_t *reallocate_downward(uint8_t *old_p, size_t old_size,
+                               size_t new_size,
+                               size_t in_use_back) const {
+    if (old_p == cur_) {
+      // The buffer being grown is the lowest allocation in the arena, so we
+      // can extend it downwards in place. Its bytes end at the same address
+      // as before, which is all vector_downward requires: no copy needed.
+      assert(new_size - old_size <= space_remaining());
+      cur_ -= new_size - old_size;
+      return cur_;
+    }
+    return simple_allocator::reallocate_downward(old_p, old_size, new_size,
+                                                 in_use_back);
+  }
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  arena_allocator(const arena_allocator &);
+  arena_allocator &operator=(const arena_allocator &);
+
+  uint8_t *arena_;
+  mutable uint8_t *cur_;  // Lowest address handed out so far.
+  uint8_t *end_;
+  bool owned_;
+};
+
+// A movable, self-deallocating handle to the memory of a finished buffer,
+// as returned by FlatBufferBuilder::Release(). Unlike ReleaseBufferPointer
+// it remembers the owning allocator and the full allocation (not just the
+// data pointer), so the memory can be handed between pipeline stages and
+// later given back to a builder via FlatBufferBuilder::Reattach, without
+// copies or allocator churn.
+class DetachedBuffer {
+ public:
+  DetachedBuffer()
+    : allocator_(nullptr), buf_(nullptr), reserved_(0), cur_(nullptr),
+      size_(0) {}
+
+  DetachedBuffer(const simple_allocator &allocator, uint8_t *buf,
+                 size_t reserved, uint8_t *cur, size_t sz)
+    : allocator_(&allocator), buf_(buf), reserved_(reserved), cur_(cur),
+      size_(sz) {}
+
+  DetachedBuffer(DetachedBuffer &&other) FLATBUFFERS_NOEXCEPT
+    : allocator_(nullptr), buf_(nullptr), reserved_(0), cur_(nullptr),
+      size_(0) {
+    take(other);
+  }
+
+  DetachedBuffer &operator=(DetachedBuffer &&other) FLATBUFFERS_NOEXCEPT {
+    if (this != &other) {
+      destroy();
+      take(other);
+    }
+    return *this;
+  }
+
+  ~DetachedBuffer() { destroy(); }
+
+  const uint8_t *data() const { return cur_; }
+  uint8_t *data() { return cur_; }
+  size_t size() const { return size_; }
+
+ private:
+  friend class vector_downward;
+
+  // Copying would double-free; move instead.
+  DetachedBuffer(const DetachedBuffer &);
+  DetachedBuffer &operator=(const DetachedBuffer &);
+
+  void take(DetachedBuffer &other) {
+    allocator_ = other.allocator_;
+    buf_ = other.buf_;
+    reserved_ = other.reserved_;
+    cur_ = other.cur_;
+    size_ = other.size_;
+    other.allocator_ = nullptr;
+    other.buf_ = nullptr;
+    other.reserved_ = 0;
+    other.cur_ = nullptr;
+    other.size_ = 0;
+  }
+
+  void destroy() {
+    if (buf_ && allocator_) allocator_->deallocate(buf_);
+    allocator_ = nullptr;
+    buf_ = nullptr;
+    reserved_ = 0;
+    cur_ = nullptr;
+    size_ = 0;
+  }
+
+  const simple_allocator *allocator_;
+  uint8_t *buf_;       // Start of the allocation.
+  size_t reserved_;    // Its total size.
+  uint8_t *cur_;       // Start of the data (the data ends at buf_ + reserved_).
+  size_t size_;
+};
+
+// Instrumentation counters maintained by a FlatBufferBuilder (see
+// FlatBufferBuilder::stats()). All plain counter increments on paths that
+// already do work of the same order, so they are cheap enough to stay
+// enabled in production builds; reset them around a region of interest to
+// attribute buffer bloat or serialization time. Counters accumulate across
+// Clear(), so one long-lived builder reports service-lifetime totals.
+struct BuilderStats {
+  uint64_t align_calls;         // Alignment operations performed.
+  uint64_t padding_bytes;       // Bytes lost to alignment padding.
+  uint64_t vtables_written;     // EndTable() calls that wrote a new vtable.
+  uint64_t vtables_deduped;     // EndTable() calls reusing an existing one.
+  uint64_t vtable_bytes_saved;  // Bytes the deduped vtables would have cost.
+  uint64_t regrowths;           // Times the buffer had to be reallocated.
+  uint64_t regrown_bytes;       // Total capacity added by those regrowths.
+  uint64_t finished_buffers;    // Finish() calls.
+  uint64_t finished_bytes;      // Total size of those finished buffers.
+
+  BuilderStats()
+    : align_calls(0), padding_bytes(0), vtables_written(0),
+      vtables_deduped(0), vtable_bytes_saved(0), regrowths(0),
+      regrown_bytes(0), finished_buffers(0), finished_bytes(0) {}
+
+  void Reset() { *this = BuilderStats(); }
 };
 
 // This is a minimal replication of std::vector<uint8_t> functionality,
@@ -539,7 +870,8 @@ class vector_downward {
         ~(sizeof(largest_scalar_t) - 1)),
       buf_(allocator.allocate(reserved_)),
       cur_(buf_ + reserved_),
-      allocator_(allocator) {}
+      allocator_(allocator),
+      stats_(nullptr) {}
 
   ~vector_downward() {
     if (buf_)
@@ -571,6 +903,32 @@ class vector_downward {
   }
   #endif
 
+  // Relinquish the whole allocation as a movable DetachedBuffer, leaving
+  // this vector empty. Like release(), the vector must be clear()ed before
+  // any further use.
+  DetachedBuffer detach() {
+    DetachedBuffer result(allocator_, buf_, reserved_, cur_, size());
+    buf_ = nullptr;
+    cur_ = nullptr;
+    return result;
+  }
+
+  // Adopt the memory of a previously detached buffer as this vector's
+  // storage, discarding the buffer's contents. The buffer must have been
+  // detached from a vector whose allocator this vector's allocator can
+  // deallocate for (e.g. both default-allocated).
+  void reattach(DetachedBuffer &b) {
+    if (buf_) allocator_.deallocate(buf_);
+    buf_ = b.buf_;
+    reserved_ = b.reserved_;
+    cur_ = buf_ + reserved_;
+    b.allocator_ = nullptr;
+    b.buf_ = nullptr;
+    b.reserved_ = 0;
+    b.cur_ = nullptr;
+    b.size_ = 0;
+  }
+
   size_t growth_policy(size_t bytes) {
     return (bytes / 2) & ~(sizeof(largest_scalar_t) - 1);
   }
@@ -624,6 +982,9 @@ class vector_downward {
 
   void pop(size_t bytes_to_remove) { cur_ += bytes_to_remove; }
 
+  // Report regrowths into "stats" (owned by the builder).
+  void set_stats(BuilderStats *stats) { stats_ = stats; }
+
  private:
   // You shouldn't really be copying instances of this class.
   vector_downward(const vector_downward &);
@@ -633,19 +994,24 @@ class vector_downward {
   uint8_t *buf_;
   uint8_t *cur_;  // Points at location between empty (below) and used (above).
   const simple_allocator &allocator_;
+  BuilderStats *stats_;
 
   void reallocate(size_t len) {
     auto old_size = size();
+    auto old_reserved = reserved_;
     auto largest_align = AlignOf<largest_scalar_t>();
     reserved_ += (std::max)(len, growth_policy(reserved_));
     // Round up to avoid undefined behavior from unaligned loads and stores.
     reserved_ = (reserved_ + (largest_align - 1)) & ~(largest_align - 1);
-    auto new_buf = allocator_.allocate(reserved_);
-    auto new_cur = new_buf + reserved_ - old_size;
-    memcpy(new_cur, cur_, old_size);
-    cur_ = new_cur;
-    allocator_.deallocate(buf_);
-    buf_ = new_buf;
+    // The allocator moves (or extends in place, see arena_allocator) the
+    // in-use bytes such that they still end at the end of the allocation.
+    buf_ = allocator_.reallocate_downward(buf_, old_reserved, reserved_,
+                                          old_size);
+    cur_ = buf_ + reserved_ - old_size;
+    if (stats_) {
+      stats_->regrowths++;
+      stats_->regrown_bytes += reserved_ - old_reserved;
+    }
   }
 };
 
@@ -700,6 +1066,7 @@ FLATBUFFERS_FINAL_CLASS
         dedup_vtables_(true), string_pool(nullptr) {
     offsetbuf_.reserve(16);  // Avoid first few reallocs.
     vtables_.reserve(16);
+    buf_.set_stats(&stats_);
     EndianCheck();
   }
 
@@ -715,6 +1082,9 @@ FLATBUFFERS_FINAL_CLASS
     nested = false;
     finished = false;
     vtables_.clear();
+    #ifndef FLATBUFFERS_CPP98_STL
+    vtable_index_.clear();
+    #endif
     minalign_ = 1;
     if (string_pool) string_pool->clear();
   }
@@ -748,6 +1118,26 @@ FLATBUFFERS_FINAL_CLASS
   }
   #endif
 
+  /// @brief Get the serialized buffer as a movable DetachedBuffer, which
+  /// (unlike `ReleaseBufferPointer()`) keeps the owning allocator and the
+  /// allocation's capacity, so the memory can later be handed back to a
+  /// builder with `Reattach()`.
+  /// @warning Do NOT attempt to use this FlatBufferBuilder afterwards,
+  /// other than calling `Clear()` or `Reattach()` first.
+  DetachedBuffer Release() {
+    Finished();
+    return buf_.detach();
+  }
+
+  /// @brief Take over the memory of `buf` (which must originate from a
+  /// builder using the same allocator) as this builder's storage and reset
+  /// all state, discarding the buffer's contents. This lets pipeline
+  /// stages return buffers to a pooled builder without allocator churn.
+  void Reattach(DetachedBuffer &&buf) {
+    buf_.reattach(buf);
+    Clear();
+  }
+
   /// @brief get the minimum alignment this buffer needs to be accessed
   /// properly. This is only known once all elements have been written (after
   /// you call Finish()). You can use this information if you need to embed
@@ -778,12 +1168,24 @@ FLATBUFFERS_FINAL_CLASS
   /// @param[in] bool dedup When set to `true`, dedup vtables.
   void DedupVtables(bool dedup) { dedup_vtables_ = dedup; }
 
+  /// @brief Instrumentation counters for this builder: padding, vtable
+  /// dedup, buffer regrowth and per-Finish totals (see BuilderStats).
+  /// Always maintained; they accumulate until ResetStats().
+  const BuilderStats &stats() const { return stats_; }
+
+  /// @brief Zero the instrumentation counters, e.g. to measure one
+  /// request or one region of interest.
+  void ResetStats() { stats_.Reset(); }
+
   /// @cond FLATBUFFERS_INTERNAL
   void Pad(size_t num_bytes) { buf_.fill(num_bytes); }
 
   void Align(size_t elem_size) {
     if (elem_size > minalign_) minalign_ = elem_size;
-    buf_.fill(PaddingBytes(buf_.size(), elem_size));
+    auto pad = PaddingBytes(buf_.size(), elem_size);
+    stats_.align_calls++;
+    stats_.padding_bytes += pad;
+    buf_.fill(pad);
   }
 
   void PushFlatBuffer(const uint8_t *bytes, size_t size) {
@@ -916,18 +1318,58 @@ FLATBUFFERS_FINAL_CLASS
     // See if we already have generated a vtable with this exact same
     // layout before. If so, make it point to the old one, remove this one.
     if (dedup_vtables_) {
-      for (auto it = vtables_.begin(); it != vtables_.end(); ++it) {
-        auto vt2 = reinterpret_cast<voffset_t *>(buf_.data_at(*it));
-        auto vt2_size = *vt2;
-        if (vt1_size != vt2_size || memcmp(vt2, vt1, vt1_size)) continue;
-        vt_use = *it;
+      uoffset_t dedup = 0;
+      #ifndef FLATBUFFERS_CPP98_STL
+      if (!vtable_index_.empty() ||
+          vtables_.size() >= kVtableIndexThreshold) {
+        // Enough distinct vtables that linear scans have become expensive:
+        // look up by byte hash instead, and only memcmp within the bucket.
+        if (vtable_index_.empty()) {
+          // Crossing the threshold: index the vtables seen so far.
+          for (auto it = vtables_.begin(); it != vtables_.end(); ++it) {
+            auto vt = reinterpret_cast<voffset_t *>(buf_.data_at(*it));
+            vtable_index_[HashVtableBytes(vt)].push_back(*it);
+          }
+        }
+        auto bucket = vtable_index_.find(HashVtableBytes(vt1));
+        if (bucket != vtable_index_.end()) {
+          for (auto it = bucket->second.begin();
+                    it != bucket->second.end(); ++it) {
+            auto vt2 = reinterpret_cast<voffset_t *>(buf_.data_at(*it));
+            auto vt2_size = *vt2;
+            if (vt1_size != vt2_size || memcmp(vt2, vt1, vt1_size)) continue;
+            dedup = *it;
+            break;
+          }
+        }
+      } else
+      #endif
+      {
+        // Few vtables so far: a linear scan beats maintaining an index.
+        for (auto it = vtables_.begin(); it != vtables_.end(); ++it) {
+          auto vt2 = reinterpret_cast<voffset_t *>(buf_.data_at(*it));
+          auto vt2_size = *vt2;
+          if (vt1_size != vt2_size || memcmp(vt2, vt1, vt1_size)) continue;
+          dedup = *it;
+          break;
+        }
+      }
+      if (dedup) {
+        vt_use = dedup;
+        stats_.vtables_deduped++;
+        stats_.vtable_bytes_saved += GetSize() - vtableoffsetloc;
         buf_.pop(GetSize() - vtableoffsetloc);
-        break;
       }
     }
     // If this is a new vtable, remember it.
     if (vt_use == GetSize()) {
+      stats_.vtables_written++;
       vtables_.push_back(vt_use);
+      #ifndef FLATBUFFERS_CPP98_STL
+      if (!vtable_index_.empty()) {
+        vtable_index_[HashVtableBytes(vt1)].push_back(vt_use);
+      }
+      #endif
     }
     // Fill the vtable offset we created above.
     // The offset points from the beginning of the object to where the
@@ -965,7 +1407,10 @@ FLATBUFFERS_FINAL_CLASS
   // Aligns such that when "len" bytes are written, an object can be written
   // after it with "alignment" without padding.
   void PreAlign(size_t len, size_t alignment) {
-    buf_.fill(PaddingBytes(GetSize() + len, alignment));
+    auto pad = PaddingBytes(GetSize() + len, alignment);
+    stats_.align_calls++;
+    stats_.padding_bytes += pad;
+    buf_.fill(pad);
   }
   template<typename T> void PreAlign(size_t len) {
     AssertScalarT<T>();
@@ -1024,20 +1469,18 @@ FLATBUFFERS_FINAL_CLASS
   /// @return Returns the offset in the buffer where the string starts.
   Offset<String> CreateSharedString(const char *str, size_t len) {
     if (!string_pool)
-      string_pool = new StringOffsetMap(StringOffsetCompare(buf_));
+      string_pool = new StringPool(buf_);
     auto size_before_string = buf_.size();
-    // Must first serialize the string, since the set is all offsets into
-    // buffer.
+    // Must first serialize the string, since the pool keys on offsets into
+    // the buffer.
     auto off = CreateString(str, len);
-    auto it = string_pool->find(off);
+    auto existing = string_pool->FindOrInsert(off);
     // If it exists we reuse existing serialized data!
-    if (it != string_pool->end()) {
+    if (existing.o) {
       // We can remove the string we serialized.
       buf_.pop(buf_.size() - size_before_string);
-      return *it;
+      return existing;
     }
-    // Record this string for future use.
-    string_pool->insert(off);
     return off;
   }
 
@@ -1094,6 +1537,26 @@ FLATBUFFERS_FINAL_CLASS
   uint8_t *ReserveElements(size_t len, size_t elemsize) {
     return buf_.make_space(len * elemsize);
   }
+
+  // Scalar vector elements are bulk-copied, converting endianness in one
+  // pass (see EndianCopy) instead of pushing one element at a time.
+  template<typename T> void PushVectorElements(const T *v, size_t len) {
+    AssertScalarT<T>();
+    // StartVector has already padded for the element size; this just
+    // records the vector's alignment requirement.
+    Align(sizeof(T));
+    auto dest = reinterpret_cast<T *>(buf_.make_space(len * sizeof(T)));
+    EndianCopy(dest, v, len);
+  }
+
+  // Offsets have to be converted to their relative form individually
+  // (see ReferTo), so they keep the per-element path.
+  template<typename T> void PushVectorElements(const Offset<T> *v,
+                                               size_t len) {
+    for (auto i = len; i > 0; ) {
+      PushElement(v[--i]);
+    }
+  }
   /// @endcond
 
   /// @brief Serialize an array into a FlatBuffer `vector`.
@@ -1105,13 +1568,7 @@ FLATBUFFERS_FINAL_CLASS
   /// where the vector is stored.
   template<typename T> Offset<Vector<T>> CreateVector(const T *v, size_t len) {
     StartVector(len, sizeof(T));
-    if (sizeof(T) == 1) {
-      PushBytes(reinterpret_cast<const uint8_t *>(v), len);
-    } else {
-      for (auto i = len; i > 0; ) {
-        PushElement(v[--i]);
-      }
-    }
+    PushVectorElements(v, len);
     return Offset<Vector<T>>(EndVector(len));
   }
 
@@ -1323,6 +1780,81 @@ FLATBUFFERS_FINAL_CLASS
                                      reinterpret_cast<uint8_t **>(buf));
   }
 
+  /// @brief Specialized version of `CreateVectorOfStructs` for non-copying
+  /// use cases. Write the structs any time later to the returned buffer
+  /// pointer `buf`, e.g. to decode straight out of a network buffer without
+  /// staging through a temporary array.
+  /// @tparam T The data type of the struct array elements.
+  /// @param[in] len The number of elements to store in the `vector`.
+  /// @param[out] buf A pointer to a pointer of type `T` that can be
+  /// written to at a later time to serialize the data into a `vector`
+  /// in the buffer.
+  template<typename T> Offset<Vector<const T *>>
+      CreateUninitializedVectorOfStructs(size_t len, T **buf) {
+    NotNested();
+    StartVector(len * sizeof(T) / AlignOf<T>(), AlignOf<T>());
+    buf_.make_space(len * sizeof(T));
+    // Only take the pointer after EndVector: writing the length field may
+    // still grow (and thus move) the buffer.
+    auto vec_start = GetSize();
+    auto vec_end = EndVector(len);
+    *buf = reinterpret_cast<T *>(buf_.data_at(vec_start));
+    return Offset<Vector<const T *>>(vec_end);
+  }
+
+  /// @brief Splice a finished FlatBuffer, built in another
+  /// FlatBufferBuilder, into this buffer, returning the offset of its root
+  /// table as if it had been built here.
+  /// All offsets within a buffer are relative, so the sub-buffer's bytes
+  /// are copied verbatim with no per-offset fixups; only the returned root
+  /// offset is relocated. This is the composition half of building a large
+  /// buffer on multiple threads: have worker threads each build and
+  /// Finish() a subtree in their own builder (with no file identifier),
+  /// then splice the results here and assemble the parent objects that
+  /// refer to them, e.g. a wide root vector of tables.
+  /// @tparam T The root type of the sub-buffer.
+  /// @param[in] sub The builder holding the finished sub-buffer. Only read;
+  /// may be Clear()ed and reused afterwards.
+  /// @return Returns the offset of the sub-buffer's root table within this
+  /// buffer.
+  template<typename T> Offset<T> SpliceBuffer(const FlatBufferBuilder &sub) {
+    NotNested();
+    auto sub_buf = sub.GetBufferPointer();
+    // The sub-buffer's root pointer is dropped: everything after it keeps
+    // its meaning, since offsets only ever point within the buffer.
+    auto region_len = sub.GetSize() - sizeof(uoffset_t);
+    auto root_pos = ReadScalar<uoffset_t>(sub_buf) - sizeof(uoffset_t);
+    // Alignment inside a buffer is relative to its end (buffers grow
+    // downwards), so the spliced bytes must end at a multiple of the
+    // sub-buffer's overall alignment.
+    Align(sub.minalign_);
+    PushBytes(sub_buf + sizeof(uoffset_t), region_len);
+    return Offset<T>(GetSize() - static_cast<uoffset_t>(root_pos));
+  }
+
+  /// @brief Build an Eytzinger-ordered search index over a sorted key
+  /// column, for use with `EytzingerLookup` / `LookupByKeyFast`. Serializes
+  /// two vectors: the keys in BFS order (returned) and, via `positions`,
+  /// each BFS slot's position in the original sorted vector. Store both as
+  /// siblings of the sorted vector they index.
+  /// @tparam K The scalar key type.
+  /// @param[in] sorted_keys The key of each element of the sorted vector,
+  /// in the same (ascending) order.
+  /// @param[in] len The number of keys.
+  /// @param[out] positions Receives the offset of the positions vector.
+  /// @return Returns the offset of the BFS-ordered key vector.
+  template<typename K> Offset<Vector<K>> CreateEytzingerIndex(
+      const K *sorted_keys, size_t len,
+      Offset<Vector<uoffset_t>> *positions) {
+    std::vector<K> keys(len);
+    std::vector<uoffset_t> pos(len);
+    uoffset_t in = 0;
+    EytzingerFill(sorted_keys, static_cast<uoffset_t>(len), 1, &in,
+                  data(keys), data(pos));
+    *positions = CreateVector(pos);
+    return CreateVector(keys);
+  }
+
   /// @brief The length of a FlatBuffer file header.
   static const size_t kFileIdentifierLength = 4;
 
@@ -1369,6 +1901,8 @@ FLATBUFFERS_FINAL_CLASS
       PushElement(GetSize());
     }
     finished = true;
+    stats_.finished_buffers++;
+    stats_.finished_bytes += GetSize();
   }
 
   struct FieldLoc {
@@ -1376,6 +1910,24 @@ FLATBUFFERS_FINAL_CLASS
     voffset_t id;
   };
 
+  // FNV-1a, used to hash vtables for the dedup index in EndTable() and
+  // string contents for the CreateSharedString pool.
+  static uint32_t HashBytes(const uint8_t *bytes, size_t size) {
+    uint32_t hash = 0x811C9DC5;
+    for (size_t i = 0; i < size; i++) {
+      hash ^= bytes[i];
+      hash *= 0x01000193;
+    }
+    return hash;
+  }
+
+  // Hash of the full byte contents of a vtable, as stored (little endian),
+  // which matches the memcmp used to confirm a candidate.
+  static uint32_t HashVtableBytes(const voffset_t *vt) {
+    return HashBytes(reinterpret_cast<const uint8_t *>(vt),
+                     ReadScalar<voffset_t>(vt));
+  }
+
   simple_allocator default_allocator;
 
   vector_downward buf_;
@@ -1389,28 +1941,224 @@ FLATBUFFERS_FINAL_CLASS
   // Ensure the buffer is finished before it is being accessed.
   bool finished;
 
-  std::vector<uoffset_t> vtables_;  // todo: Could make this into a map?
+  std::vector<uoffset_t> vtables_;
+
+  #ifndef FLATBUFFERS_CPP98_STL
+  // Buckets of vtables_ entries with equal byte hash. Only populated once
+  // vtables_ grows past kVtableIndexThreshold; below that, the linear scan
+  // in EndTable() is cheaper than maintaining this.
+  typedef std::unordered_map<uint32_t, std::vector<uoffset_t>> VtableIndex;
+  VtableIndex vtable_index_;
+  static const size_t kVtableIndexThreshold = 16;
+  #endif
 
   size_t minalign_;
 
+  BuilderStats stats_;
+
   bool force_defaults_;  // Serialize values equal to their defaults anyway.
 
   bool dedup_vtables_;
 
-  struct StringOffsetCompare {
-    StringOffsetCompare(const vector_downward &buf) : buf_(&buf) {}
-    bool operator() (const Offset<String> &a, const Offset<String> &b) const {
-      auto stra = reinterpret_cast<const String *>(buf_->data_at(a.o));
-      auto strb = reinterpret_cast<const String *>(buf_->data_at(b.o));
-      return strncmp(stra->c_str(), strb->c_str(),
-                     std::min(stra->size(), strb->size()) + 1) < 0;
+  // Open-addressing hash set over the offsets of strings already serialized
+  // into the buffer, keyed by string contents. Backs CreateSharedString.
+  // A flat, linearly probed table keeps interning cheap enough to leave
+  // enabled on hot serialization paths, unlike a node-based set which pays
+  // an allocation per distinct string.
+  class StringPool FLATBUFFERS_FINAL_CLASS {
+   public:
+    explicit StringPool(const vector_downward &buf)
+      : buf_(&buf), table_(kInitialSize), num_entries_(0) {}
+
+    void clear() {
+      num_entries_ = 0;
+      table_.assign(table_.size(), Offset<String>());
+    }
+
+    // Look for a previously serialized string with the same contents as the
+    // one just serialized at "off". Returns its offset if there is one, or
+    // inserts "off" and returns 0.
+    Offset<String> FindOrInsert(Offset<String> off) {
+      if (num_entries_ * 2 >= table_.size()) Grow();
+      auto str = GetString(off);
+      auto mask = table_.size() - 1;
+      auto i = HashString(str) & mask;
+      while (table_[i].o) {
+        auto entry = GetString(table_[i]);
+        if (entry->size() == str->size() &&
+            !memcmp(entry->Data(), str->Data(), str->size())) {
+          return table_[i];
+        }
+        i = (i + 1) & mask;
+      }
+      table_[i] = off;
+      num_entries_++;
+      return Offset<String>();
+    }
+
+   private:
+    static const size_t kInitialSize = 16;  // Must be a power of two.
+
+    const String *GetString(Offset<String> off) const {
+      return reinterpret_cast<const String *>(buf_->data_at(off.o));
+    }
+
+    static uint32_t HashString(const String *str) {
+      return HashBytes(str->Data(), str->size());
     }
+
+    void Grow() {
+      std::vector<Offset<String>> old;
+      table_.swap(old);
+      table_.resize(old.size() * 2);
+      auto mask = table_.size() - 1;
+      for (auto it = old.begin(); it != old.end(); ++it) {
+        if (!it->o) continue;
+        auto i = HashString(GetString(*it)) & mask;
+        while (table_[i].o) i = (i + 1) & mask;
+        table_[i] = *it;
+      }
+    }
+
     const vector_downward *buf_;
+    std::vector<Offset<String>> table_;
+    size_t num_entries_;
   };
 
   // For use with CreateSharedString. Instantiated on first use only.
-  typedef std::set<Offset<String>, StringOffsetCompare> StringOffsetMap;
-  StringOffsetMap *string_pool;
+  StringPool *string_pool;
+};
+
+/// @cond FLATBUFFERS_INTERNAL
+// Per-element-kind behaviour for VectorStreamer: how one element is pushed,
+// and how its stored bytes must be rebased when they are moved during
+// Finish(). The primary template covers inline data (scalars and structs),
+// which is position-independent; offsets specialize below.
+template<typename T> struct VectorStreamerHelper {
+  typedef typename std::conditional<std::is_scalar<T>::value,
+      Offset<Vector<T> >, Offset<Vector<const T *> > >::type VectorOffset;
+  static size_t ElemAlign() {
+    return std::is_scalar<T>::value ? sizeof(T) : AlignOf<T>();
+  }
+  static void Push(FlatBufferBuilder &fbb, const T &element) {
+    PushImpl(fbb, element, std::is_scalar<T>());
+  }
+  static void Relocate(uint8_t *, ptrdiff_t) {}
+
+ private:
+  static void PushImpl(FlatBufferBuilder &fbb, const T &element,
+                       std::true_type /*scalar*/) {
+    fbb.PushElement(element);
+  }
+  static void PushImpl(FlatBufferBuilder &fbb, const T &element,
+                       std::false_type /*struct*/) {
+    fbb.Align(AlignOf<T>());
+    fbb.PushBytes(reinterpret_cast<const uint8_t *>(&element), sizeof(T));
+  }
+};
+
+template<typename T> struct VectorStreamerHelper<Offset<T> > {
+  typedef Offset<Vector<Offset<T> > > VectorOffset;
+  static size_t ElemAlign() { return sizeof(uoffset_t); }
+  static void Push(FlatBufferBuilder &fbb, const Offset<T> &element) {
+    fbb.PushElement(element);  // Converts to its relative form (ReferTo).
+  }
+  // Stored offsets are relative to their own location, so an element that
+  // moved "delta" bytes towards the front of the buffer must grow by delta
+  // to keep referring to the same target.
+  static void Relocate(uint8_t *elem, ptrdiff_t delta) {
+    WriteScalar(elem,
+                static_cast<uoffset_t>(ReadScalar<uoffset_t>(elem) + delta));
+  }
+};
+/// @endcond
+
+/// @brief Builds a single vector straight into the buffer, one element per
+/// Push() call, without knowing the element count up front and without any
+/// intermediate array of elements: auxiliary memory is O(1) regardless of
+/// vector size. Constructing the streamer takes the place of StartVector,
+/// and no other objects may be serialized into the builder until Finish()
+/// has been called.
+/// Element types are the same as for CreateVector: scalars, structs, or
+/// Offset<T> (offsets to subobjects serialized before the streamer was
+/// created).
+template<typename T> class VectorStreamer FLATBUFFERS_FINAL_CLASS {
+ public:
+  // The order elements will be supplied in. The buffer is built
+  // back-to-front, so kReverse (last element first) lands every element in
+  // its final position as it is pushed and Finish() does no extra work.
+  // kForward (natural order) stores elements reversed and Finish() flips
+  // them in place: O(count) time, but still O(1) auxiliary memory.
+  enum FillOrder { kForward, kReverse };
+
+  typedef typename VectorStreamerHelper<T>::VectorOffset VectorOffset;
+
+  explicit VectorStreamer(FlatBufferBuilder &fbb, FillOrder order = kForward)
+      : fbb_(fbb), count_(0), order_(order) {
+    // A StartVector for a length that isn't known yet: marks the builder
+    // as nested and aligns the buffer so whole-element pushes keep it
+    // aligned. Padding for the length field is done in Finish(), once the
+    // count is known.
+    fbb_.StartVector(0, VectorStreamerHelper<T>::ElemAlign());
+  }
+
+  /// @brief Append the next element directly to the buffer: element 0
+  /// first in kForward order, the last element first in kReverse order.
+  void Push(const T &element) {
+    VectorStreamerHelper<T>::Push(fbb_, element);
+    count_++;
+  }
+
+  /// @brief The number of elements pushed so far.
+  uoffset_t Count() const { return count_; }
+
+  /// @brief Finalizes the vector and writes its length field, like
+  /// EndVector. No more elements may be pushed afterwards.
+  VectorOffset Finish() {
+    if (order_ == kForward && count_ > 1) Reverse();
+    // The length field must directly precede element 0, so its alignment
+    // padding can't simply be pushed now; instead the elements are slid
+    // down over it and the gap surfaces as dead bytes above the vector.
+    auto pad = PaddingBytes(fbb_.GetSize(), sizeof(uoffset_t));
+    if (pad) {
+      auto data = fbb_.ReserveElements(pad, 1);
+      auto bytes = count_ * sizeof(T);
+      memmove(data, data + pad, bytes);
+      memset(data + bytes, 0, pad);
+      for (uoffset_t i = 0; i < count_; i++) {
+        VectorStreamerHelper<T>::Relocate(data + i * sizeof(T),
+                                          static_cast<ptrdiff_t>(pad));
+      }
+    }
+    return VectorOffset(fbb_.EndVector(count_));
+  }
+
+ private:
+  // Forward fill lands element 0 at the highest address; flip the elements
+  // in place so index order matches address order, rebasing any stored
+  // offsets by the distance they travelled.
+  void Reverse() {
+    auto data = fbb_.GetCurrentBufferPointer();
+    for (uoffset_t i = 0, j = count_ - 1; i < j; i++, j--) {
+      auto lo = data + i * sizeof(T);
+      auto hi = data + j * sizeof(T);
+      uint8_t tmp[sizeof(T)];
+      memcpy(tmp, lo, sizeof(T));
+      memcpy(lo, hi, sizeof(T));
+      memcpy(hi, tmp, sizeof(T));
+      auto dist = static_cast<ptrdiff_t>(hi - lo);
+      VectorStreamerHelper<T>::Relocate(lo, dist);   // Moved down by dist.
+      VectorStreamerHelper<T>::Relocate(hi, -dist);  // Moved up by dist.
+    }
+  }
+
+  // You shouldn't really be copying instances of this class.
+  VectorStreamer(const VectorStreamer &);
+  VectorStreamer &operator=(const VectorStreamer &);
+
+  FlatBufferBuilder &fbb_;
+  uoffset_t count_;
+  FillOrder order_;
 };
 /// @}
 
@@ -1450,6 +2198,51 @@ inline bool BufferHasIdentifier(const void *buf, const char *identifier) {
                  identifier, FlatBufferBuilder::kFileIdentifierLength) == 0;
 }
 
+// Byte-level comparison helpers used by the Equals() functions that
+// --gen-eq-hash generates. Structs and vectors of inline data compare with a
+// single memcmp; this relies on struct padding being zeroed, which both the
+// generated struct constructors and the builder guarantee. The generated code
+// only recurses across indirections (tables, unions and vectors thereof).
+template<typename T> bool EqualsStruct(const T *lhs, const T *rhs) {
+  if (lhs == rhs) return true;
+  if (!lhs || !rhs) return false;
+  return memcmp(lhs, rhs, sizeof(T)) == 0;
+}
+
+inline bool EqualsString(const String *lhs, const String *rhs) {
+  if (lhs == rhs) return true;
+  if (!lhs || !rhs) return false;
+  return lhs->size() == rhs->size() &&
+         memcmp(lhs->Data(), rhs->Data(), lhs->size()) == 0;
+}
+
+template<typename T> bool EqualsVectorOfScalars(const Vector<T> *lhs,
+                                                const Vector<T> *rhs) {
+  if (lhs == rhs) return true;
+  if (!lhs || !rhs) return false;
+  return lhs->size() == rhs->size() &&
+         memcmp(lhs->Data(), rhs->Data(), lhs->size() * sizeof(T)) == 0;
+}
+
+template<typename T> bool EqualsVectorOfStructs(const Vector<const T *> *lhs,
+                                                const Vector<const T *> *rhs) {
+  if (lhs == rhs) return true;
+  if (!lhs || !rhs) return false;
+  return lhs->size() == rhs->size() &&
+         memcmp(lhs->Data(), rhs->Data(), lhs->size() * sizeof(T)) == 0;
+}
+
+inline bool EqualsVectorOfStrings(const Vector<Offset<String>> *lhs,
+                                  const Vector<Offset<String>> *rhs) {
+  if (lhs == rhs) return true;
+  if (!lhs || !rhs) return false;
+  if (lhs->size() != rhs->size()) return false;
+  for (uoffset_t i = 0; i < lhs->size(); i++) {
+    if (!EqualsString(lhs->Get(i), rhs->Get(i))) return false;
+  }
+  return true;
+}
+
 // Helper class to verify the integrity of a FlatBuffer
 class Verifier FLATBUFFERS_FINAL_CLASS {
  public:
@@ -1554,6 +2347,54 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
     return true;
   }
 
+  #ifndef FLATBUFFERS_CPP98_STL
+  // Runs fn(shard) for every shard in [0, num_shards) and returns once all
+  // calls have completed. Implementations typically fan the calls out to a
+  // thread pool and join; running them inline is also valid.
+  typedef std::function<void(size_t num_shards,
+                             const std::function<void(size_t shard)> &fn)>
+          parallel_for_t;
+
+  // Like VerifyVectorOfTables, but shards the elements over "parallel_for"
+  // for very large vectors whose tables are independent of each other (as
+  // root vectors usually are). Each shard verifies its range with its own
+  // child Verifier against the same buffer bounds; table counts are merged
+  // (and re-checked against max_tables) afterwards, so the overall outcome
+  // matches what the serial walk would conclude.
+  template<typename T> bool VerifyVectorOfTablesParallel(
+      const Vector<Offset<T>> *vec, const parallel_for_t &parallel_for,
+      size_t num_shards) {
+    if (!vec) return true;
+    if (num_shards < 2 || vec->size() < num_shards) {
+      return VerifyVectorOfTables(vec);
+    }
+    std::vector<Verifier> children;
+    children.reserve(num_shards);
+    for (size_t i = 0; i < num_shards; i++) {
+      children.emplace_back(buf_, static_cast<size_t>(end_ - buf_),
+                            max_depth_, max_tables_);
+    }
+    std::vector<char> results(num_shards, 0);
+    parallel_for(num_shards, [&](size_t shard) {
+      auto begin = static_cast<uoffset_t>(vec->size() * shard / num_shards);
+      auto end = static_cast<uoffset_t>(
+                   vec->size() * (shard + 1) / num_shards);
+      auto &child = children[shard];
+      bool ok = true;
+      for (auto i = begin; ok && i < end; i++) {
+        ok = vec->Get(i)->Verify(child);
+      }
+      results[shard] = static_cast<char>(ok);
+    });
+    bool ok = true;
+    for (size_t i = 0; i < num_shards; i++) {
+      ok = ok && results[i] != 0;
+      num_tables_ += children[i].num_tables_;
+    }
+    return Check(ok && num_tables_ <= max_tables_);
+  }
+  #endif  // !FLATBUFFERS_CPP98_STL
+
   template<typename T> bool VerifyBufferFromStart(const char *identifier,
                                                   const uint8_t *start) {
     if (identifier &&
@@ -1603,6 +2444,29 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
     return true;
   }
 
+  // Tables routinely share vtables, so the verifier remembers which
+  // vtables have already had their bounds walked and skips re-verifying
+  // them. Returns whether this exact vtable was verified before through
+  // another table. An unverified (or bogus) pointer simply misses the
+  // cache, so this is consulted before any bounds check.
+  bool VtableAlreadyVerified(const uint8_t *vtable) const {
+    #ifndef FLATBUFFERS_CPP98_STL
+      return verified_vtables_.count(static_cast<size_t>(vtable - buf_)) != 0;
+    #else
+      (void)vtable;
+      return false;
+    #endif
+  }
+
+  // Remember a vtable that passed verification, see above.
+  void RememberVerifiedVtable(const uint8_t *vtable) {
+    #ifndef FLATBUFFERS_CPP98_STL
+      verified_vtables_.insert(static_cast<size_t>(vtable - buf_));
+    #else
+      (void)vtable;
+    #endif
+  }
+
   #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
   // Returns the message size in bytes
   size_t GetComputedSize() const {
@@ -1620,6 +2484,10 @@ class Verifier FLATBUFFERS_FINAL_CLASS {
   uoffset_t max_depth_;
   uoffset_t num_tables_;
   uoffset_t max_tables_;
+#ifndef FLATBUFFERS_CPP98_STL
+  // Buffer positions of vtables that already passed verification.
+  std::unordered_set<size_t> verified_vtables_;
+#endif
 #ifdef FLATBUFFERS_TRACK_VERIFIER_BUFFER_SIZE
   mutable const uint8_t *upper_bound_;
 #endif
@@ -1648,6 +2516,158 @@ template<typename T> struct BufferRef : BufferRefBase {
   bool must_free;
 };
 
+#ifndef FLATBUFFERS_CPP98_STL
+
+// A shared, thread-safe handle to the memory of a buffer: all copies of a
+// SharedBuffer point at the same bytes, an atomic count tracks the copies,
+// and the release callback runs exactly once, from whichever thread drops
+// the last one. Copying, moving and destroying handles is lock-free (one
+// atomic operation each), so a received message can be handed to many
+// worker threads without a mutex or a per-thread copy. The bytes are
+// read-only through this handle; that is what makes the sharing safe.
+class SharedBuffer {
+ public:
+  // Called exactly once, with the data pointer and the userdata the
+  // buffer was constructed with, when the last handle goes away.
+  typedef void (*ReleaseFunction)(const uint8_t *buf, void *userdata);
+
+  SharedBuffer() : control_(nullptr), buf_(nullptr), size_(0) {}
+
+  // Takes ownership of "_buf", which must have come from malloc() and is
+  // released with free().
+  SharedBuffer(const uint8_t *_buf, size_t _size)
+    : control_(new ControlBlock(FreeBuffer, nullptr)),
+      buf_(_buf), size_(_size) {}
+
+  // Takes ownership of "_buf" with a custom deleter, e.g. to unref a
+  // transport's underlying slice instead of freeing (see grpc.h).
+  SharedBuffer(const uint8_t *_buf, size_t _size, ReleaseFunction _release,
+               void *_userdata)
+    : control_(new ControlBlock(_release, _userdata)),
+      buf_(_buf), size_(_size) {}
+
+  // Takes over the heap block of a DetachedBuffer (see
+  // FlatBufferBuilder::Release()), so a freshly built message can be
+  // shared between consumers without copying it.
+  explicit SharedBuffer(DetachedBuffer &&detached)
+    : control_(nullptr), buf_(detached.data()), size_(detached.size()) {
+    control_ = new ControlBlock(FreeDetached,
+                                new DetachedBuffer(std::move(detached)));
+  }
+
+  SharedBuffer(const SharedBuffer &other)
+    : control_(other.control_), buf_(other.buf_), size_(other.size_) {
+    // Incrementing doesn't publish anything, so relaxed is enough.
+    if (control_) control_->refcount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  SharedBuffer &operator=(const SharedBuffer &other) {
+    // Acquire the new reference before releasing the old one, which also
+    // makes self-assignment safe.
+    if (other.control_)
+      other.control_->refcount.fetch_add(1, std::memory_order_relaxed);
+    auto control = other.control_;
+    auto buf = other.buf_;
+    auto size = other.size_;
+    Release();
+    control_ = control;
+    buf_ = buf;
+    size_ = size;
+    return *this;
+  }
+
+  SharedBuffer(SharedBuffer &&other) FLATBUFFERS_NOEXCEPT
+    : control_(other.control_), buf_(other.buf_), size_(other.size_) {
+    other.control_ = nullptr;
+    other.buf_ = nullptr;
+    other.size_ = 0;
+  }
+
+  SharedBuffer &operator=(SharedBuffer &&other) FLATBUFFERS_NOEXCEPT {
+    if (this != &other) {
+      Release();
+      control_ = other.control_;
+      buf_ = other.buf_;
+      size_ = other.size_;
+      other.control_ = nullptr;
+      other.buf_ = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  ~SharedBuffer() { Release(); }
+
+  const uint8_t *data() const { return buf_; }
+  size_t size() const { return size_; }
+
+  template<typename T> const T *GetRoot() const {
+    return flatbuffers::GetRoot<T>(buf_);
+  }
+
+  // The number of handles currently sharing the buffer. Exact only when
+  // no other thread is copying or releasing; meant for tests and
+  // diagnostics, not for lifetime decisions.
+  uint32_t use_count() const {
+    return control_ ? control_->refcount.load(std::memory_order_relaxed) : 0;
+  }
+
+  // Drops this handle's reference early, leaving it empty.
+  void Release() {
+    if (!control_) return;
+    // The releasing thread must see all accesses the other owners made
+    // before dropping theirs, hence acquire/release on the decrement.
+    if (control_->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (control_->release) control_->release(buf_, control_->userdata);
+      delete control_;
+    }
+    control_ = nullptr;
+    buf_ = nullptr;
+    size_ = 0;
+  }
+
+ private:
+  struct ControlBlock {
+    ControlBlock(ReleaseFunction _release, void *_userdata)
+      : refcount(1), release(_release), userdata(_userdata) {}
+    std::atomic<uint32_t> refcount;
+    ReleaseFunction release;
+    void *userdata;
+  };
+
+  static void FreeBuffer(const uint8_t *buf, void *) {
+    free(const_cast<uint8_t *>(buf));
+  }
+
+  static void FreeDetached(const uint8_t *, void *userdata) {
+    delete static_cast<DetachedBuffer *>(userdata);
+  }
+
+  ControlBlock *control_;
+  const uint8_t *buf_;
+  size_t size_;
+};
+
+// A BufferRef that shares ownership of its buffer through a SharedBuffer.
+// Unlike BufferRef it is copyable: every copy keeps the buffer alive, so
+// each worker thread can hold its own while responses are in flight, and
+// the buffer is freed exactly once, by whichever copy is destroyed last.
+// must_free stays false since the handle owns the memory.
+template<typename T> struct SharedBufferRef : public BufferRef<T> {
+  SharedBufferRef() {}
+  explicit SharedBufferRef(const SharedBuffer &buffer) : buffer_(buffer) {
+    this->buf = const_cast<uint8_t *>(buffer_.data());
+    this->len = static_cast<uoffset_t>(buffer_.size());
+  }
+
+  const SharedBuffer &buffer() const { return buffer_; }
+
+ private:
+  SharedBuffer buffer_;
+};
+
+#endif  // FLATBUFFERS_CPP98_STL
+
 // "structs" are flat structures that do not have an offset table, thus
 // always have all members present and do not support forwards/backwards
 // compatible extensions.
@@ -1744,11 +2764,18 @@ class Table {
     // Check the vtable offset.
     if (!verifier.Verify<soffset_t>(data_)) return false;
     auto vtable = GetVTable();
+    if (!verifier.VerifyComplexity()) return false;
+    // Many tables share a vtable; if this one already passed, don't walk
+    // it again.
+    if (verifier.VtableAlreadyVerified(vtable)) return true;
     // Check the vtable size field, then check vtable fits in its entirety.
-    return verifier.VerifyComplexity() &&
-           verifier.Verify<voffset_t>(vtable) &&
-           (ReadScalar<voffset_t>(vtable) & (sizeof(voffset_t) - 1)) == 0 &&
-           verifier.Verify(vtable, ReadScalar<voffset_t>(vtable));
+    if (!(verifier.Verify<voffset_t>(vtable) &&
+          (ReadScalar<voffset_t>(vtable) & (sizeof(voffset_t) - 1)) == 0 &&
+          verifier.Verify(vtable, ReadScalar<voffset_t>(vtable)))) {
+      return false;
+    }
+    verifier.RememberVerifiedVtable(vtable);
+    return true;
   }
 
   // Verify a particular field.
@@ -1769,6 +2796,23 @@ class Table {
            verifier.Verify<T>(data_ + field_offset);
   }
 
+  // For schema-specialized verifiers (--gen-fast-verifiers): accumulates
+  // the furthest byte any present field reaches past the table start. Each
+  // field only needs data_ + offset + size to lie within the buffer, and
+  // the largest such extent dominates the rest, so a table can bound all
+  // of its inline fields with a single range comparison.
+  uoffset_t FieldExtent(voffset_t field, size_t size,
+                        uoffset_t extent) const {
+    auto field_offset = GetOptionalFieldOffset(field);
+    auto end = static_cast<uoffset_t>(field_offset + size);
+    return field_offset && end > extent ? end : extent;
+  }
+
+  // The single range comparison for the extent accumulated above.
+  bool VerifyFieldsExtent(const Verifier &verifier, uoffset_t extent) const {
+    return !extent || verifier.Verify(data_, extent);
+  }
+
  private:
   // private constructor & copy constructor: you obtain instances of this
   // class by pointing to existing data only
@@ -1816,12 +2860,139 @@ inline const uint8_t *GetBufferStartFromRootPointer(const void *root) {
   return nullptr;
 }
 
+// Reads one scalar field across a whole vector of tables into a dense
+// output array, e.g. to feed columnar analytics from row-oriented buffers.
+// The field is identified by its vtable offset (the VT_* constants in
+// generated code) and read as its storage type S; tables that don't store
+// the field produce "default_value". The vtable lookup is hoisted by
+// caching the previously seen vtable, which homogeneous vectors share, and
+// upcoming tables are prefetched. This is the implementation behind the
+// Extract* accessors flatc generates with --gen-columnar.
+template<typename T, typename S>
+void ExtractScalarColumn(const Vector<Offset<T>> *vec, voffset_t field,
+                         S default_value, S *dst) {
+  static const uoffset_t kPrefetchDistance = 8;
+  if (!vec) return;
+  const uint8_t *last_vtable = nullptr;
+  voffset_t field_offset = 0;
+  for (uoffset_t i = 0; i < vec->size(); i++) {
+    if (i + kPrefetchDistance < vec->size()) {
+      FLATBUFFERS_PREFETCH(vec->Get(i + kPrefetchDistance));
+    }
+    auto table = reinterpret_cast<const Table *>(vec->Get(i));
+    auto vtable = table->GetVTable();
+    if (vtable != last_vtable) {
+      last_vtable = vtable;
+      auto vtsize = ReadScalar<voffset_t>(vtable);
+      field_offset = field < vtsize ? ReadScalar<voffset_t>(vtable + field)
+                                    : 0;
+    }
+    dst[i] = field_offset
+        ? ReadScalar<S>(reinterpret_cast<const uint8_t *>(table) +
+                        field_offset)
+        : default_value;
+  }
+}
+
 // Base class for native objects (FlatBuffer data de-serialized into native
 // C++ data structures).
 // Contains no functionality, purely documentative.
 struct NativeTable {
 };
 
+// An arena for object API (see --gen-object-api) instances. UnPack()'ing a
+// message allocates one native object per table; when many messages are
+// unpacked (and discarded) in sequence, allocating those objects from an
+// arena turns each allocation into a pointer bump and releases them
+// wholesale. The generated UnPack(ObjectArena &, ...) overloads allocate
+// their result here. Objects made from the arena still have their
+// destructors run (they own std::string / std::vector members and possibly
+// heap-allocated sub-objects), but only when the arena is destroyed or
+// Reset().
+class ObjectArena {
+ public:
+  explicit ObjectArena(size_t initial_block_size = 4096)
+    : block_size_(initial_block_size), cur_(nullptr), space_(0),
+      owned_(nullptr) {}
+
+  ~ObjectArena() { Reset(); }
+
+  // Default-construct a T inside the arena. The arena owns the object:
+  // its destructor runs when the arena is destroyed or Reset().
+  template<typename T> T *Make() {
+    auto obj = new (Allocate(sizeof(T), AlignOf<T>())) T();
+    auto owned = reinterpret_cast<Owned *>(
+        Allocate(sizeof(Owned), AlignOf<Owned>()));
+    owned->destroy = DestroyObject<T>;
+    owned->obj = obj;
+    owned->next = owned_;
+    owned_ = owned;
+    return obj;
+  }
+
+  // Destroy all objects made from this arena (newest first) and release
+  // its memory. The arena can be re-used afterwards.
+  void Reset() {
+    for (auto owned = owned_; owned; owned = owned->next) {
+      owned->destroy(owned->obj);
+    }
+    owned_ = nullptr;
+    for (auto it = blocks_.begin(); it != blocks_.end(); ++it) {
+      delete[] *it;
+    }
+    blocks_.clear();
+    cur_ = nullptr;
+    space_ = 0;
+  }
+
+ private:
+  // Type-erased destructor call for an arena-owned object.
+  struct Owned {
+    void (*destroy)(void *obj);
+    void *obj;
+    Owned *next;
+  };
+
+  template<typename T> static void DestroyObject(void *obj) {
+    static_cast<T *>(obj)->~T();
+  }
+
+  void *Allocate(size_t size, size_t align) {
+    auto p = reinterpret_cast<uintptr_t>(cur_);
+    auto aligned = (p + align - 1) & ~static_cast<uintptr_t>(align - 1);
+    auto needed = (aligned - p) + size;
+    if (!cur_ || needed > space_) {
+      // Start a new block. operator new[] aligns for any fundamental type,
+      // so only the in-block offset needs adjusting above.
+      auto alloc_size = (std::max)(block_size_,
+                                   size + FLATBUFFERS_MAX_ALIGNMENT);
+      cur_ = new uint8_t[alloc_size];
+      blocks_.push_back(cur_);
+      space_ = alloc_size;
+      // Like vector_downward, grow blocks geometrically so that arenas
+      // that turn out to be large don't allocate often.
+      block_size_ *= 2;
+      p = reinterpret_cast<uintptr_t>(cur_);
+      aligned = (p + align - 1) & ~static_cast<uintptr_t>(align - 1);
+      needed = (aligned - p) + size;
+      assert(needed <= space_);
+    }
+    cur_ = reinterpret_cast<uint8_t *>(aligned) + size;
+    space_ -= needed;
+    return reinterpret_cast<uint8_t *>(aligned);
+  }
+
+  // Not copyable: the arena uniquely owns its objects.
+  ObjectArena(const ObjectArena &);
+  ObjectArena &operator=(const ObjectArena &);
+
+  size_t block_size_;
+  std::vector<uint8_t *> blocks_;
+  uint8_t *cur_;
+  size_t space_;
+  Owned *owned_;
+};
+
 /// @brief Function types to be used with resolving hashes into objects and
 /// back again. The resolver gets a pointer to a field inside an object API
 /// object that is of the type specified in the schema using the attribute
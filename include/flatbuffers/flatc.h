@@ -46,6 +46,11 @@ class FlatCompiler {
     flatbuffers::IDLOptions::Language lang;
     const char *generator_help;
     MakeRuleFn make_rule;
+    // True for generators that share a generate function and dispatch on
+    // parser.opts.lang (Java and C# both go through GenerateGeneral).
+    // --parallel keeps all such generators on one worker, since they read
+    // mutable Parser state; everything else ignores opts.lang entirely.
+    bool lang_dispatch;
   };
 
   typedef void (*WarnFn)(const FlatCompiler *flatc,
@@ -82,6 +87,10 @@ class FlatCompiler {
                  const std::string &contents,
                  std::vector<const char *> &include_directories) const;
 
+  void StreamJsonLines(flatbuffers::Parser &parser,
+                       const std::string &filename,
+                       const std::string &output_path) const;
+
   void Warn(const std::string &warn, bool show_exe_name = true) const;
 
   void Error(const std::string &err, bool usage = true,
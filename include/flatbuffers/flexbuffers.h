@@ -197,6 +197,12 @@ class Object {
   Object(const uint8_t *data, uint8_t byte_width)
     : data_(data), byte_width_(byte_width) {}
 
+  // The start of this object's data inside the buffer, and the byte width
+  // its elements (or size prefix) are stored in. Allows bulk access to the
+  // contents of blobs and (typed) vectors.
+  const uint8_t *data() const { return data_; }
+  uint8_t byte_width() const { return byte_width_; }
+
  protected:
   const uint8_t *data_;
   uint8_t byte_width_;
@@ -253,6 +259,47 @@ class Vector : public Sized {
   bool IsTheEmptyVector() const { return data_ == EmptyVector().data_; }
 };
 
+// Runs "..." once with "elems" pointing at a typed vector's contiguous
+// elements as their native type, dispatching a single time on the element
+// type and width. The per-element Reference path re-dispatches on every
+// access; a loop expanded here is one tight scan over raw bytes that
+// compilers auto-vectorize (EndianScalar is a no-op on little-endian
+// hosts, where the wire format can be loaded directly).
+#define FLATBUFFERS_TYPED_VECTOR_CASE(W, U, ...) \
+    case W: { \
+      auto elems = reinterpret_cast<const U *>(data_); \
+      (void)elems; \
+      __VA_ARGS__ \
+      break; \
+    }
+#define FLATBUFFERS_TYPED_VECTOR_DISPATCH(...) \
+  switch (type_) { \
+    case TYPE_INT: \
+      switch (byte_width_) { \
+        FLATBUFFERS_TYPED_VECTOR_CASE(1, int8_t, __VA_ARGS__) \
+        FLATBUFFERS_TYPED_VECTOR_CASE(2, int16_t, __VA_ARGS__) \
+        FLATBUFFERS_TYPED_VECTOR_CASE(4, int32_t, __VA_ARGS__) \
+        FLATBUFFERS_TYPED_VECTOR_CASE(8, int64_t, __VA_ARGS__) \
+      } \
+      break; \
+    case TYPE_UINT: \
+      switch (byte_width_) { \
+        FLATBUFFERS_TYPED_VECTOR_CASE(1, uint8_t, __VA_ARGS__) \
+        FLATBUFFERS_TYPED_VECTOR_CASE(2, uint16_t, __VA_ARGS__) \
+        FLATBUFFERS_TYPED_VECTOR_CASE(4, uint32_t, __VA_ARGS__) \
+        FLATBUFFERS_TYPED_VECTOR_CASE(8, uint64_t, __VA_ARGS__) \
+      } \
+      break; \
+    case TYPE_FLOAT: \
+      switch (byte_width_) { \
+        FLATBUFFERS_TYPED_VECTOR_CASE(4, float, __VA_ARGS__) \
+        FLATBUFFERS_TYPED_VECTOR_CASE(8, double, __VA_ARGS__) \
+      } \
+      break; \
+    default: \
+      break; \
+  }
+
 class TypedVector : public Sized {
  public:
   TypedVector(const uint8_t *data, uint8_t byte_width, Type element_type)
@@ -270,12 +317,64 @@ class TypedVector : public Sized {
 
   Type ElementType() { return type_; }
 
+  // Bulk kernels over the whole vector, for aggregating large metric /
+  // measurement vectors. T is the caller's accumulator / destination type
+  // (e.g. int64_t, uint64_t or double); elements of key or string typed
+  // vectors are left untouched. For custom kernels, run over the raw
+  // element span directly via data(), byte_width() and ElementType().
+
+  // Sum of all elements, accumulated (and element-wise converted) in T.
+  template<typename T> T Sum() const {
+    T acc = 0;
+    auto len = size();
+    FLATBUFFERS_TYPED_VECTOR_DISPATCH(
+      for (size_t i = 0; i < len; i++)
+        acc += static_cast<T>(flatbuffers::EndianScalar(elems[i]));
+    )
+    return acc;
+  }
+
+  // Smallest and largest element, compared in the element's native type.
+  // Returns false (leaving the outputs untouched) if the vector is empty
+  // or its elements are not numeric.
+  template<typename T> bool MinMax(T *out_min, T *out_max) const {
+    auto len = size();
+    if (!len) return false;
+    bool numeric = false;
+    FLATBUFFERS_TYPED_VECTOR_DISPATCH(
+      auto min_elem = flatbuffers::EndianScalar(elems[0]);
+      auto max_elem = min_elem;
+      for (size_t i = 1; i < len; i++) {
+        auto e = flatbuffers::EndianScalar(elems[i]);
+        if (e < min_elem) min_elem = e;
+        if (e > max_elem) max_elem = e;
+      }
+      *out_min = static_cast<T>(min_elem);
+      *out_max = static_cast<T>(max_elem);
+      numeric = true;
+    )
+    return numeric;
+  }
+
+  // Converts every element into "dst", which must have room for size()
+  // elements.
+  template<typename T> void CopyTo(T *dst) const {
+    auto len = size();
+    FLATBUFFERS_TYPED_VECTOR_DISPATCH(
+      for (size_t i = 0; i < len; i++)
+        dst[i] = static_cast<T>(flatbuffers::EndianScalar(elems[i]));
+    )
+  }
+
  private:
   Type type_;
 
   friend Map;
 };
 
+#undef FLATBUFFERS_TYPED_VECTOR_DISPATCH
+#undef FLATBUFFERS_TYPED_VECTOR_CASE
+
 class FixedTypedVector : public Object {
  public:
   FixedTypedVector(const uint8_t *data, uint8_t byte_width, Type element_type,
@@ -903,13 +1002,10 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     // We want to sort 2 array elements at a time.
     struct TwoValue { Value key; Value val; };
     // TODO(wvo): strict aliasing?
-    // TODO(wvo): allow the caller to indicate the data is already sorted
-    // for maximum efficiency? With an assert to check sortedness to make sure
-    // we're not breaking binary search.
-    // Or, we can track if the map is sorted as keys are added which would be
-    // be quite cheap (cheaper than checking it here), so we can skip this
-    // step automatically when appliccable, and encourage people to write in
-    // sorted fashion.
+    // Callers that push their keys in sorted order already can use
+    // EndMapPresorted() below and skip this sort entirely, and callers that
+    // write the same key set many times can share one serialized key vector
+    // through CreateKeySet() / EndMap(start, keyset).
     // std::sort is typically already a lot faster on sorted data though.
     auto dict = reinterpret_cast<TwoValue *>(stack_.data() + start);
     std::sort(dict, dict + len,
@@ -935,6 +1031,35 @@ class Builder FLATBUFFERS_FINAL_CLASS {
     return static_cast<size_t>(vec.u_);
   }
 
+  // As EndMap(), but for callers that pushed their keys in sorted order
+  // (byte-wise strcmp, same as the comparator above) already: skips the
+  // sort. Sortedness is checked with asserts in debug builds, since an
+  // unsorted map would silently break binary search lookups.
+  size_t EndMapPresorted(size_t start) {
+    auto len = stack_.size() - start;
+    assert(!(len & 1));
+    len /= 2;
+    #ifndef NDEBUG
+      for (auto key = start; key < stack_.size(); key += 2) {
+        assert(stack_[key].type_ == TYPE_KEY);
+        if (key + 2 < stack_.size()) {
+          auto as = reinterpret_cast<const char *>(buf_.data() +
+                                                   stack_[key].u_);
+          auto bs = reinterpret_cast<const char *>(buf_.data() +
+                                                   stack_[key + 2].u_);
+          // If this assertion hits, your keys are not in strcmp order (or
+          // not unique): use EndMap() instead.
+          assert(strcmp(as, bs) < 0);
+        }
+      }
+    #endif
+    auto keys = CreateVector(start, len, 2, true, false);
+    auto vec = CreateVector(start + 1, len, 2, false, false, &keys);
+    stack_.resize(start);
+    stack_.push_back(vec);
+    return static_cast<size_t>(vec.u_);
+  }
+
   template<typename F> size_t Vector(F f) {
     auto start = StartVector();
     f();
@@ -1303,6 +1428,54 @@ class Builder FLATBUFFERS_FINAL_CLASS {
                        bit_width);
   }
 
+ public:
+  // A fixed key set whose sorted key vector has been serialized once, for
+  // writers that emit maps with the same keys many times (e.g. telemetry
+  // records): subsequent maps reference the shared key vector and cost
+  // only their value writes. Only valid for the builder that created it,
+  // until that builder is Clear()ed.
+  class KeySet {
+   public:
+    KeySet() : len_(0) {}
+
+   private:
+    friend class Builder;
+    Value keys_;
+    size_t len_;
+  };
+
+  // Serialize the (unique) keys in sorted order and return a KeySet
+  // referencing the resulting key vector. Must be called outside of any
+  // open map or vector.
+  KeySet CreateKeySet(const char *const *keys, size_t len) {
+    std::vector<const char *> sorted(keys, keys + len);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const char *a, const char *b) { return strcmp(a, b) < 0; });
+    auto start = stack_.size();
+    for (size_t i = 0; i < len; i++) {
+      // If this assertion hits, you've passed the same key twice.
+      assert(i == 0 || strcmp(sorted[i - 1], sorted[i]) < 0);
+      Key(sorted[i]);
+    }
+    KeySet keyset;
+    keyset.keys_ = CreateVector(start, len, 1, true, false);
+    keyset.len_ = len;
+    stack_.resize(start);
+    return keyset;
+  }
+
+  // Close a map started with StartMap() whose values (and only values, no
+  // keys) were pushed in the key set's sorted key order.
+  size_t EndMap(size_t start, const KeySet &keyset) {
+    assert(stack_.size() - start == keyset.len_);
+    auto vec = CreateVector(start, keyset.len_, 1, false, false,
+                            &keyset.keys_);
+    stack_.resize(start);
+    stack_.push_back(vec);
+    return static_cast<size_t>(vec.u_);
+  }
+
+ private:
   // You shouldn't really be copying instances of this class.
   Builder(const Builder &);
   Builder &operator=(const Builder &);
@@ -19,9 +19,113 @@
 
 // Helper functionality to glue FlatBuffers and GRPC.
 
+#include "flatbuffers/flatbuffers.h"
 #include "grpc++/support/byte_buffer.h"
 #include "grpc/byte_buffer_reader.h"
 
+namespace flatbuffers {
+
+// A BufferRef whose underlying storage is a gpr_slice, so a received
+// message can point straight into gRPC's network buffers instead of a
+// malloc'd copy. Use this as the request/response type in place of
+// BufferRef to get zero-copy receives; the slice (and thus the buffer)
+// stays alive for as long as this object does.
+template<typename T> struct SliceBufferRef : public BufferRef<T> {
+  SliceBufferRef() : have_slice_(false) {}
+  ~SliceBufferRef() { reset(); }
+
+  void reset() {
+    if (have_slice_) {
+      gpr_slice_unref(slice_);
+      have_slice_ = false;
+    }
+  }
+
+  // Take (shared) ownership of "slice" and point this ref at its contents.
+  void adopt(gpr_slice slice) {
+    reset();
+    slice_ = slice;
+    have_slice_ = true;
+    this->buf = GPR_SLICE_START_PTR(slice_);
+    this->len = static_cast<uoffset_t>(GPR_SLICE_LENGTH(slice_));
+    this->must_free = false;
+  }
+
+  // Hand the received message to multiple worker threads: the returned
+  // ref (and any copies of it) holds its own reference to the slice, so
+  // the buffer outlives this object and is unref'd exactly once, when the
+  // last copy goes away.
+  SharedBufferRef<T> share() const {
+    assert(have_slice_);
+    auto slice = new gpr_slice(gpr_slice_ref(slice_));
+    return SharedBufferRef<T>(SharedBuffer(
+        this->buf, this->len, UnrefSlice, slice));
+  }
+
+ private:
+  static void UnrefSlice(const uint8_t *, void *userdata) {
+    auto slice = static_cast<gpr_slice *>(userdata);
+    gpr_slice_unref(*slice);
+    delete slice;
+  }
+
+  // The slice reference can't be shared between instances.
+  SliceBufferRef(const SliceBufferRef &);
+  SliceBufferRef &operator=(const SliceBufferRef &);
+
+  gpr_slice slice_;
+  bool have_slice_;
+};
+
+}  // namespace flatbuffers
+
+namespace grpc {
+template <class W> class WriterInterface;
+}  // namespace grpc
+
+namespace flatbuffers {
+
+// Writer side of a streaming RPC, holding a FlatBufferBuilder that is
+// reused for every message on the stream, so high-rate streams don't pay a
+// builder allocation per message. Construct each message with builder(),
+// then Send() its root: the message is finished, written through the
+// zero-copy slice path of SerializationTraits below, and the builder is
+// reset in place, keeping its backing storage for the next message. This
+// is safe because the synchronous Write() only returns once the data has
+// been handed off to the transport. Works with any WriterInterface:
+// ServerWriter and ServerReaderWriter on the server, ClientWriter and
+// ClientReaderWriter on the client. The generated service classes contain
+// a <Method>Writer typedef of this for each streaming method.
+template<typename T> class GrpcStreamWriter {
+ public:
+  explicit GrpcStreamWriter(::grpc::WriterInterface<BufferRef<T>> *writer)
+    : writer_(writer) {}
+
+  // The builder to construct the next message in. Contents are only valid
+  // until the next Send().
+  FlatBufferBuilder &builder() { return fbb_; }
+
+  // Finish the message rooted at "root" and write it to the stream,
+  // then recycle the builder's memory for the next message.
+  bool Send(Offset<T> root) {
+    fbb_.Finish(root);
+    BufferRef<T> ref(fbb_.GetBufferPointer(), fbb_.GetSize());
+    auto ok = writer_->Write(ref);
+    fbb_.Clear();
+    return ok;
+  }
+
+ private:
+  // Not copyable: the builder state belongs to one stream.
+  GrpcStreamWriter(const GrpcStreamWriter &);
+  GrpcStreamWriter &operator=(const GrpcStreamWriter &);
+
+  ::grpc::WriterInterface<BufferRef<T>> *writer_;
+  FlatBufferBuilder fbb_;
+};
+
+}  // namespace flatbuffers
+
 namespace grpc {
 
 template <class T>
@@ -33,9 +137,12 @@ class SerializationTraits<T, typename std::enable_if<std::is_base_of<
   static grpc::Status Serialize(const T& msg,
                                 grpc_byte_buffer **buffer,
                                 bool *own_buffer) {
-    // TODO(wvo): make this work without copying.
-    auto slice = gpr_slice_from_copied_buffer(
-                   reinterpret_cast<const char *>(msg.buf), msg.len);
+    // Wrap the serialized data in a slice referencing it in place, rather
+    // than copying the whole buffer. The no-op destroy function means the
+    // caller keeps ownership: "msg"'s underlying buffer must stay alive
+    // until the call completes, which holds for both the sync API and the
+    // async API as long as the request object outlives the tag.
+    auto slice = gpr_slice_new(msg.buf, msg.len, DestroyNothing);
     *buffer = grpc_raw_byte_buffer_create(&slice, 1);
     *own_buffer = true;
     return grpc::Status();
@@ -44,7 +151,17 @@ class SerializationTraits<T, typename std::enable_if<std::is_base_of<
   // There is no de-serialization step in FlatBuffers, so we just receive
   // the data from GRPC.
   static grpc::Status Deserialize(grpc_byte_buffer *buffer, T *msg) {
-    // TODO(wvo): make this more efficient / zero copy when possible.
+    // Fast path: the message arrived as one contiguous slice, so the
+    // message can reference it in place (zero-copy if T is a
+    // SliceBufferRef, a single memcpy with no reader otherwise).
+    if (buffer->type == GRPC_BB_RAW &&
+        buffer->data.raw.slice_buffer.count == 1) {
+      AssignSlice(msg, gpr_slice_ref(buffer->data.raw.slice_buffer.slices[0]));
+      grpc_byte_buffer_destroy(buffer);
+      return grpc::Status();
+    }
+    // The message is fragmented across slices: gather it into one
+    // allocation.
     auto len = grpc_byte_buffer_length(buffer);
     msg->buf = reinterpret_cast<uint8_t *>(malloc(len));
     msg->len = static_cast<flatbuffers::uoffset_t>(len);
@@ -63,6 +180,27 @@ class SerializationTraits<T, typename std::enable_if<std::is_base_of<
     grpc_byte_buffer_destroy(buffer);
     return grpc::Status();
   }
+
+ private:
+  static void DestroyNothing(void * /* unused */) {}
+
+  // SliceBufferRefs keep the network slice alive and reference it in place.
+  template <class R>
+  static void AssignSlice(flatbuffers::SliceBufferRef<R> *msg,
+                          gpr_slice slice) {
+    msg->adopt(slice);
+  }
+
+  // Plain BufferRefs have nowhere to hold a slice reference: copy.
+  template <class R>
+  static void AssignSlice(flatbuffers::BufferRef<R> *msg, gpr_slice slice) {
+    auto len = GPR_SLICE_LENGTH(slice);
+    msg->buf = reinterpret_cast<uint8_t *>(malloc(len));
+    msg->len = static_cast<flatbuffers::uoffset_t>(len);
+    msg->must_free = true;
+    memcpy(msg->buf, GPR_SLICE_START_PTR(slice), len);
+    gpr_slice_unref(slice);
+  }
 };
 
 }  // namespace grpc;
@@ -22,6 +22,17 @@
 
 #include "flatbuffers/flatbuffers.h"
 
+// CRC32C has dedicated instructions on SSE4.2 x86 and on ARMv8 with the CRC
+// extension; either consumes 8 input bytes per instruction instead of FNV's
+// serial byte loop.
+#if defined(__SSE4_2__)
+  #include <nmmintrin.h>
+  #define FLATBUFFERS_CRC32C_HARDWARE 1
+#elif defined(__ARM_FEATURE_CRC32)
+  #include <arm_acle.h>
+  #define FLATBUFFERS_CRC32C_HARDWARE 1
+#endif
+
 namespace flatbuffers {
 
 template <typename T>
@@ -62,6 +73,175 @@ T HashFnv1a(const char *input) {
   return hash;
 }
 
+// Incremental FNV-1a over arbitrary bytes, for callers that hash content in
+// pieces. Pass FnvTraits<T>::kOffsetBasis as the initial hash value and feed
+// the result of each call into the next. The HashOf() functions generated by
+// --gen-eq-hash are built on these, hashing buffer content without unpacking.
+template <typename T>
+T HashBytesFnv1a(const void *data, size_t length, T hash) {
+  auto bytes = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < length; i++) {
+    hash ^= bytes[i];
+    hash *= FnvTraits<T>::kFnvPrime;
+  }
+  return hash;
+}
+
+template <typename T, typename U>
+T HashScalarFnv1a(U value, T hash) {
+  return HashBytesFnv1a(&value, sizeof(U), hash);
+}
+
+// A null struct hashes as absent, a present one as its raw bytes (struct
+// padding is zeroed by construction, so this is deterministic).
+template <typename T, typename U>
+T HashStructFnv1a(const U *s, T hash) {
+  hash = HashScalarFnv1a(static_cast<uint8_t>(s ? 1 : 0), hash);
+  return s ? HashBytesFnv1a(s, sizeof(U), hash) : hash;
+}
+
+// Strings and vectors mix their length first, so a null field, an empty one
+// and adjacent fields all hash distinctly.
+template <typename T>
+T HashStringFnv1a(const String *str, T hash) {
+  uoffset_t length = str ? str->size() : 0;
+  hash = HashScalarFnv1a(length, hash);
+  return str ? HashBytesFnv1a(str->Data(), length, hash) : hash;
+}
+
+template <typename T, typename U>
+T HashVectorOfScalarsFnv1a(const Vector<U> *vec, T hash) {
+  uoffset_t length = vec ? vec->size() : 0;
+  hash = HashScalarFnv1a(length, hash);
+  return vec ? HashBytesFnv1a(vec->Data(), length * sizeof(U), hash) : hash;
+}
+
+template <typename T, typename U>
+T HashVectorOfStructsFnv1a(const Vector<const U *> *vec, T hash) {
+  uoffset_t length = vec ? vec->size() : 0;
+  hash = HashScalarFnv1a(length, hash);
+  return vec ? HashBytesFnv1a(vec->Data(), length * sizeof(U), hash) : hash;
+}
+
+template <typename T>
+T HashVectorOfStringsFnv1a(const Vector<Offset<String>> *vec, T hash) {
+  uoffset_t length = vec ? vec->size() : 0;
+  hash = HashScalarFnv1a(length, hash);
+  for (uoffset_t i = 0; i < length; i++) {
+    hash = HashStringFnv1a(vec->Get(i), hash);
+  }
+  return hash;
+}
+
+// CRC32C (Castagnoli) of the string's bytes, with the standard inverted
+// initial value and final xor. Uses the dedicated CPU instructions where the
+// build enables them (see FLATBUFFERS_CRC32C_HARDWARE above) and a portable
+// bitwise fallback elsewhere; both produce identical values.
+inline uint32_t HashCrc32c(const char *input) {
+  auto bytes = reinterpret_cast<const uint8_t *>(input);
+  auto len = strlen(input);
+  uint32_t crc = 0xFFFFFFFFU;
+  #ifdef FLATBUFFERS_CRC32C_HARDWARE
+    while (len >= 8) {
+      // Both hardware paths are little-endian platforms, so the 8 input
+      // bytes can be loaded as one word.
+      uint64_t word;
+      memcpy(&word, bytes, sizeof(word));
+      #if defined(__SSE4_2__)
+        crc = static_cast<uint32_t>(_mm_crc32_u64(crc, word));
+      #else
+        crc = __crc32cd(crc, word);
+      #endif
+      bytes += 8;
+      len -= 8;
+    }
+    while (len--) {
+      #if defined(__SSE4_2__)
+        crc = _mm_crc32_u8(crc, *bytes++);
+      #else
+        crc = __crc32cb(crc, *bytes++);
+      #endif
+    }
+  #else
+    while (len--) {
+      crc ^= *bytes++;
+      for (int i = 0; i < 8; i++) {
+        crc = (crc >> 1) ^ (0x82F63B78U & (0U - (crc & 1)));
+      }
+    }
+  #endif
+  return crc ^ 0xFFFFFFFFU;
+}
+
+// xxHash64 (seed 0): wide multiply/rotate mixing over four parallel lanes
+// consuming 32 bytes per round, which runs close to memory bandwidth on
+// long keys while still being cheap on short ones.
+inline uint64_t XxHash64Rotl(uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t XxHash64Round(uint64_t acc, uint64_t input) {
+  static const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+  static const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+  acc += input * kPrime2;
+  acc = XxHash64Rotl(acc, 31);
+  return acc * kPrime1;
+}
+
+inline uint64_t HashXxHash64(const char *input) {
+  static const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+  static const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+  static const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+  static const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+  static const uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+  auto p = reinterpret_cast<const uint8_t *>(input);
+  auto len = strlen(input);
+  auto end = p + len;
+  uint64_t h;
+  if (len >= 32) {
+    auto v1 = kPrime1 + kPrime2;
+    auto v2 = kPrime2;
+    uint64_t v3 = 0;
+    auto v4 = 0 - kPrime1;
+    do {
+      v1 = XxHash64Round(v1, ReadScalar<uint64_t>(p));
+      v2 = XxHash64Round(v2, ReadScalar<uint64_t>(p + 8));
+      v3 = XxHash64Round(v3, ReadScalar<uint64_t>(p + 16));
+      v4 = XxHash64Round(v4, ReadScalar<uint64_t>(p + 24));
+      p += 32;
+    } while (p + 32 <= end);
+    h = XxHash64Rotl(v1, 1) + XxHash64Rotl(v2, 7) +
+        XxHash64Rotl(v3, 12) + XxHash64Rotl(v4, 18);
+    h = (h ^ XxHash64Round(0, v1)) * kPrime1 + kPrime4;
+    h = (h ^ XxHash64Round(0, v2)) * kPrime1 + kPrime4;
+    h = (h ^ XxHash64Round(0, v3)) * kPrime1 + kPrime4;
+    h = (h ^ XxHash64Round(0, v4)) * kPrime1 + kPrime4;
+  } else {
+    h = kPrime5;
+  }
+  h += len;
+  while (p + 8 <= end) {
+    h ^= XxHash64Round(0, ReadScalar<uint64_t>(p));
+    h = XxHash64Rotl(h, 27) * kPrime1 + kPrime4;
+    p += 8;
+  }
+  if (p + 4 <= end) {
+    h ^= ReadScalar<uint32_t>(p) * kPrime1;
+    h = XxHash64Rotl(h, 23) * kPrime2 + kPrime3;
+    p += 4;
+  }
+  while (p < end) {
+    h ^= *p++ * kPrime5;
+    h = XxHash64Rotl(h, 11) * kPrime1;
+  }
+  h ^= h >> 33;
+  h *= kPrime2;
+  h ^= h >> 29;
+  h *= kPrime3;
+  h ^= h >> 32;
+  return h;
+}
+
 template <typename T>
 struct NamedHashFunction {
   const char *name;
@@ -71,13 +251,15 @@ struct NamedHashFunction {
 };
 
 const NamedHashFunction<uint32_t> kHashFunctions32[] = {
-  { "fnv1_32",  HashFnv1<uint32_t> },
-  { "fnv1a_32", HashFnv1a<uint32_t> },
+  { "fnv1_32",   HashFnv1<uint32_t> },
+  { "fnv1a_32",  HashFnv1a<uint32_t> },
+  { "crc32c_32", HashCrc32c },
 };
 
 const NamedHashFunction<uint64_t> kHashFunctions64[] = {
-  { "fnv1_64",  HashFnv1<uint64_t> },
-  { "fnv1a_64", HashFnv1a<uint64_t> },
+  { "fnv1_64",   HashFnv1<uint64_t> },
+  { "fnv1a_64",  HashFnv1a<uint64_t> },
+  { "xxhash_64", HashXxHash64 },
 };
 
 inline NamedHashFunction<uint32_t>::HashFunction FindHashFunction32(
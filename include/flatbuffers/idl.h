@@ -18,6 +18,7 @@
 #define FLATBUFFERS_IDL_H_
 
 #include <map>
+#include <set>
 #include <stack>
 #include <memory>
 #include <functional>
@@ -153,6 +154,67 @@ struct Value {
   voffset_t offset;
 };
 
+// A flat open-addressing hash index from names to symbol pointers (FNV-1a,
+// power-of-two buckets, linear probing, kept at most half full). It only
+// indexes entries owned elsewhere: keys are stored as pointers into the
+// std::map nodes of the SymbolTable below, which are stable for the life
+// of the table.
+template<typename T> class SymbolIndex {
+ public:
+  SymbolIndex() : num_entries_(0) {}
+
+  void Clear() {
+    buckets_.clear();
+    num_entries_ = 0;
+  }
+
+  // key must outlive this index (see above).
+  void Insert(const std::string &key, T *symbol) {
+    if ((num_entries_ + 1) * 2 > buckets_.size()) {
+      // Double (or create) the table and rehash everything into it.
+      std::vector<Bucket> old_buckets(buckets_.size() ? buckets_.size() * 2
+                                                      : 16);
+      buckets_.swap(old_buckets);
+      for (auto it = old_buckets.begin(); it != old_buckets.end(); ++it) {
+        if (it->symbol) InsertBucket(it->hash, it->key, it->symbol);
+      }
+    }
+    InsertBucket(HashFnv1a<uint32_t>(key.c_str()), &key, symbol);
+    num_entries_++;
+  }
+
+  T *Lookup(const std::string &key) const {
+    if (buckets_.empty()) return nullptr;
+    auto hash = HashFnv1a<uint32_t>(key.c_str());
+    auto mask = buckets_.size() - 1;
+    for (auto i = hash & mask; buckets_[i].symbol; i = (i + 1) & mask) {
+      if (buckets_[i].hash == hash && *buckets_[i].key == key)
+        return buckets_[i].symbol;
+    }
+    return nullptr;
+  }
+
+ private:
+  struct Bucket {
+    Bucket() : hash(0), key(nullptr), symbol(nullptr) {}
+    uint32_t hash;
+    const std::string *key;
+    T *symbol;
+  };
+
+  void InsertBucket(uint32_t hash, const std::string *key, T *symbol) {
+    auto mask = buckets_.size() - 1;
+    auto i = hash & mask;
+    while (buckets_[i].symbol) i = (i + 1) & mask;
+    buckets_[i].hash = hash;
+    buckets_[i].key = key;
+    buckets_[i].symbol = symbol;
+  }
+
+  size_t num_entries_;
+  std::vector<Bucket> buckets_;
+};
+
 // Helper class that retains the original order of a set of identifiers and
 // also provides quick lookup.
 template<typename T> class SymbolTable {
@@ -167,7 +229,8 @@ template<typename T> class SymbolTable {
     vec.emplace_back(e);
     auto it = dict.find(name);
     if (it != dict.end()) return true;
-    dict[name] = e;
+    auto inserted = dict.insert(std::make_pair(name, e)).first;
+    index_.Insert(inserted->first, e);
     return false;
   }
 
@@ -177,19 +240,34 @@ template<typename T> class SymbolTable {
       auto obj = it->second;
       dict.erase(it);
       dict[newname] = obj;
+      // Renames are rare (proto translation only): just rebuild the index.
+      index_.Clear();
+      for (auto kv = dict.begin(); kv != dict.end(); ++kv) {
+        index_.Insert(kv->first, kv->second);
+      }
     } else {
       assert(false);
     }
   }
 
   T *Lookup(const std::string &name) const {
-    auto it = dict.find(name);
-    return it == dict.end() ? nullptr : it->second;
+    return index_.Lookup(name);
+  }
+
+  // Forgets all entries without deleting them, for tables whose contents
+  // are owned by another SymbolTable (see Parser::UseSharedSchema()).
+  void DisownAll() {
+    dict.clear();
+    vec.clear();
+    index_.Clear();
   }
 
  public:
-  std::map<std::string, T *> dict;      // quick lookup
+  std::map<std::string, T *> dict;      // ordered iteration
   std::vector<T *> vec;  // Used to iterate in order of insertion
+
+ private:
+  SymbolIndex<T> index_;  // hashed lookup
 };
 
 // A name space, as set in the schema.
@@ -202,6 +280,16 @@ struct Namespace {
   // the current namespace has.
   std::string GetFullyQualifiedName(const std::string &name,
                                     size_t max_components = 1000) const;
+
+  // Must be called when existing components are rewritten in place (as
+  // opposed to appended, which is always safe), e.g. by the proto
+  // identifier escaping in GenerateFBS().
+  void InvalidateQualifiedNameCache() { qualified_prefix_cache_.clear(); }
+
+ private:
+  // Memoized "A.B.C" prefixes by component count, so candidate-namespace
+  // probes during name resolution don't rebuild the same strings.
+  mutable std::vector<std::string> qualified_prefix_cache_;
 };
 
 // Base class for all definition types (fields, structs_, enums_).
@@ -353,12 +441,16 @@ struct IDLOptions {
   bool generate_name_strings;
   bool escape_proto_identifiers;
   bool generate_object_based_api;
+  bool generate_column_accessors;
+  bool generate_fast_verifiers;
+  bool generate_eq_hash;
   std::string cpp_object_api_pointer_type;
   std::string cpp_object_api_string_type;
   bool union_value_namespacing;
   bool allow_non_utf8;
   std::string include_prefix;
   bool binary_schema_comments;
+  bool use_schema_cache;
   std::string go_namespace;
 
   // Possible options for the more general generator below.
@@ -398,10 +490,14 @@ struct IDLOptions {
       generate_name_strings(false),
       escape_proto_identifiers(false),
       generate_object_based_api(false),
+      generate_column_accessors(false),
+      generate_fast_verifiers(false),
+      generate_eq_hash(false),
       cpp_object_api_pointer_type("std::unique_ptr"),
       union_value_namespacing(true),
       allow_non_utf8(false),
       binary_schema_comments(false),
+      use_schema_cache(false),
       lang(IDLOptions::kJava),
       lang_to_generate(0) {}
 };
@@ -466,7 +562,8 @@ class Parser : public ParserState {
     : root_struct_def_(nullptr),
       opts(options),
       source_(nullptr),
-      anonymous_counter(0) {
+      anonymous_counter(0),
+      borrowed_schema_(false) {
     // Just in case none are declared:
     namespaces_.push_back(new Namespace());
     known_attributes_["deprecated"] = true;
@@ -490,6 +587,14 @@ class Parser : public ParserState {
   }
 
   ~Parser() {
+    if (borrowed_schema_) {
+      // The definitions belong to the parser we borrowed them from.
+      types_.DisownAll();
+      structs_.DisownAll();
+      enums_.DisownAll();
+      services_.DisownAll();
+      namespaces_.clear();
+    }
     for (auto it = namespaces_.begin(); it != namespaces_.end(); ++it) {
       delete *it;
     }
@@ -507,6 +612,30 @@ class Parser : public ParserState {
   bool Parse(const char *_source, const char **include_paths = nullptr,
              const char *source_filename = nullptr);
 
+  // Parse a string containing a single JSON object against the already
+  // parsed schema, leaving the schema state untouched. Unlike Parse() this
+  // may be called many times on one Parser with bounded memory: builder_ is
+  // cleared (and its backing store reused) per record. Requires a root type
+  // to be set. On success builder_ contains the finished buffer.
+  bool ParseJson(const char *json);
+
+  // Discards all per-document state (builder, field stack, cursor, error)
+  // while keeping the compiled schema, so the parser can be reused for the
+  // next document without re-parsing the schema. ParseJson() calls this
+  // implicitly; call it directly to release the last document's buffer
+  // early or to recover after a failed parse.
+  void Reset();
+
+  // Makes this parser a read-only view of the compiled schema held by
+  // "schema", which must already have parsed one. The schema is shared, not
+  // copied: "schema" must outlive this parser and must not parse further
+  // schema text while shared. Per-document state stays per-parser, so each
+  // thread can ParseJson() concurrently through its own view (lookups into
+  // the shared tables are pure reads). Only the JSON entry points
+  // (ParseJson(), SetRootType(), Reset()) may be used on a view; Parse()
+  // would mutate the shared definitions and asserts.
+  void UseSharedSchema(const Parser &schema);
+
   // Set the root type. May override the one set in the schema.
   bool SetRootType(const char *name);
 
@@ -522,6 +651,13 @@ class Parser : public ParserState {
   // See reflection/reflection.fbs
   void Serialize();
 
+  // The reverse of Serialize(): initializes this Parser from a binary
+  // schema (as produced by flatc --schema --binary), so JSON can be parsed
+  // and printed at runtime without ever loading or lexing schema text.
+  // All names are copied out, so the buffer may be freed afterwards.
+  // Returns false if the buffer fails verification.
+  bool Deserialize(const uint8_t *buf, size_t size);
+
   // Checks that the schema represented by this parser is a safe evolution
   // of the schema provided. Returns non-empty error on any problems.
   std::string ConformTo(const Parser &base);
@@ -529,6 +665,13 @@ class Parser : public ParserState {
   FLATBUFFERS_CHECKED_ERROR CheckBitsFit(int64_t val, size_t bits);
 
 private:
+  void DeserializeAttributes(Definition *def,
+                             const Vector<Offset<reflection::KeyValue>> *attrs);
+  bool MergeInclude(Parser &include_parser, const std::string &filepath);
+  bool LoadSchemaCache(const std::string &filepath, uint64_t source_hash);
+  void SaveSchemaCache(Parser &include_parser, const std::string &filepath,
+                       uint64_t source_hash);
+  FLATBUFFERS_CHECKED_ERROR DoParseJson(const char *json);
   FLATBUFFERS_CHECKED_ERROR Error(const std::string &msg);
   FLATBUFFERS_CHECKED_ERROR ParseHexNum(int nibbles, uint64_t *val);
   FLATBUFFERS_CHECKED_ERROR Next();
@@ -616,6 +759,8 @@ private:
   std::vector<std::pair<Value, FieldDef *>> field_stack_;
 
   int anonymous_counter;
+
+  bool borrowed_schema_;  // Schema tables are owned by another Parser.
 };
 
 // Utility functions for multiple generators:
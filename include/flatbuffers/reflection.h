@@ -22,6 +22,9 @@
 // Should normally not be a problem since it can be generated by the
 // previous version of flatc whenever this code needs to change.
 // See reflection/generate_code.sh
+#include <map>
+
+#include "flatbuffers/flexbuffers.h"
 #include "flatbuffers/reflection_generated.h"
 
 // Helper functionality for reflection.
@@ -258,6 +261,42 @@ template<typename T> T *GetAnyFieldAddressOf(const Struct &st,
   return (T *)st.GetAddressOf(field.offset());
 }
 
+// A precompiled plan for reading the same set of fields out of many tables
+// of one reflection::Object. Constructing the plan resolves each field's
+// vtable offset, type and default once; the Extract calls below then read a
+// whole row with no schema lookups in the loop. Use this instead of repeated
+// GetAnyFieldI/F calls when scanning large numbers of tables.
+class FieldAccessPlan {
+ public:
+  // "fields" may be any subset of object.fields(), in any order; extracted
+  // values appear in that same order.
+  FieldAccessPlan(const reflection::Object &object,
+                  const std::vector<const reflection::Field *> &fields);
+
+  size_t num_fields() const { return entries_.size(); }
+
+  // Read all planned fields of "table" into "dst", which must have room for
+  // num_fields() values. Fields not present in the table produce their
+  // schema default. Conversion rules are those of GetAnyValueI/F.
+  void ExtractI(const Table &table, int64_t *dst) const;
+  void ExtractF(const Table &table, double *dst) const;
+
+  // The inline address of each planned field in "table", or nullptr for
+  // fields not present. For offset fields this is the address of the
+  // uoffset_t, as with GetAnyFieldAddressOf.
+  void ExtractAddressOf(const Table &table, const uint8_t **dst) const;
+
+ private:
+  struct Entry {
+    voffset_t offset;     // The field's offset into the vtable.
+    uint8_t base_type;    // reflection::BaseType, fits in a byte.
+    uint8_t size;         // Inline width of the field in bytes.
+    int64_t default_i;
+    double default_f;
+  };
+  std::vector<Entry> entries_;
+};
+
 // ------------------------- SETTERS -------------------------
 
 // Set any scalar field, if you know its exact type.
@@ -442,6 +481,61 @@ void ResizeVector(const reflection::Schema &schema, uoffset_t newsize, T val,
 }
 #endif
 
+// Queues multiple size-changing mutations (string sets, vector resizes)
+// against one FlatBuffer and applies them in a single fixup pass.
+// SetString / ResizeAnyVector above each walk and fix up the entire buffer,
+// so N calls cost N full traversals; a session costs one, making bulk
+// in-place editing linear in the buffer size.
+// Queue operations against the buffer as it currently is (the queued
+// pointers must all point into *flatbuf, and the resized ranges must not
+// overlap), then call Apply(). As with the single-shot functions, pointers
+// into the buffer are invalidated when Apply() resizes it; use piv() /
+// pointer_inside_vector to keep references across it.
+class BufferMutationSession {
+ public:
+  BufferMutationSession(const reflection::Schema &schema,
+                        std::vector<uint8_t> *flatbuf,
+                        const reflection::Object *root_table = nullptr)
+    : schema_(schema), flatbuf_(flatbuf), root_table_(root_table) {}
+
+  // Queue replacing the contents of "str" with "val".
+  void SetString(const String *str, const std::string &val);
+
+  // Queue resizing "vec", currently num_elems elements of elem_size bytes
+  // each, to newsize elements. New elements are zero-initialized.
+  void ResizeAnyVector(const VectorOfAny *vec, uoffset_t newsize,
+                       uoffset_t num_elems, uoffset_t elem_size);
+
+  // As above, for a typed vector.
+  template<typename T> void ResizeVector(const Vector<T> *vec,
+                                         uoffset_t newsize) {
+    ResizeAnyVector(reinterpret_cast<const VectorOfAny *>(vec), newsize,
+                    vec->size(), static_cast<uoffset_t>(sizeof(T)));
+  }
+
+  // Apply all queued mutations in one fixup pass. The session is empty
+  // afterwards and may be re-used for further batches.
+  void Apply();
+
+ private:
+  struct Mutation {
+    uoffset_t start;        // Where bytes get inserted or removed.
+    int delta;              // Size change in bytes (unaligned).
+    uoffset_t header_pos;   // Location of the length field to rewrite.
+    uoffset_t new_len;      // New value for that length field.
+    std::string str_value;  // For strings: the new contents.
+    bool is_string;
+  };
+  static bool MutationLess(const Mutation &a, const Mutation &b) {
+    return a.start < b.start;
+  }
+
+  const reflection::Schema &schema_;
+  std::vector<uint8_t> *flatbuf_;
+  const reflection::Object *root_table_;
+  std::vector<Mutation> mutations_;
+};
+
 // Adds any new data (in the form of a new FlatBuffer) to an existing
 // FlatBuffer. This can be used when any of the above methods are not
 // sufficient, in particular for adding new tables and new fields.
@@ -476,6 +570,37 @@ Offset<const Table *> CopyTable(FlatBufferBuilder &fbb,
                                 const Table &table,
                                 bool use_string_pooling = false);
 
+// Rewrites the subtree rooted at "table" into "fbb" in depth-first field
+// order: in the finished buffer each table is followed by its subobjects,
+// first field first, so pointer-chasing reads touch memory near-
+// sequentially instead of jumping across the buffer. A builder emits
+// children strictly before their parents in whatever order the
+// application created them, so on large, long-lived buffers this one-time
+// rewrite buys materially better cache and TLB behavior for readers.
+// Unlike CopyTable this also preserves sharing: a table reachable twice
+// (DAG) is emitted once, strings are pooled, and vtables are deduplicated
+// by the builder as usual. Returns the new root; finish "fbb" with it.
+Offset<const Table *> OptimizeLayout(FlatBufferBuilder &fbb,
+                                     const reflection::Schema &schema,
+                                     const reflection::Object &objectdef,
+                                     const Table &table);
+
+// Slices the subtree rooted at "table" (of type objectdef) out of its
+// buffer into "out", making a stand-alone FlatBuffer with "table" as its
+// root. Since all offsets within a subtree are relative, a subtree whose
+// bytes lie (mostly) contiguous in memory can be emitted with a single
+// bulk copy plus a new root offset, which is much faster than rebuilding
+// it object by object. When the subtree's byte span turns out to be
+// dominated by unrelated data (e.g. it shares vtables or strings with
+// distant parts of the buffer), this falls back to CopyTable and emits a
+// compact rebuild instead. Either way "out" receives a complete, valid
+// buffer (without a file identifier). Returns true if the bulk-copy path
+// was taken.
+bool ExtractSubtree(const reflection::Schema &schema,
+                    const reflection::Object &objectdef,
+                    const Table &table,
+                    std::vector<uint8_t> *out);
+
 // Verifies the provided flatbuffer using reflection.
 // root should point to the root type for this flatbuffer.
 // buf should point to the start of flatbuffer data.
@@ -485,6 +610,165 @@ bool Verify(const reflection::Schema &schema,
             const uint8_t *buf,
             size_t length);
 
+// ------------------------- SCHEMA EVOLUTION -------------------------
+
+// Rewrites buffers written under one schema version directly into another,
+// without the binary -> JSON -> reparse round trip. The field mapping is
+// computed once at construction: for every table type reachable from the
+// root, the source and target fields are matched by name and checked for
+// type compatibility. Transcoding then walks each buffer like CopyTable,
+// except that tables whose layout (and reachable subtree) is unchanged
+// between the versions are bulk-copied as raw bytes (the technique of
+// ExtractSubtree) instead of being rebuilt field by field.
+// Fields only present in the target are left absent (their new defaults
+// apply); fields removed from the target are dropped. A type change for a
+// field that exists on both sides makes the plan invalid.
+class SchemaTranscoder {
+ public:
+  // Compiles the mapping from src's root table to dst's, and everything
+  // reachable from it. Both schemas must outlive the transcoder.
+  SchemaTranscoder(const reflection::Schema &src,
+                   const reflection::Schema &dst);
+
+  // False if the schemas cannot be mapped (see error()); Transcode() must
+  // not be called then.
+  bool Valid() const { return valid_; }
+  const std::string &error() const { return error_; }
+
+  // Transcodes the buffer rooted at "root" (a table of src's root type)
+  // into "fbb" and finishes the buffer (without a file identifier).
+  // Returns false if a record is missing a field the target schema
+  // requires, in which case the builder's contents are undefined.
+  bool Transcode(const Table &root, FlatBufferBuilder &fbb);
+
+  // Convenience overload for a whole buffer.
+  bool Transcode(const uint8_t *buf, FlatBufferBuilder &fbb) {
+    return Transcode(*GetAnyRoot(buf), fbb);
+  }
+
+ private:
+  // One target field of a table plan: the matching source field (null if
+  // the field is new) and, for (vectors of) tables, the index of the
+  // element type's own plan.
+  struct MappedField {
+    const reflection::Field *src_field;
+    const reflection::Field *dst_field;
+    size_t subplan;
+  };
+  struct TablePlan {
+    const reflection::Object *src_object;
+    const reflection::Object *dst_object;
+    std::vector<MappedField> fields;  // In target field order.
+    bool identical;  // Unchanged layout: subtrees may be bulk-copied.
+    bool compiled;   // False while still being compiled (cycles).
+  };
+
+  size_t CompileObject(const reflection::Object &src_object,
+                       const reflection::Object &dst_object);
+  bool CompileStruct(const reflection::Object &src_object,
+                     const reflection::Object &dst_object);
+  void Fail(const std::string &msg);
+  bool TranscodeTable(size_t plan_index, const Table &table,
+                      FlatBufferBuilder &fbb, uoffset_t *out);
+
+  const reflection::Schema &src_;
+  const reflection::Schema &dst_;
+  std::vector<TablePlan> plans_;  // plans_[0] is the root.
+  std::map<const reflection::Object *, size_t> plan_index_;  // By src object.
+  bool valid_;
+  std::string error_;
+};
+
+// ------------------------- STRUCTURAL DIFFING -------------------------
+
+// Deep, schema-driven equality of two tables (field values, not bytes:
+// a value explicitly stored as its default compares equal to an absent
+// field, and unknown fields outside the schema are ignored).
+bool TablesEqual(const reflection::Schema &schema,
+                 const reflection::Object &objectdef,
+                 const Table &a, const Table &b);
+
+// Compares two buffers of the same schema and writes a compact delta into
+// "delta": unchanged subtrees are elided entirely, changed tables are
+// recorded field by field, and vectors of tables or strings are diffed
+// per element, so the delta size tracks the amount of actual change
+// rather than the buffer size. Returns true if the buffers differ (a
+// valid, trivial delta is written either way).
+bool MakeDelta(const reflection::Schema &schema,
+               const reflection::Object &objectdef,
+               const Table &from, const Table &to,
+               std::vector<uint8_t> *delta);
+
+// The inverse: rebuilds the "to" buffer into "fbb" (finished, without a
+// file identifier) from the "from" buffer plus a delta produced by
+// MakeDelta against it. Unchanged parts are copied from "from", changed
+// parts come from the delta. Returns false if the delta is malformed or
+// doesn't belong to this buffer, in which case the builder's contents
+// are undefined.
+bool ApplyDelta(const reflection::Schema &schema,
+                const reflection::Object &objectdef,
+                const Table &from, const uint8_t *delta, size_t delta_len,
+                FlatBufferBuilder &fbb);
+
+// ------------------------- FLEXBUFFER CONVERSION -------------------------
+
+// Converts FlexBuffer documents (maps whose keys are field names) into
+// FlatBuffers described by a reflection::Schema. The schema is compiled into
+// a per-table plan once, up front: fields are pre-sorted to match FlexBuffer
+// key order, so each document is transcoded with a linear merge over its keys
+// rather than a lookup per field, and key vectors shared between maps (see
+// flexbuffers::Builder) are matched once and cached. Vectors of scalars whose
+// FlexBuffer representation already has the target element width are
+// bulk-copied rather than pushed element by element (both formats store
+// little-endian data).
+// Union, union type and struct fields are not converted (FlexBuffer maps
+// have no natural encoding for them) and are left absent in the output.
+class FlexToFlatConverter {
+ public:
+  // Compiles plans for "root" (defaults to the schema's root table) and
+  // everything reachable from it. The schema must outlive the converter.
+  FlexToFlatConverter(const reflection::Schema &schema,
+                      const reflection::Object *root = nullptr);
+
+  // Transcodes "document" (which must be a map) into "fbb" and finishes the
+  // buffer. Returns false if the document doesn't fit the schema (wrong
+  // value type for a field, or a required field missing), in which case the
+  // builder's contents are undefined. Unknown keys are ignored. Not
+  // thread-safe: matched key sets are cached across calls.
+  bool Convert(const flexbuffers::Reference &document, FlatBufferBuilder &fbb);
+
+ private:
+  // One field of a table plan: the schema field plus, for (vectors of)
+  // tables, the index of the element type's own plan.
+  struct PlannedField {
+    const reflection::Field *field;
+    size_t subplan;
+  };
+  struct TablePlan {
+    const reflection::Object *object;
+    std::vector<PlannedField> fields;  // Sorted by field name.
+    // Cache of the last key vector matched against this plan: for each
+    // planned field, the element index of its key in that vector, or -1.
+    // The data pointer alone is not a safe cache key (allocators reuse
+    // addresses across documents), so the key count and a hash of the key
+    // bytes validate it.
+    const uint8_t *last_keys;
+    size_t last_num_keys;
+    uint64_t last_keys_hash;
+    std::vector<int> key_index;
+  };
+
+  static bool PlannedFieldLess(const PlannedField &a, const PlannedField &b);
+  size_t CompileObject(const reflection::Object &objectdef);
+  void MatchKeys(TablePlan &plan, const flexbuffers::Map &map);
+  bool ConvertTable(size_t plan_index, const flexbuffers::Map &map,
+                    FlatBufferBuilder &fbb, uoffset_t *out);
+
+  const reflection::Schema &schema_;
+  std::vector<TablePlan> plans_;  // plans_[0] is the root.
+  std::map<const reflection::Object *, size_t> plan_index_;
+};
+
 }  // namespace flatbuffers
 
 #endif  // FLATBUFFERS_REFLECTION_H_
@@ -22,6 +22,7 @@
 #include <string>
 #include <sstream>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
 #ifdef _WIN32
@@ -42,12 +43,79 @@
 
 #include "flatbuffers/flatbuffers.h"
 
+// MSVC only gained a conforming snprintf in 2015.
+#if defined(_MSC_VER) && _MSC_VER < 1900
+  #define flatbuffers_snprintf _snprintf
+#else
+  #define flatbuffers_snprintf snprintf
+#endif
+
 namespace flatbuffers {
 
+// Writes the decimal digits of "t" ending just before "end" and returns a
+// pointer to the first digit. Digits are emitted two at a time from a
+// lookup table, halving the number of divisions compared to the textbook
+// loop. "end" must have at least 20 bytes of room before it.
+inline char *IntToDigits(uint64_t t, char *end) {
+  static const char digit_pairs[201] =
+      "0001020304050607080910111213141516171819"
+      "2021222324252627282930313233343536373839"
+      "4041424344454647484950515253545556575859"
+      "6061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  auto p = end;
+  while (t >= 100) {
+    auto index = static_cast<size_t>((t % 100) * 2);
+    t /= 100;
+    *--p = digit_pairs[index + 1];
+    *--p = digit_pairs[index];
+  }
+  if (t >= 10) {
+    auto index = static_cast<size_t>(t * 2);
+    *--p = digit_pairs[index + 1];
+    *--p = digit_pairs[index];
+  } else {
+    *--p = static_cast<char>('0' + t);
+  }
+  return p;
+}
+
+inline std::string SignedIntToString(int64_t t) {
+  char buf[21];  // Enough for a 64bit integer with sign.
+  auto end = buf + sizeof(buf);
+  char *start;
+  if (t < 0) {
+    // Negate as unsigned, so the minimum value doesn't overflow.
+    start = IntToDigits(0 - static_cast<uint64_t>(t), end);
+    *--start = '-';
+  } else {
+    start = IntToDigits(static_cast<uint64_t>(t), end);
+  }
+  return std::string(start, end);
+}
+
+inline std::string UnsignedIntToString(uint64_t t) {
+  char buf[20];
+  auto end = buf + sizeof(buf);
+  return std::string(IntToDigits(t, end), end);
+}
+
 // Convert an integer or floating point value to a string.
 // In contrast to std::stringstream, "char" values are
 // converted to a string of digits, and we don't use scientific notation.
-template<typename T> std::string NumToString(T t) {
+// Integers don't go through std::stringstream (and its locale handling
+// and allocations): text generation spends most of its time right here.
+template<typename T>
+typename std::enable_if<std::is_integral<T>::value, std::string>::type
+NumToString(T t) {
+  return std::is_signed<T>::value
+      ? SignedIntToString(static_cast<int64_t>(t))
+      : UnsignedIntToString(static_cast<uint64_t>(t));
+}
+// Fallback for any other type with an operator<<.
+template<typename T>
+typename std::enable_if<!std::is_integral<T>::value, std::string>::type
+NumToString(T t) {
   std::stringstream ss;
   ss << t;
   return ss.str();
@@ -62,13 +130,13 @@ template<> inline std::string NumToString<unsigned char>(unsigned char t) {
 
 // Special versions for floats/doubles.
 template<> inline std::string NumToString<double>(double t) {
-  // to_string() prints different numbers of digits for floats depending on
-  // platform and isn't available on Android, so we use stringstream
-  std::stringstream ss;
-  // Use std::fixed to surpress scientific notation.
-  ss << std::fixed << t;
-  auto s = ss.str();
-  // Sadly, std::fixed turns "1" into "1.00000", so here we undo that.
+  // %f is the fixed notation NumToString always produced (to_string()
+  // prints different numbers of digits for floats depending on platform,
+  // and isn't available on Android).
+  char buf[400];  // Fixed notation of a double is at most ~340 chars.
+  auto len = flatbuffers_snprintf(buf, sizeof(buf), "%f", t);
+  std::string s(buf, len > 0 ? static_cast<size_t>(len) : 0);
+  // Sadly, fixed notation turns "1" into "1.000000", so here we undo that.
   auto p = s.find_last_not_of('0');
   if (p != std::string::npos) {
     s.resize(p + 1);  // Strip trailing zeroes.
@@ -85,13 +153,11 @@ template<> inline std::string NumToString<float>(float t) {
 // The returned string length is always xdigits long, prefixed by 0 digits.
 // For example, IntToStringHex(0x23, 8) returns the string "00000023".
 inline std::string IntToStringHex(int i, int xdigits) {
-  std::stringstream ss;
-  ss << std::setw(xdigits)
-     << std::setfill('0')
-     << std::hex
-     << std::uppercase
-     << i;
-  return ss.str();
+  assert(xdigits <= 8);
+  char buf[9];
+  auto len = flatbuffers_snprintf(buf, sizeof(buf), "%0*X", xdigits,
+                      static_cast<unsigned>(i));
+  return std::string(buf, len > 0 ? static_cast<size_t>(len) : 0);
 }
 
 // Portable implementation of strtoll().
@@ -136,6 +202,66 @@ bool DirExists(const char *name);
 // no transcoding.
 bool LoadFile(const char *name, bool binary, std::string *buf);
 
+// A read-only memory mapping of a file. Opening a large binary FlatBuffer
+// this way costs page faults on the parts actually accessed instead of an
+// upfront read-and-copy through the stream layer, the pages are shared with
+// other processes mapping the same file, and mappings are page-aligned, so
+// data() can be handed straight to GetRoot(). For binary data only: the
+// contents are not NUL-terminated. On platforms without file mappings (or
+// when mapping fails, e.g. for empty files), Open() falls back to loading
+// through LoadFile() - and thus through any function set with
+// SetLoadFileFunction() - so data()/size() are always valid after a
+// successful Open().
+class MappedFile {
+ public:
+  MappedFile() : data_(nullptr), size_(0), mapped_(false), writable_(false) {}
+  ~MappedFile() { Close(); }
+
+  // Maps "filename", closing any previous mapping first. Returns false if
+  // the file can't be opened.
+  bool Open(const char *filename);
+
+  // Like Open(), but maps the file copy-on-write: the contents are
+  // writable through mutable_data(), and only the pages actually written
+  // are materialized privately - mutating one field of a multi-GB buffer
+  // costs one page, and the file itself is never modified. Use with
+  // GetMutableRoot() and the SetField / mutate_...() style of in-place
+  // mutation; resizing mutations still need a private copy of the whole
+  // buffer. The fallback path loads a (fully private) copy instead.
+  bool OpenCopyOnWrite(const char *filename);
+
+  // Drops the mapping (or fallback copy), discarding any copy-on-write
+  // changes; data() is invalid afterwards. Called by the destructor.
+  void Close();
+
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // The contents of a copy-on-write mapping; only valid after a
+  // successful OpenCopyOnWrite().
+  uint8_t *mutable_data() {
+    assert(writable_);
+    return const_cast<uint8_t *>(data_);
+  }
+
+  // Whether the contents are an actual mapping rather than the fallback's
+  // in-memory copy.
+  bool IsMapped() const { return mapped_; }
+
+ private:
+  // The mapping can't be shared between instances.
+  MappedFile(const MappedFile &);
+  MappedFile &operator=(const MappedFile &);
+
+  bool OpenInternal(const char *filename, bool copy_on_write);
+
+  const uint8_t *data_;
+  size_t size_;
+  bool mapped_;
+  bool writable_;
+  std::string fallback_;
+};
+
 // Save data "buf" of length "len" bytes into a file
 // "name" returning true if successful, false otherwise.
 // If "binary" is false data is written using ifstream's
@@ -157,6 +283,195 @@ inline bool SaveFile(const char *name, const std::string &buf, bool binary) {
   return SaveFile(name, buf.c_str(), buf.size(), binary);
 }
 
+// Streams a sequence of size-prefixed FlatBuffers to a std::ostream: a
+// write-buffered file, pipe or socket stream. Owns a FlatBufferBuilder that
+// is reused across messages (Clear() retains the underlying allocation), so
+// after warm-up, messages are built, framed and flushed without any
+// allocation or staging copy. Each message is followed by padding such that
+// the next one starts at a FLATBUFFERS_MAX_ALIGNMENT boundary, making the
+// resulting file safe to mmap and read in place; iterate the records with
+// NextSizePrefixedMessage below and access them with GetSizePrefixedRoot.
+class StreamWriter {
+ public:
+  explicit StreamWriter(std::ostream &out, uoffset_t initial_size = 1024)
+    : out_(&out), fbb_(initial_size), offset_(0) {}
+
+  // The builder to construct the next message in.
+  FlatBufferBuilder &builder() { return fbb_; }
+
+  // Total bytes written to the stream so far, including alignment padding.
+  size_t offset() const { return offset_; }
+
+  // Finish the message rooted at "root" with a size prefix, append it to
+  // the stream, and reset the builder for the next message.
+  // Returns false if the stream rejected the write.
+  template<typename T> bool WriteMessage(
+      Offset<T> root, const char *file_identifier = nullptr) {
+    fbb_.FinishSizePrefixed(root, file_identifier);
+    out_->write(reinterpret_cast<const char *>(fbb_.GetBufferPointer()),
+                fbb_.GetSize());
+    offset_ += fbb_.GetSize();
+    // Pad so the next message is aligned for any scalar.
+    auto pad = PaddingBytes(offset_, FLATBUFFERS_MAX_ALIGNMENT);
+    const char zeroes[FLATBUFFERS_MAX_ALIGNMENT] = { 0 };
+    out_->write(zeroes, pad);
+    offset_ += pad;
+    fbb_.Clear();
+    return !out_->bad();
+  }
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  StreamWriter(const StreamWriter &);
+  StreamWriter &operator=(const StreamWriter &);
+
+  std::ostream *out_;
+  FlatBufferBuilder fbb_;
+  size_t offset_;
+};
+
+// Walks the size-prefixed messages written by StreamWriter over a
+// contiguous region of memory (a loaded or mmap'd file). Returns a pointer
+// to the message at "*offset" (pass 0 for the first) and advances "*offset"
+// past the message and its alignment padding, or returns nullptr when the
+// region is exhausted. Access the result with GetSizePrefixedRoot.
+inline const uint8_t *NextSizePrefixedMessage(const uint8_t *region,
+                                              size_t region_len,
+                                              size_t *offset) {
+  if (*offset + sizeof(uoffset_t) > region_len) return nullptr;
+  auto msg = region + *offset;
+  auto size = ReadScalar<uoffset_t>(msg);
+  if (!size || *offset + sizeof(uoffset_t) + size > region_len)
+    return nullptr;
+  *offset += sizeof(uoffset_t) + size;
+  *offset += PaddingBytes(*offset, FLATBUFFERS_MAX_ALIGNMENT);
+  return msg;
+}
+
+// A container file format for millions of FlatBuffers with O(1) random
+// access. Records are the same framed, aligned, size-prefixed messages
+// StreamWriter above produces (so each is directly usable in place on a
+// loaded or mmap'd file via GetSizePrefixedRoot), followed by a footer:
+// an array of 64-bit record offsets, the record count, and a magic number,
+// all little-endian. Reaching record N is one index load instead of a walk
+// over N size prefixes. ArchiveWriter maintains the index incrementally
+// while appending; ArchiveReader validates the footer and provides
+// indexed access plus keyed binary search.
+
+// "FBARCH01" as a little-endian scalar.
+static const uint64_t kArchiveMagic = 0x3130484352414246ULL;
+
+class ArchiveWriter {
+ public:
+  explicit ArchiveWriter(std::ostream &out, uoffset_t initial_size = 1024)
+    : writer_(out, initial_size), out_(&out), finished_(false) {}
+
+  // The builder to construct the next record in.
+  FlatBufferBuilder &builder() { return writer_.builder(); }
+
+  size_t num_records() const { return offsets_.size(); }
+
+  // Finish the record rooted at "root", append it, and index it.
+  // For LookupRecord to work on the reader side, records must be appended
+  // in increasing order of their key field.
+  template<typename T> bool Append(Offset<T> root,
+                                   const char *file_identifier = nullptr) {
+    assert(!finished_);
+    offsets_.push_back(writer_.offset());
+    return writer_.WriteMessage(root, file_identifier);
+  }
+
+  // Writes the offset index and trailer; call once, after the last
+  // Append(). Returns false if the stream rejected a write.
+  bool Finish() {
+    assert(!finished_);
+    finished_ = true;
+    // Records are padded to FLATBUFFERS_MAX_ALIGNMENT, so the index that
+    // starts right after them is aligned as-is.
+    for (size_t i = 0; i < offsets_.size(); i++) {
+      WriteFooterScalar(offsets_[i]);
+    }
+    WriteFooterScalar(offsets_.size());
+    WriteFooterScalar(kArchiveMagic);
+    return !out_->bad();
+  }
+
+ private:
+  // You shouldn't really be copying instances of this class.
+  ArchiveWriter(const ArchiveWriter &);
+  ArchiveWriter &operator=(const ArchiveWriter &);
+
+  void WriteFooterScalar(uint64_t value) {
+    value = EndianScalar(value);
+    out_->write(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  StreamWriter writer_;
+  std::ostream *out_;
+  std::vector<uint64_t> offsets_;
+  bool finished_;
+};
+
+class ArchiveReader {
+ public:
+  // "data"/"size" is the complete archive, e.g. a MappedFile's contents.
+  // Check Valid() before any other access: it is false when the footer is
+  // missing, truncated or inconsistent.
+  ArchiveReader(const uint8_t *data, size_t size)
+    : data_(data), index_(nullptr), num_records_(0) {
+    auto footer = 2 * sizeof(uint64_t);
+    if (size < footer) return;
+    if (ReadScalar<uint64_t>(data + size - sizeof(uint64_t)) != kArchiveMagic)
+      return;
+    auto num = ReadScalar<uint64_t>(data + size - footer);
+    if (num > (size - footer) / sizeof(uint64_t)) return;
+    index_ = data + size - footer - static_cast<size_t>(num) *
+             sizeof(uint64_t);
+    num_records_ = static_cast<size_t>(num);
+  }
+
+  bool Valid() const { return index_ != nullptr; }
+  size_t num_records() const { return num_records_; }
+
+  // Start of record i's size-prefixed message, O(1) for any i.
+  const uint8_t *Record(size_t i) const {
+    assert(Valid() && i < num_records_);
+    return data_ + ReadScalar<uint64_t>(index_ + i * sizeof(uint64_t));
+  }
+
+  // Record i's root table.
+  template<typename T> const T *RecordRoot(size_t i) const {
+    return GetSizePrefixedRoot<T>(Record(i));
+  }
+
+  // Binary search over records appended in increasing key order, through
+  // the same generated KeyCompareWithValue() machinery that
+  // CreateVectorOfSortedTables and Vector::LookupByKey use. Returns
+  // nullptr if no record matches.
+  template<typename T, typename K> const T *LookupRecord(K key) const {
+    auto span = num_records_;
+    size_t start = 0;
+    while (span) {
+      auto middle = span / 2;
+      auto table = RecordRoot<T>(start + middle);
+      auto comp = table->KeyCompareWithValue(key);
+      if (comp == 0) return table;
+      if (comp < 0) {
+        start += middle + 1;
+        span -= middle + 1;
+      } else {
+        span = middle;
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  const uint8_t *data_;
+  const uint8_t *index_;
+  size_t num_records_;
+};
+
 // Functionality for minimalistic portable path handling:
 
 static const char kPosixPathSeparator = '/';
@@ -252,6 +252,7 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.EndTable();
   }
   MonsterT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  MonsterT *UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   void UnPackTo(MonsterT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   static flatbuffers::Offset<Monster> Pack(flatbuffers::FlatBufferBuilder &_fbb, const MonsterT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
 };
@@ -387,6 +388,7 @@ struct Weapon FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.EndTable();
   }
   WeaponT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  WeaponT *UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   void UnPackTo(WeaponT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   static flatbuffers::Offset<Weapon> Pack(flatbuffers::FlatBufferBuilder &_fbb, const WeaponT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
 };
@@ -440,6 +442,12 @@ inline MonsterT *Monster::UnPack(const flatbuffers::resolver_function_t *_resolv
   return _o;
 }
 
+inline MonsterT *Monster::UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = _arena.Make<MonsterT>();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
 inline void Monster::UnPackTo(MonsterT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
@@ -489,6 +497,12 @@ inline WeaponT *Weapon::UnPack(const flatbuffers::resolver_function_t *_resolver
   return _o;
 }
 
+inline WeaponT *Weapon::UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = _arena.Make<WeaponT>();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
 inline void Weapon::UnPackTo(WeaponT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
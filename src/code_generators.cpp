@@ -26,43 +26,44 @@
 namespace flatbuffers {
 
 void CodeWriter::operator+=(std::string text) {
-
+  // Walk the line with a cursor rather than re-slicing the tail, so each
+  // substitution costs only the key lookup.
+  size_t pos = 0;
   while (true) {
-    auto begin = text.find("{{");
+    auto begin = text.find("{{", pos);
     if (begin == std::string::npos) {
       break;
     }
 
-    auto end = text.find("}}");
+    auto end = text.find("}}", pos);
     if (end == std::string::npos || end < begin) {
       break;
     }
 
-    // Write all the text before the first {{ into the stream.
-    stream_.write(text.c_str(), begin);
+    // Write all the text before the first {{ into the buffer.
+    buffer_.Append(text.data() + pos, begin - pos);
 
     // The key is between the {{ and }}.
     const std::string key = text.substr(begin + 2, end - begin - 2);
 
     // Find the value associated with the key.  If it exists, write the
-    // value into the stream, otherwise write the key itself into the stream.
+    // value into the buffer, otherwise write the key itself into the buffer.
     auto iter = value_map_.find(key);
     if (iter != value_map_.end()) {
-      const std::string &value = iter->second;
-      stream_ << value;
+      buffer_.Append(iter->second);
     } else {
       assert(false && "could not find key");
-      stream_ << key;
+      buffer_.Append(key);
     }
 
-    // Update the text to everything after the }}.
-    text = text.substr(end + 2);
+    // Continue with everything after the }}.
+    pos = end + 2;
   }
   if (!text.empty() && text.back() == '\\') {
-    text.pop_back();
-    stream_ << text;
+    buffer_.Append(text.data() + pos, text.size() - pos - 1);
   } else {
-    stream_ << text << std::endl;
+    buffer_.Append(text.data() + pos, text.size() - pos);
+    buffer_.Append('\n');
   }
 }
 
@@ -16,6 +16,9 @@
 
 #include "flatbuffers/flatc.h"
 
+#include <mutex>
+#include <thread>
+
 #define FLATC_VERSION "1.6.0 (" __DATE__ ")"
 
 namespace flatbuffers {
@@ -35,6 +38,67 @@ void FlatCompiler::ParseFile(
   include_directories.pop_back();
 }
 
+// Reads one line from f into line (stripping the terminator), growing it as
+// needed. Returns false once the file is exhausted.
+static bool ReadLine(FILE *f, std::string *line) {
+  line->clear();
+  char buf[4096];
+  while (fgets(buf, sizeof(buf), f)) {
+    line->append(buf);
+    if (line->size() && (*line)[line->size() - 1] == '\n') {
+      line->erase(line->size() - 1);
+      if (line->size() && (*line)[line->size() - 1] == '\r')
+        line->erase(line->size() - 1);
+      return true;
+    }
+  }
+  return !line->empty();
+}
+
+// Converts a newline-delimited JSON file record by record against the schema
+// already loaded into parser, writing each record as a size-prefixed
+// flatbuffer. One builder is reused for all records, so memory use is bounded
+// by the largest single record, not the file size.
+void FlatCompiler::StreamJsonLines(flatbuffers::Parser &parser,
+                                   const std::string &filename,
+                                   const std::string &output_path) const {
+  auto in = fopen(filename.c_str(), "rb");
+  if (!in) Error("unable to load file: " + filename);
+  auto ext = parser.file_extension_.length() ? parser.file_extension_ : "bin";
+  auto out_name = output_path +
+                  flatbuffers::StripPath(flatbuffers::StripExtension(filename)) +
+                  "." + ext;
+  auto out = fopen(out_name.c_str(), "wb");
+  if (!out) {
+    fclose(in);
+    Error("unable to write file: " + out_name);
+  }
+  std::string line;
+  size_t line_number = 0;
+  while (ReadLine(in, &line)) {
+    line_number++;
+    // Tolerate blank lines, so concatenated exports convert cleanly.
+    if (line.find_first_not_of(" \t") == std::string::npos) continue;
+    if (!parser.ParseJson(line.c_str())) {
+      fclose(in);
+      fclose(out);
+      Error(filename + ":" + NumToString(line_number) + ": " + parser.error_,
+            false, false);
+    }
+    uoffset_t size = EndianScalar(
+        static_cast<uoffset_t>(parser.builder_.GetSize()));
+    if (fwrite(&size, sizeof(size), 1, out) != 1 ||
+        fwrite(parser.builder_.GetBufferPointer(), 1,
+               parser.builder_.GetSize(), out) != parser.builder_.GetSize()) {
+      fclose(in);
+      fclose(out);
+      Error("error writing file: " + out_name);
+    }
+  }
+  fclose(in);
+  fclose(out);
+}
+
 void FlatCompiler::Warn(const std::string &warn, bool show_exe_name) const {
   params_.warn_fn(this, warn, show_exe_name);
 }
@@ -85,12 +149,26 @@ std::string FlatCompiler::GetUsageString(const char* program_name) const {
       "  --gen-name-strings Generate type name functions for C++.\n"
       "  --escape-proto-ids Disable appending '_' in namespaces names.\n"
       "  --gen-object-api   Generate an additional object-based API.\n"
+      "  --gen-columnar     Generate columnar bulk-extraction accessors (C++).\n"
+      "  --gen-fast-verifiers Generate schema-specialized table verifiers that\n"
+      "                     bound all inline fields with one range check (C++).\n"
+      "  --gen-eq-hash      Generate buffer-level Equals() and HashOf() functions\n"
+      "                     per table that work without unpacking (C++).\n"
       "  --cpp-ptr-type T   Set object API pointer type (default std::unique_ptr)\n"
       "  --cpp-str-type T   Set object API string type (default std::string)\n"
       "                     T::c_str() and T::length() must be supported\n"
       "  --no-js-exports    Removes Node.js style export lines in JS.\n"
       "  --goog-js-export   Uses goog.exports* for closure compiler exporting in JS.\n"
       "  --go-namespace     Generate the overrided namespace in Golang.\n"
+      "  --ndjson           Treat JSON input files as newline-delimited JSON:\n"
+      "                     convert them record by record with bounded memory,\n"
+      "                     writing size-prefixed flatbuffers to one output file.\n"
+      "  --parallel         Run the enabled code generators concurrently,\n"
+      "                     one worker per output language.\n"
+      "  --schema-cache     Cache parsed include files as binary artifacts\n"
+      "                     (<include>.bfbsc) and load those on later runs\n"
+      "                     instead of re-parsing the schema text. Artifacts\n"
+      "                     are invalidated when any included file changes.\n"
       "  --raw-binary       Allow binaries without file_indentifier to be read.\n"
       "                     This may crash flatc given a mismatched schema.\n"
       "  --proto            Input is a .proto, translate to .fbs.\n"
@@ -122,6 +200,8 @@ int FlatCompiler::Compile(int argc, const char** argv) {
   bool any_generator = false;
   bool print_make_rules = false;
   bool raw_binary = false;
+  bool ndjson = false;
+  bool parallel = false;
   bool schema_binary = false;
   bool grpc_enabled = false;
   std::vector<std::string> filenames;
@@ -181,6 +261,12 @@ int FlatCompiler::Compile(int argc, const char** argv) {
         opts.generate_name_strings = true;
       } else if(arg == "--gen-object-api") {
         opts.generate_object_based_api = true;
+      } else if(arg == "--gen-columnar") {
+        opts.generate_column_accessors = true;
+      } else if(arg == "--gen-fast-verifiers") {
+        opts.generate_fast_verifiers = true;
+      } else if(arg == "--gen-eq-hash") {
+        opts.generate_eq_hash = true;
       } else if (arg == "--cpp-ptr-type") {
         if (++argi >= argc) Error("missing type following" + arg, true);
         opts.cpp_object_api_pointer_type = argv[argi];
@@ -197,6 +283,12 @@ int FlatCompiler::Compile(int argc, const char** argv) {
         opts.include_dependence_headers = false;
       } else if (arg == "--gen-onefile") {
         opts.one_file = true;
+      } else if (arg == "--ndjson") {
+        ndjson = true;
+      } else if (arg == "--parallel") {
+        parallel = true;
+      } else if (arg == "--schema-cache") {
+        opts.use_schema_cache = true;
       } else if (arg == "--raw-binary") {
         raw_binary = true;
       } else if(arg == "--") {  // Separator between text and binary inputs.
@@ -258,17 +350,30 @@ int FlatCompiler::Compile(int argc, const char** argv) {
   for (auto file_it = filenames.begin();
             file_it != filenames.end();
           ++file_it) {
+      bool is_binary = static_cast<size_t>(file_it - filenames.begin()) >=
+                       binary_files_from;
+      if (ndjson && !is_binary &&
+          flatbuffers::GetExtension(*file_it) != "fbs") {
+        // Stream the file record by record instead of loading it whole;
+        // the output is written here rather than by a generator.
+        flatbuffers::EnsureDirExists(output_path);
+        StreamJsonLines(*parser.get(), *file_it, output_path);
+        continue;
+      }
       std::string contents;
-      if (!flatbuffers::LoadFile(file_it->c_str(), true, &contents))
+      flatbuffers::MappedFile mapped;
+      if (is_binary) {
+        // Map binary inputs instead of copying them through the stream
+        // layer; text inputs need the NUL-terminated copy below.
+        if (!mapped.Open(file_it->c_str()))
+          Error("unable to load file: " + *file_it);
+      } else if (!flatbuffers::LoadFile(file_it->c_str(), true, &contents)) {
         Error("unable to load file: " + *file_it);
+      }
 
-      bool is_binary = static_cast<size_t>(file_it - filenames.begin()) >=
-                       binary_files_from;
       if (is_binary) {
         parser->builder_.Clear();
-        parser->builder_.PushFlatBuffer(
-          reinterpret_cast<const uint8_t *>(contents.c_str()),
-          contents.length());
+        parser->builder_.PushFlatBuffer(mapped.data(), mapped.size());
         if (!raw_binary) {
           // Generally reading binaries that do not correspond to the schema
           // will crash, and sadly there's no way around that when the binary
@@ -280,7 +385,7 @@ int FlatCompiler::Compile(int argc, const char** argv) {
                  *file_it +
                  "\" matches the schema, use --raw-binary to read this file"
                  " anyway.");
-          } else if (!flatbuffers::BufferHasIdentifier(contents.c_str(),
+          } else if (!flatbuffers::BufferHasIdentifier(mapped.data(),
                          parser->file_identifier_.c_str())) {
             Error("binary \"" +
                  *file_it +
@@ -315,6 +420,78 @@ int FlatCompiler::Compile(int argc, const char** argv) {
       std::string filebase = flatbuffers::StripPath(
                                flatbuffers::StripExtension(*file_it));
 
+      if (parallel && !print_make_rules) {
+        // Namespace::GetFullyQualifiedName memoizes qualified-name prefixes
+        // lazily, even through a const Parser; touch every prefix up front
+        // so the workers below only ever read that cache.
+        for (auto ns_it = parser->namespaces_.begin();
+             ns_it != parser->namespaces_.end(); ++ns_it) {
+          for (size_t count = 1; count <= (*ns_it)->components.size(); count++)
+            (*ns_it)->GetFullyQualifiedName("", count);
+        }
+        // One worker per enabled generator, except that the lang_dispatch
+        // generators (see Generator) all go onto a single worker, which is
+        // then the only thread touching parser->opts.lang.
+        std::vector<std::vector<size_t>> groups;
+        std::vector<size_t> lang_dispatch_group;
+        for (size_t i = 0; i < params_.num_generators; ++i) {
+          if (!generator_enabled[i]) continue;
+          if (params_.generators[i].lang_dispatch) {
+            lang_dispatch_group.push_back(i);
+          } else {
+            groups.push_back(std::vector<size_t>(1, i));
+          }
+        }
+        if (!lang_dispatch_group.empty())
+          groups.push_back(lang_dispatch_group);
+        flatbuffers::EnsureDirExists(output_path);
+        std::mutex report_mutex;
+        std::string errors;
+        std::vector<std::string> warnings;
+        std::vector<std::thread> workers;
+        for (auto group_it = groups.begin(); group_it != groups.end();
+             ++group_it) {
+          const auto &group = *group_it;
+          workers.push_back(std::thread([&, group]() {
+            for (auto gi = group.begin(); gi != group.end(); ++gi) {
+              const auto &generator = params_.generators[*gi];
+              if (generator.lang_dispatch)
+                parser->opts.lang = generator.lang;
+              if (!generator.generate(*parser.get(), output_path, filebase)) {
+                std::lock_guard<std::mutex> lock(report_mutex);
+                errors += std::string("Unable to generate ") +
+                          generator.lang_name + " for " + filebase + "\n";
+              }
+              if (grpc_enabled) {
+                if (generator.generateGRPC != nullptr) {
+                  if (!generator.generateGRPC(*parser.get(), output_path,
+                                              filebase)) {
+                    std::lock_guard<std::mutex> lock(report_mutex);
+                    errors += std::string(
+                                  "Unable to generate GRPC interface for") +
+                              generator.lang_name + "\n";
+                  }
+                } else {
+                  std::lock_guard<std::mutex> lock(report_mutex);
+                  warnings.push_back(
+                      std::string("GRPC interface generator not implemented "
+                                  "for ") + generator.lang_name);
+                }
+              }
+            }
+          }));
+        }
+        for (auto w = workers.begin(); w != workers.end(); ++w) w->join();
+        for (auto w = warnings.begin(); w != warnings.end(); ++w) Warn(*w);
+        if (!errors.empty()) {
+          errors.erase(errors.size() - 1);  // Trailing linefeed.
+          Error(errors);
+        }
+        if (opts.proto_mode) GenerateFBS(*parser.get(), output_path, filebase);
+        parser->MarkGenerated();
+        continue;
+      }
+
       for (size_t i = 0; i < params_.num_generators; ++i) {
         parser->opts.lang = params_.generators[i].lang;
         if (generator_enabled[i]) {
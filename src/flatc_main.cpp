@@ -50,52 +50,52 @@ int main(int argc, const char *argv[]) {
       nullptr,
       flatbuffers::IDLOptions::kBinary,
       "Generate wire format binaries for any data definitions",
-      flatbuffers::BinaryMakeRule },
+      flatbuffers::BinaryMakeRule, false },
     { flatbuffers::GenerateTextFile, "-t", "--json", "text",
       nullptr,
       flatbuffers::IDLOptions::kJson,
       "Generate text output for any data definitions",
-      flatbuffers::TextMakeRule },
+      flatbuffers::TextMakeRule, false },
     { flatbuffers::GenerateCPP,      "-c", "--cpp", "C++",
       flatbuffers::GenerateCppGRPC,
       flatbuffers::IDLOptions::kCpp,
       "Generate C++ headers for tables/structs",
-      flatbuffers::CPPMakeRule },
+      flatbuffers::CPPMakeRule, false },
     { flatbuffers::GenerateGo,       "-g", "--go", "Go",
       flatbuffers::GenerateGoGRPC,
       flatbuffers::IDLOptions::kGo,
       "Generate Go files for tables/structs",
-      flatbuffers::GeneralMakeRule },
+      flatbuffers::GeneralMakeRule, false },
     { flatbuffers::GenerateGeneral,  "-j", "--java", "Java",
       nullptr,
       flatbuffers::IDLOptions::kJava,
       "Generate Java classes for tables/structs",
-      flatbuffers::GeneralMakeRule },
+      flatbuffers::GeneralMakeRule, true },
     { flatbuffers::GenerateJS,       "-s", "--js", "JavaScript",
       nullptr,
       flatbuffers::IDLOptions::kJs,
       "Generate JavaScript code for tables/structs",
-      flatbuffers::JSMakeRule },
+      flatbuffers::JSMakeRule, false },
     { flatbuffers::GenerateGeneral,  "-n", "--csharp", "C#",
       nullptr,
       flatbuffers::IDLOptions::kCSharp,
       "Generate C# classes for tables/structs",
-      flatbuffers::GeneralMakeRule },
+      flatbuffers::GeneralMakeRule, true },
     { flatbuffers::GeneratePython,   "-p", "--python", "Python",
       nullptr,
       flatbuffers::IDLOptions::kPython,
       "Generate Python files for tables/structs",
-      flatbuffers::GeneralMakeRule },
+      flatbuffers::GeneralMakeRule, false },
     { flatbuffers::GeneratePhp, nullptr, "--php", "PHP",
       nullptr,
       flatbuffers::IDLOptions::kPhp,
       "Generate PHP files for tables/structs",
-      flatbuffers::GeneralMakeRule },
+      flatbuffers::GeneralMakeRule, false },
     { flatbuffers::GenerateSwift,  "-w", "--swift", "Swift",
         nullptr,
         flatbuffers::IDLOptions::kSwift,
         "Generate Swift classes for tables/structs",
-        flatbuffers::GeneralMakeRule },
+        flatbuffers::GeneralMakeRule, false },
     };
 
   flatbuffers::FlatCompiler::InitParams params;
@@ -92,6 +92,9 @@ class CppGenerator : public BaseGenerator {
     code_ += "";
 
     code_ += "#include \"flatbuffers/flatbuffers.h\"";
+    if (parser_.opts.generate_eq_hash) {
+      code_ += "#include \"flatbuffers/hash.h\"";
+    }
     code_ += "";
 
     if (parser_.opts.include_dependence_headers) {
@@ -161,6 +164,49 @@ class CppGenerator : public BaseGenerator {
       }
     }
 
+    // Generate buffer-level equality and hashing functions. Tables and
+    // unions may reference each other in any order, so prototype everything
+    // before the first definition.
+    if (parser_.opts.generate_eq_hash) {
+      for (auto it = parser_.structs_.vec.begin();
+           it != parser_.structs_.vec.end(); ++it) {
+        const auto &struct_def = **it;
+        if (!struct_def.fixed && !struct_def.generated) {
+          SetNameSpace(struct_def.defined_namespace);
+          code_ += TableEqualsSignature(struct_def) + ";";
+          code_ += TableHashSignature(struct_def, true) + ";";
+          code_ += TableHashSignature(struct_def, false) + ";";
+          code_ += "";
+        }
+      }
+      for (auto it = parser_.enums_.vec.begin();
+           it != parser_.enums_.vec.end(); ++it) {
+        const auto &enum_def = **it;
+        if (enum_def.is_union && !enum_def.generated) {
+          SetNameSpace(enum_def.defined_namespace);
+          code_ += UnionEqualsSignature(enum_def) + ";";
+          code_ += UnionHashSignature(enum_def) + ";";
+          code_ += "";
+        }
+      }
+      for (auto it = parser_.enums_.vec.begin();
+           it != parser_.enums_.vec.end(); ++it) {
+        const auto &enum_def = **it;
+        if (enum_def.is_union && !enum_def.generated) {
+          SetNameSpace(enum_def.defined_namespace);
+          GenUnionEqHash(enum_def);
+        }
+      }
+      for (auto it = parser_.structs_.vec.begin();
+           it != parser_.structs_.vec.end(); ++it) {
+        const auto &struct_def = **it;
+        if (!struct_def.fixed && !struct_def.generated) {
+          SetNameSpace(struct_def.defined_namespace);
+          GenTableEqHash(struct_def);
+        }
+      }
+    }
+
     // Generate convenient global helper functions:
     if (parser_.root_struct_def_) {
       auto &struct_def = *parser_.root_struct_def_;
@@ -471,6 +517,29 @@ class CppGenerator : public BaseGenerator {
            "const flatbuffers::Vector<uint8_t> *types)";
   }
 
+  static std::string UnionEqualsSignature(const EnumDef &enum_def) {
+    return "bool Equals" + enum_def.name +
+           "(const void *lhs, const void *rhs, " + enum_def.name + " type)";
+  }
+
+  static std::string UnionHashSignature(const EnumDef &enum_def) {
+    return "flatbuffers::hash_value_t Hash" + enum_def.name +
+           "(const void *obj, " + enum_def.name +
+           " type, flatbuffers::hash_value_t hash)";
+  }
+
+  static std::string TableEqualsSignature(const StructDef &struct_def) {
+    return "bool Equals(const " + struct_def.name + " *lhs, const " +
+           struct_def.name + " *rhs)";
+  }
+
+  static std::string TableHashSignature(const StructDef &struct_def,
+                                        bool accumulate) {
+    return "flatbuffers::hash_value_t HashOf(const " + struct_def.name +
+           " *obj" + (accumulate ? ", flatbuffers::hash_value_t hash" : "") +
+           ")";
+  }
+
   static std::string UnionUnPackSignature(const EnumDef &enum_def,
                                           bool inclass) {
     return (inclass ? "static " : "") +
@@ -517,6 +586,15 @@ class CppGenerator : public BaseGenerator {
            (inclass ? " = nullptr" : "") + ") const";
   }
 
+  static std::string TableUnPackArenaSignature(const StructDef &struct_def,
+                                               bool inclass) {
+    return NativeName(struct_def.name) + " *" +
+           (inclass ? "" : struct_def.name + "::") +
+           "UnPack(flatbuffers::ObjectArena &_arena, " +
+           "const flatbuffers::resolver_function_t *_resolver" +
+           (inclass ? " = nullptr" : "") + ") const";
+  }
+
   static std::string TableUnPackToSignature(const StructDef &struct_def,
                                             bool inclass) {
     return "void " + (inclass ? "" : struct_def.name + "::") +
@@ -832,6 +910,275 @@ class CppGenerator : public BaseGenerator {
     }
   }
 
+  // Generate buffer-level equality and hashing for a union, switching on the
+  // type to the member table functions. The union type itself is not
+  // compared or mixed here: it always travels in a companion _type field
+  // which the table functions already cover. Like the union verifier this is
+  // safe on a corrupted type value: unknown types simply compare unequal.
+  void GenUnionEqHash(const EnumDef &enum_def) {
+    code_.SetValue("ENUM_NAME", enum_def.name);
+
+    code_ += "inline " + UnionEqualsSignature(enum_def) + " {";
+    code_ += "  if (lhs == rhs) return true;";
+    code_ += "  switch (type) {";
+    for (auto it = enum_def.vals.vec.begin(); it != enum_def.vals.vec.end();
+         ++it) {
+      const auto &ev = **it;
+      if (!ev.value) {
+        continue;  // "NONE": both sides null, handled above.
+      }
+      code_.SetValue("LABEL", GetEnumValUse(enum_def, ev));
+      code_.SetValue("TYPE", WrapInNameSpace(*ev.struct_def));
+      code_ += "    case {{LABEL}}: {";
+      code_ += "      return lhs && rhs &&";
+      code_ += "             Equals(reinterpret_cast<const {{TYPE}} *>(lhs),";
+      code_ += "                    reinterpret_cast<const {{TYPE}} *>(rhs));";
+      code_ += "    }";
+    }
+    code_ += "    default: return false;";
+    code_ += "  }";
+    code_ += "}";
+    code_ += "";
+
+    code_ += "inline " + UnionHashSignature(enum_def) + " {";
+    code_ += "  switch (type) {";
+    for (auto it = enum_def.vals.vec.begin(); it != enum_def.vals.vec.end();
+         ++it) {
+      const auto &ev = **it;
+      if (!ev.value) {
+        continue;
+      }
+      code_.SetValue("LABEL", GetEnumValUse(enum_def, ev));
+      code_.SetValue("TYPE", WrapInNameSpace(*ev.struct_def));
+      code_ += "    case {{LABEL}}: {";
+      code_ += "      auto ptr = reinterpret_cast<const {{TYPE}} *>(obj);";
+      code_ += "      return ptr ? HashOf(ptr, hash) : hash;";
+      code_ += "    }";
+    }
+    code_ += "    default: return hash;";
+    code_ += "  }";
+    code_ += "}";
+    code_ += "";
+  }
+
+  // Generate free functions that compare and hash a table directly over the
+  // buffer bytes, without unpacking (--gen-eq-hash). Scalars go through the
+  // accessors, so an absent field equals (and hashes like) its default;
+  // structs, strings and vectors of inline data use a single memcmp or
+  // FNV-1a pass; only table, string and union indirections recurse. A
+  // union's type always lives in a companion _type field that is compared
+  // and hashed like any other field, which is also what keeps two unions of
+  // different type from reaching the member comparison below.
+  void GenTableEqHash(const StructDef &struct_def) {
+    code_.SetValue("STRUCT_NAME", struct_def.name);
+
+    code_ += "inline " + TableEqualsSignature(struct_def) + " {";
+    code_ += "  if (lhs == rhs) return true;";
+    code_ += "  if (!lhs || !rhs) return false;";
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      const auto &field = **it;
+      if (field.deprecated) {
+        continue;
+      }
+      code_.SetValue("FIELD_NAME", field.name);
+      switch (field.value.type.base_type) {
+        case BASE_TYPE_UNION: {
+          code_.SetValue("ENUM_NAME", field.value.type.enum_def->name);
+          code_.SetValue("SUFFIX", UnionTypeFieldSuffix());
+          code_ += "  if (!Equals{{ENUM_NAME}}(lhs->{{FIELD_NAME}}(), "
+                   "rhs->{{FIELD_NAME}}(), lhs->{{FIELD_NAME}}{{SUFFIX}}())) "
+                   "return false;";
+          break;
+        }
+        case BASE_TYPE_STRUCT: {
+          if (field.value.type.struct_def->fixed) {
+            code_ += "  if (!flatbuffers::EqualsStruct("
+                     "lhs->{{FIELD_NAME}}(), rhs->{{FIELD_NAME}}())) "
+                     "return false;";
+          } else {
+            code_ += "  if (!Equals(lhs->{{FIELD_NAME}}(), "
+                     "rhs->{{FIELD_NAME}}())) return false;";
+          }
+          break;
+        }
+        case BASE_TYPE_STRING: {
+          code_ += "  if (!flatbuffers::EqualsString(lhs->{{FIELD_NAME}}(), "
+                   "rhs->{{FIELD_NAME}}())) return false;";
+          break;
+        }
+        case BASE_TYPE_VECTOR: {
+          switch (field.value.type.element) {
+            case BASE_TYPE_STRING: {
+              code_ += "  if (!flatbuffers::EqualsVectorOfStrings("
+                       "lhs->{{FIELD_NAME}}(), rhs->{{FIELD_NAME}}())) "
+                       "return false;";
+              break;
+            }
+            case BASE_TYPE_STRUCT: {
+              if (field.value.type.struct_def->fixed) {
+                code_ += "  if (!flatbuffers::EqualsVectorOfStructs("
+                         "lhs->{{FIELD_NAME}}(), rhs->{{FIELD_NAME}}())) "
+                         "return false;";
+              } else {
+                code_ += "  {";
+                code_ += "    auto l = lhs->{{FIELD_NAME}}();";
+                code_ += "    auto r = rhs->{{FIELD_NAME}}();";
+                code_ += "    if (l != r) {";
+                code_ += "      if (!l || !r || l->size() != r->size()) "
+                         "return false;";
+                code_ += "      for (flatbuffers::uoffset_t i = 0; "
+                         "i < l->size(); i++) {";
+                code_ += "        if (!Equals(l->Get(i), r->Get(i))) "
+                         "return false;";
+                code_ += "      }";
+                code_ += "    }";
+                code_ += "  }";
+              }
+              break;
+            }
+            case BASE_TYPE_UNION: {
+              code_.SetValue("ENUM_NAME", field.value.type.enum_def->name);
+              code_.SetValue("SUFFIX", UnionTypeFieldSuffix());
+              code_ += "  {";
+              code_ += "    auto l = lhs->{{FIELD_NAME}}();";
+              code_ += "    auto r = rhs->{{FIELD_NAME}}();";
+              code_ += "    if (l != r) {";
+              code_ += "      if (!l || !r || l->size() != r->size()) "
+                       "return false;";
+              code_ += "      auto types = lhs->{{FIELD_NAME}}{{SUFFIX}}();";
+              code_ += "      for (flatbuffers::uoffset_t i = 0; "
+                       "i < l->size(); i++) {";
+              code_ += "        if (!Equals{{ENUM_NAME}}(l->Get(i), "
+                       "r->Get(i), types->GetEnum<{{ENUM_NAME}}>(i))) "
+                       "return false;";
+              code_ += "      }";
+              code_ += "    }";
+              code_ += "  }";
+              break;
+            }
+            default: {
+              code_ += "  if (!flatbuffers::EqualsVectorOfScalars("
+                       "lhs->{{FIELD_NAME}}(), rhs->{{FIELD_NAME}}())) "
+                       "return false;";
+              break;
+            }
+          }
+          break;
+        }
+        default: {
+          // Scalars, including enums and the union companion _type fields.
+          code_ += "  if (lhs->{{FIELD_NAME}}() != rhs->{{FIELD_NAME}}()) "
+                   "return false;";
+          break;
+        }
+      }
+    }
+    code_ += "  return true;";
+    code_ += "}";
+    code_ += "";
+
+    code_ += "inline " + TableHashSignature(struct_def, true) + " {";
+    code_ += "  if (!obj) return hash;";
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      const auto &field = **it;
+      if (field.deprecated) {
+        continue;
+      }
+      code_.SetValue("FIELD_NAME", field.name);
+      switch (field.value.type.base_type) {
+        case BASE_TYPE_UNION: {
+          code_.SetValue("ENUM_NAME", field.value.type.enum_def->name);
+          code_.SetValue("SUFFIX", UnionTypeFieldSuffix());
+          code_ += "  hash = Hash{{ENUM_NAME}}(obj->{{FIELD_NAME}}(), "
+                   "obj->{{FIELD_NAME}}{{SUFFIX}}(), hash);";
+          break;
+        }
+        case BASE_TYPE_STRUCT: {
+          if (field.value.type.struct_def->fixed) {
+            code_ += "  hash = flatbuffers::HashStructFnv1a("
+                     "obj->{{FIELD_NAME}}(), hash);";
+          } else {
+            code_ += "  hash = HashOf(obj->{{FIELD_NAME}}(), hash);";
+          }
+          break;
+        }
+        case BASE_TYPE_STRING: {
+          code_ += "  hash = flatbuffers::HashStringFnv1a("
+                   "obj->{{FIELD_NAME}}(), hash);";
+          break;
+        }
+        case BASE_TYPE_VECTOR: {
+          switch (field.value.type.element) {
+            case BASE_TYPE_STRING: {
+              code_ += "  hash = flatbuffers::HashVectorOfStringsFnv1a("
+                       "obj->{{FIELD_NAME}}(), hash);";
+              break;
+            }
+            case BASE_TYPE_STRUCT: {
+              if (field.value.type.struct_def->fixed) {
+                code_ += "  hash = flatbuffers::HashVectorOfStructsFnv1a("
+                         "obj->{{FIELD_NAME}}(), hash);";
+              } else {
+                code_ += "  {";
+                code_ += "    auto vec = obj->{{FIELD_NAME}}();";
+                code_ += "    hash = flatbuffers::HashScalarFnv1a("
+                         "vec ? vec->size() : 0, hash);";
+                code_ += "    if (vec) {";
+                code_ += "      for (flatbuffers::uoffset_t i = 0; "
+                         "i < vec->size(); i++) {";
+                code_ += "        hash = HashOf(vec->Get(i), hash);";
+                code_ += "      }";
+                code_ += "    }";
+                code_ += "  }";
+              }
+              break;
+            }
+            case BASE_TYPE_UNION: {
+              code_.SetValue("ENUM_NAME", field.value.type.enum_def->name);
+              code_.SetValue("SUFFIX", UnionTypeFieldSuffix());
+              code_ += "  {";
+              code_ += "    auto vec = obj->{{FIELD_NAME}}();";
+              code_ += "    if (vec) {";
+              code_ += "      auto types = obj->{{FIELD_NAME}}{{SUFFIX}}();";
+              code_ += "      for (flatbuffers::uoffset_t i = 0; "
+                       "i < vec->size(); i++) {";
+              code_ += "        hash = Hash{{ENUM_NAME}}(vec->Get(i), "
+                       "types->GetEnum<{{ENUM_NAME}}>(i), hash);";
+              code_ += "      }";
+              code_ += "    }";
+              code_ += "  }";
+              break;
+            }
+            default: {
+              code_ += "  hash = flatbuffers::HashVectorOfScalarsFnv1a("
+                       "obj->{{FIELD_NAME}}(), hash);";
+              break;
+            }
+          }
+          break;
+        }
+        default: {
+          const auto value = "obj->" + field.name + "()";
+          code_ += "  hash = flatbuffers::HashScalarFnv1a(" +
+                   GenUnderlyingCast(field, false, value) + ", hash);";
+          break;
+        }
+      }
+    }
+    code_ += "  return hash;";
+    code_ += "}";
+    code_ += "";
+
+    code_ += "inline " + TableHashSignature(struct_def, false) + " {";
+    code_ += "  return HashOf(obj, "
+             "flatbuffers::FnvTraits<flatbuffers::hash_value_t>"
+             "::kOffsetBasis);";
+    code_ += "}";
+    code_ += "";
+  }
+
   // Generates a value with optionally a cast applied if the field has a
   // different underlying type from its interface type (currently only the
   // case for enums. "from" specify the direction, true meaning from the
@@ -990,13 +1337,24 @@ class CppGenerator : public BaseGenerator {
   }
 
   // Generate the code to call the appropriate Verify function(s) for a field.
-  void GenVerifyCall(const FieldDef &field, const char* prefix) {
+  // With merged_bounds (--gen-fast-verifiers), the per-field inline bounds
+  // check is omitted: the caller has already bounded every inline field with
+  // one FieldExtent/VerifyFieldsExtent range comparison, so only presence
+  // checks for required fields and the checks that chase offsets remain.
+  void GenVerifyCall(const FieldDef &field, const char* prefix,
+                     bool merged_bounds) {
     code_.SetValue("PRE", prefix);
     code_.SetValue("NAME", field.name);
     code_.SetValue("REQUIRED", field.required ? "Required" : "");
     code_.SetValue("SIZE", GenTypeSize(field.value.type));
     code_.SetValue("OFFSET", GenFieldOffsetName(field));
-    code_ += "{{PRE}}VerifyField{{REQUIRED}}<{{SIZE}}>(verifier, {{OFFSET}})\\";
+    if (merged_bounds) {
+      if (field.required) {
+        code_ += "{{PRE}}verifier.Check(CheckField({{OFFSET}}))\\";
+      }
+    } else {
+      code_ += "{{PRE}}VerifyField{{REQUIRED}}<{{SIZE}}>(verifier, {{OFFSET}})\\";
+    }
 
     switch (field.value.type.base_type) {
       case BASE_TYPE_UNION: {
@@ -1246,14 +1604,35 @@ class CppGenerator : public BaseGenerator {
     // Generate a verifier function that can check a buffer from an untrusted
     // source will never cause reads outside the buffer.
     code_ += "  bool Verify(flatbuffers::Verifier &verifier) const {";
-    code_ += "    return VerifyTableStart(verifier)\\";
+    if (parser_.opts.generate_fast_verifiers) {
+      // Specialized form: bound every inline field (scalars, structs and
+      // the offsets themselves) with a single range comparison, then only
+      // chase offsets and check required presence.
+      code_ += "    if (!VerifyTableStart(verifier)) return false;";
+      code_ += "    flatbuffers::uoffset_t extent = 0;";
+      for (auto it = struct_def.fields.vec.begin();
+           it != struct_def.fields.vec.end(); ++it) {
+        const auto &field = **it;
+        if (field.deprecated) {
+          continue;
+        }
+        code_.SetValue("SIZE", GenTypeSize(field.value.type));
+        code_.SetValue("OFFSET", GenFieldOffsetName(field));
+        code_ += "    extent = FieldExtent({{OFFSET}}, sizeof({{SIZE}}), "
+                 "extent);";
+      }
+      code_ += "    return VerifyFieldsExtent(verifier, extent)\\";
+    } else {
+      code_ += "    return VerifyTableStart(verifier)\\";
+    }
     for (auto it = struct_def.fields.vec.begin();
          it != struct_def.fields.vec.end(); ++it) {
       const auto &field = **it;
       if (field.deprecated) {
         continue;
       }
-      GenVerifyCall(field, " &&\n           ");
+      GenVerifyCall(field, " &&\n           ",
+                    parser_.opts.generate_fast_verifiers);
     }
 
     code_ += " &&\n           verifier.EndTable();";
@@ -1262,6 +1641,7 @@ class CppGenerator : public BaseGenerator {
     if (parser_.opts.generate_object_based_api) {
       // Generate the UnPack() pre declaration.
       code_ += "  " + TableUnPackSignature(struct_def, true) + ";";
+      code_ += "  " + TableUnPackArenaSignature(struct_def, true) + ";";
       code_ += "  " + TableUnPackToSignature(struct_def, true) + ";";
       code_ += "  " + TablePackSignature(struct_def, true) + ";";
     }
@@ -1704,6 +2084,15 @@ class CppGenerator : public BaseGenerator {
       code_ += "}";
       code_ += "";
 
+      // Generate the arena-allocating X::UnPack() overload, for callers
+      // that unpack many messages and want to release them wholesale.
+      code_ += "inline " + TableUnPackArenaSignature(struct_def, false) + " {";
+      code_ += "  auto _o = _arena.Make<{{NATIVE_NAME}}>();";
+      code_ += "  UnPackTo(_o, _resolver);";
+      code_ += "  return _o;";
+      code_ += "}";
+      code_ += "";
+
       code_ += "inline " + TableUnPackToSignature(struct_def, false) + " {";
       code_ += "  (void)_o;";
       code_ += "  (void)_resolver;";
@@ -1786,6 +2175,37 @@ class CppGenerator : public BaseGenerator {
       code_ += "}";
       code_ += "";
     }
+
+    if (parser_.opts.generate_column_accessors) {
+      GenColumnAccessors(struct_def);
+    }
+  }
+
+  // Generate columnar bulk-extraction accessors (--gen-columnar) for each
+  // scalar field, of the form:
+  //   void ExtractMonsterHp(const Vector<Offset<Monster>> *, int16_t *);
+  // These read one field across a whole vector of tables into a dense
+  // array, via flatbuffers::ExtractScalarColumn.
+  void GenColumnAccessors(const StructDef &struct_def) {
+    for (auto it = struct_def.fields.vec.begin();
+         it != struct_def.fields.vec.end(); ++it) {
+      auto &field = **it;
+      if (field.deprecated || !IsScalar(field.value.type.base_type)) {
+        continue;
+      }
+      code_.SetValue("FIELD_CAMEL", MakeCamel(field.name));
+      code_.SetValue("STORAGE_TYPE", GenTypeBasic(field.value.type, false));
+      code_.SetValue("OFFSET_NAME", GenFieldOffsetName(field));
+      code_.SetValue("DEFAULT", GenDefaultConstant(field));
+      code_ += "inline void Extract{{STRUCT_NAME}}{{FIELD_CAMEL}}("
+               "const flatbuffers::Vector<flatbuffers::Offset<"
+               "{{STRUCT_NAME}}>> *_vec, {{STORAGE_TYPE}} *_dst) {";
+      code_ += "  flatbuffers::ExtractScalarColumn<{{STRUCT_NAME}}, "
+               "{{STORAGE_TYPE}}>(_vec, {{STRUCT_NAME}}::{{OFFSET_NAME}}, "
+               "static_cast<{{STORAGE_TYPE}}>({{DEFAULT}}), _dst);";
+      code_ += "}";
+      code_ += "";
+    }
   }
 
   static void GenPadding(
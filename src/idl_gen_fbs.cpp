@@ -62,6 +62,7 @@ std::string GenerateFBS(const Parser &parser, const std::string &file_name) {
            ++comp) {
         (*comp) = "_" + (*comp);
       }
+      (*it)->InvalidateQualifiedNameCache();
     }
   }
 
@@ -207,7 +207,11 @@ class GeneralGenerator : public BaseGenerator {
     if (!classcode.length()) return true;
 
     std::string code;
-    code = code + "// " + FlatBuffersGeneratedWarning();
+    // One allocation for the whole file; the declaration boilerplate around
+    // the class code stays well within the slack.
+    code.reserve(classcode.length() + 512);
+    code += "// ";
+    code += FlatBuffersGeneratedWarning();
     std::string namespace_name = FullNamespace(".", ns);
     if (!namespace_name.empty()) {
       code += lang_.namespace_ident + namespace_name + lang_.namespace_begin;
@@ -789,6 +789,7 @@ class GoGenerator : public BaseGenerator {
 
     Namespace& ns = go_namespace_.components.empty() ? *def.defined_namespace : go_namespace_;
     std::string code = "";
+    code.reserve(classcode.length() + 512);  // Space for the imports too.
     BeginFile(LastNamespacePart(ns), needs_imports, &code);
     code += classcode;
     std::string filename =
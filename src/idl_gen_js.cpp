@@ -45,7 +45,11 @@ class JsGenerator : public BaseGenerator {
     generateEnums(&enum_code, &exports_code);
     generateStructs(&struct_code, &exports_code);
 
-    code = code + "// " + FlatBuffersGeneratedWarning();
+    // All the pieces are known by now; assemble them with one allocation.
+    code.reserve(enum_code.length() + struct_code.length() +
+                 exports_code.length() + 1024);
+    code += "// ";
+    code += FlatBuffersGeneratedWarning();
 
     // Generate code for all the namespace declarations.
     GenNamespaces(&code, &exports_code);
@@ -84,6 +84,7 @@ namespace php {
         if (!classcode.length()) return true;
 
         std::string code = "";
+        code.reserve(classcode.length() + 512);  // Space for the imports too.
         BeginFile(FullNamespace("\\", *def.defined_namespace),
                   needs_imports, &code);
         code += classcode;
@@ -652,6 +652,7 @@ class PythonGenerator : public BaseGenerator {
     }
 
     std::string code = "";
+    code.reserve(classcode.length() + 512);  // Space for the imports too.
     BeginFile(LastNamespacePart(*def.defined_namespace), needs_imports, &code);
     code += classcode;
     std::string filename = NamespaceDir(*def.defined_namespace) +
@@ -90,7 +90,9 @@ namespace flatbuffers {
                 if (!classcode.length()) return true;
                 
                 std::string code;
-                code = code + "// " + FlatBuffersGeneratedWarning();
+                code.reserve(classcode.length() + 512);
+                code += "// ";
+                code += FlatBuffersGeneratedWarning();
                 if (needs_includes) code += "import Foundation\nimport FlatBuffers\n\n";
                 code += classcode;
                 auto filename = NamespaceDir(ns) + defname + ".swift";
@@ -470,6 +472,63 @@ namespace flatbuffers {
                 }
             }
             
+            // Returns a Swift expression that reads a scalar straight from "ptr"
+            // at the given byte offset, converting from the buffer's
+            // little-endian representation where the type requires it.
+            std::string GenDirectLoad(const Type &type, const std::string &offset) {
+                auto swift_type = GenTypeBasic(type, false);
+                std::string load = "ptr.load(fromByteOffset: " + offset + ", as: ";
+                switch (type.base_type) {
+                    case BASE_TYPE_BOOL:
+                        return "0 != " + load + "UInt8.self)";
+                    case BASE_TYPE_FLOAT:
+                        return "Float(bitPattern: UInt32(littleEndian: " + load +
+                        "UInt32.self)))";
+                    case BASE_TYPE_DOUBLE:
+                        return "Double(bitPattern: UInt64(littleEndian: " + load +
+                        "UInt64.self)))";
+                    default: {
+                        auto value = load + swift_type + ".self)";
+                        if (SizeOf(type.base_type) > 1) {
+                            value = swift_type + "(littleEndian: " + value + ")";
+                        }
+                        if (IsEnum(type)) {
+                            value = type.enum_def->name + "(rawValue: " + value + ")!";
+                        }
+                        return value;
+                    }
+                }
+            }
+
+            // Generate a pointer-backed companion view for a fixed-layout struct:
+            // fields are read with UnsafeRawPointer loads at compile-time-known
+            // offsets, bypassing the ByteBuffer accessor and bounds-check
+            // overhead on hot read paths.
+            void GenStructDirect(const StructDef &struct_def, std::string *code_ptr) {
+                std::string &code = *code_ptr;
+                code += "  public struct Direct {\n";
+                code += "    public let ptr : UnsafeRawPointer\n";
+                code += "    public init(_ ptr: UnsafeRawPointer) { self.ptr = ptr; }\n";
+                for (auto it = struct_def.fields.vec.begin();
+                     it != struct_def.fields.vec.end(); ++it) {
+                    auto &field = **it;
+                    if (field.deprecated) continue;
+                    auto offset = NumToString(field.value.offset);
+                    code += "    public var " + MakeCamel(field.name, false) + " : ";
+                    if (IsStruct(field.value.type)) {
+                        auto nested = field.value.type.struct_def->name + ".Direct";
+                        code += nested + " { get { return " + nested;
+                        code += "(ptr + " + offset + "); } }\n";
+                    } else {
+                        code += GenTypeNameDest(field.value.type) + " { get { return ";
+                        code += GenDirectLoad(field.value.type, offset) + "; } }\n";
+                    }
+                }
+                code += "  }\n";
+                code += "  public var direct : Direct { get { return ";
+                code += "Direct(__p.bb.unsafeRawPointer + __p.bb_pos); } }\n";
+            }
+
             std::string GenByteBufferLength(const char *bb_name) {
                 std::string bb_len = bb_name;
                 bb_len += ".length";
@@ -763,6 +822,41 @@ namespace flatbuffers {
                                 code += NumToString(field.value.offset);
                                 code += "); }\n";
                     }
+                    // Generate direct-memory companions: struct fields get a
+                    // pointer-backed Direct view and scalar vectors a typed
+                    // UnsafeBufferPointer, so hot read loops skip the
+                    // per-element ByteBuffer overhead.
+                    if (!struct_def.fixed &&
+                        field.value.type.base_type == BASE_TYPE_STRUCT &&
+                        field.value.type.struct_def->fixed) {
+                        auto direct_type = type_name + ".Direct";
+                        code += "  public var " + MakeCamel(field.name, false);
+                        code += "Direct : " + direct_type + "? { get { let o = __p.__offset(";
+                        code += NumToString(field.value.offset);
+                        code += "); if o != 0 { return " + direct_type;
+                        code += "(__p.bb.unsafeRawPointer + __p.bb_pos + o)";
+                        code += " } else { return nil } } }\n";
+                    } else if (field.value.type.base_type == BASE_TYPE_VECTOR &&
+                               IsStruct(field.value.type.VectorType())) {
+                        auto vectortype = field.value.type.VectorType();
+                        auto direct_type = vectortype.struct_def->name + ".Direct";
+                        code += "  public func " + MakeCamel(field.name, false);
+                        code += "Direct(at j: Int) -> " + direct_type + "?";
+                        code += " { let o = __p.__offset(";
+                        code += NumToString(field.value.offset);
+                        code += "); if o != 0 { return " + direct_type;
+                        code += "(__p.bb.unsafeRawPointer + __p.__vector(o) + j * ";
+                        code += NumToString(InlineSize(vectortype));
+                        code += ") } else { return nil } }\n";
+                    } else if (field.value.type.base_type == BASE_TYPE_VECTOR &&
+                               IsScalar(field.value.type.VectorType().base_type)) {
+                        code += "  public func get" + MakeCamel(field.name, true);
+                        code += "BufferPointer() -> UnsafeBufferPointer<";
+                        code += GenTypeBasic(field.value.type.VectorType(), false);
+                        code += ">? { return __p.__vector_as_buffer(";
+                        code += NumToString(field.value.offset);
+                        code += "); }\n";
+                    }
                     // generate object accessors if is nested_flatbuffer
                     auto nested = field.attributes.Lookup("nested_flatbuffer");
                     if (nested) {
@@ -829,6 +923,7 @@ namespace flatbuffers {
                             }
                     }
                 }
+                if (struct_def.fixed) GenStructDirect(struct_def, code_ptr);
                 code += "\n";
                 flatbuffers::FieldDef *key_field = nullptr;
                 if (struct_def.fixed) {
@@ -1006,7 +1101,11 @@ namespace flatbuffers {
                         code += "); }\n";
                     }
                 }
-                if (struct_def.has_key) {
+                // Key-based helpers only apply to tables; a struct with a key
+                // field (used for sorting vectors of structs) has no vtable to
+                // binary-search through, and key_field is only discovered in
+                // the table branch above.
+                if (struct_def.has_key && !struct_def.fixed) {
 
                         code += "\n  public static func ";
                         code += "createMySortedVectorOfTables(_ builder: FlatBufferBuilder, ";
@@ -347,6 +347,9 @@ bool GenerateTextFile(const Parser &parser,
                       const std::string &file_name) {
   if (!parser.builder_.GetSize() || !parser.root_struct_def_) return true;
   std::string text;
+  // JSON runs a few times the size of the binary; reserving up front saves
+  // repeated reallocation of a large string.
+  text.reserve(parser.builder_.GetSize() * 4);
   if (!GenerateText(parser, parser.builder_.GetBufferPointer(), &text)) {
     return false;
   }
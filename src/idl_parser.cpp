@@ -28,6 +28,16 @@
 #include "flatbuffers/idl.h"
 #include "flatbuffers/util.h"
 
+#if defined(__SSE2__) || \
+    (defined(_MSC_VER) && \
+     (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+  #define FLATBUFFERS_LEXER_SSE2 1
+  #include <emmintrin.h>
+  #ifdef _MSC_VER
+    #include <intrin.h>
+  #endif
+#endif
+
 namespace flatbuffers {
 
 const char *const kTypeNames[] = {
@@ -147,16 +157,21 @@ std::string Namespace::GetFullyQualifiedName(const std::string &name,
   if (components.size() == 0 || !max_components) {
     return name;
   }
-  std::stringstream stream;
-  for (size_t i = 0; i < std::min(components.size(), max_components);
-       i++) {
-    if (i) {
-      stream << ".";
+  // Qualified prefixes get rebuilt for every candidate-namespace probe
+  // during name resolution, so they are memoized per component count.
+  auto count = std::min(components.size(), max_components);
+  if (qualified_prefix_cache_.size() < count) {
+    qualified_prefix_cache_.resize(components.size());
+  }
+  auto &prefix = qualified_prefix_cache_[count - 1];
+  if (prefix.empty()) {
+    for (size_t i = 0; i < count; i++) {
+      if (i) prefix += ".";
+      prefix += components[i];
     }
-    stream << components[i];
   }
-  if (name.length()) stream << "." << name;
-  return stream.str();
+  if (!name.length()) return prefix;
+  return prefix + "." + name;
 }
 
 
@@ -244,6 +259,65 @@ bool IsIdentifierStart(char c) {
   return isalpha(static_cast<unsigned char>(c)) || c == '_';
 }
 
+// Compares the token span [start, end) against a keyword, without
+// materializing the token into a std::string first.
+static inline bool TokenIs(const char *start, const char *end,
+                           const char *keyword) {
+  while (start != end && *keyword && *start == *keyword) {
+    start++;
+    keyword++;
+  }
+  return start == end && !*keyword;
+}
+
+// Scans forward from cursor over bytes that can be copied into a string
+// constant verbatim, i.e. anything that is not the closing quote, a
+// backslash or a control character (which includes the '\0' terminator).
+// Returns a pointer to the first byte that needs byte-wise handling, which
+// may be cursor itself if the very next byte is special.
+static const char *ScanStringSpan(const char *cursor, char quote) {
+  #ifdef FLATBUFFERS_LEXER_SSE2
+    // Advance byte-wise up to the next 16 byte boundary. From there on we
+    // can use aligned loads, which never cross a page boundary, so reading
+    // (but not consuming) up to 15 bytes past the terminator is safe.
+    while (reinterpret_cast<uintptr_t>(cursor) & 15) {
+      char ch = *cursor;
+      if ((ch >= 0 && ch < ' ') || ch == quote || ch == '\\') return cursor;
+      cursor++;
+    }
+    auto quotes = _mm_set1_epi8(quote);
+    auto backslashes = _mm_set1_epi8('\\');
+    auto max_control = _mm_set1_epi8(0x1F);
+    for (;;) {
+      auto chunk = _mm_load_si128(reinterpret_cast<const __m128i *>(cursor));
+      // A byte is an (unsigned) control character iff min(byte, 0x1F) == byte.
+      auto is_control =
+          _mm_cmpeq_epi8(_mm_min_epu8(chunk, max_control), chunk);
+      auto is_special = _mm_or_si128(
+          _mm_or_si128(_mm_cmpeq_epi8(chunk, quotes),
+                       _mm_cmpeq_epi8(chunk, backslashes)),
+          is_control);
+      auto mask = _mm_movemask_epi8(is_special);
+      if (mask) {
+        #ifdef _MSC_VER
+          unsigned long first;
+          _BitScanForward(&first, static_cast<unsigned long>(mask));
+          return cursor + first;
+        #else
+          return cursor + __builtin_ctz(static_cast<unsigned>(mask));
+        #endif
+      }
+      cursor += 16;
+    }
+  #else
+    for (;;) {
+      char ch = *cursor;
+      if ((ch >= 0 && ch < ' ') || ch == quote || ch == '\\') return cursor;
+      cursor++;
+    }
+  #endif
+}
+
 CheckedError Parser::Next() {
   doc_comment_.clear();
   bool seen_newline = false;
@@ -265,6 +339,17 @@ CheckedError Parser::Next() {
         int unicode_high_surrogate = -1;
 
         while (*cursor_ != c) {
+          // Bulk-copy the run of bytes (if any) that need no processing.
+          auto span_end = ScanStringSpan(cursor_, c);
+          if (span_end != cursor_) {
+            if (unicode_high_surrogate != -1) {
+              return Error(
+                "illegal Unicode sequence (unpaired high surrogate)");
+            }
+            attribute_.append(cursor_, span_end);
+            cursor_ = span_end;
+            continue;
+          }
           if (*cursor_ < ' ' && *cursor_ >= 0)
             return Error("illegal character in string constant");
           if (*cursor_ == '\\') {
@@ -373,11 +458,17 @@ CheckedError Parser::Next() {
           while (isalnum(static_cast<unsigned char>(*cursor_)) ||
                  *cursor_ == '_')
             cursor_++;
+          // attribute_ keeps its capacity across tokens, so this append is
+          // a copy into reused storage, not an allocation. Keywords are
+          // still matched on the [start, cursor_) span, which skips the
+          // std::string comparison machinery. The spelling must stay
+          // available even for keyword tokens: the proto translator reads
+          // attribute_ to distinguish e.g. "enum" from "union".
           attribute_.append(start, cursor_);
           // First, see if it is a type keyword from the table of types:
           #define FLATBUFFERS_TD(ENUM, IDLTYPE, CTYPE, JTYPE, GTYPE, NTYPE, \
             PTYPE, STYPE) \
-            if (attribute_ == IDLTYPE) { \
+            if (TokenIs(start, cursor_, IDLTYPE)) { \
               token_ = kToken ## ENUM; \
               return NoError(); \
             }
@@ -385,61 +476,62 @@ CheckedError Parser::Next() {
           #undef FLATBUFFERS_TD
           // If it's a boolean constant keyword, turn those into integers,
           // which simplifies our logic downstream.
-          if (attribute_ == "true" || attribute_ == "false") {
-            attribute_ = NumToString(attribute_ == "true");
+          if (TokenIs(start, cursor_, "true") ||
+              TokenIs(start, cursor_, "false")) {
+            attribute_ = NumToString(TokenIs(start, cursor_, "true"));
             token_ = kTokenIntegerConstant;
             return NoError();
           }
           // Check for declaration keywords:
-          if (attribute_ == "table") {
+          if (TokenIs(start, cursor_, "table")) {
             token_ = kTokenTable;
             return NoError();
           }
-          if (attribute_ == "struct") {
+          if (TokenIs(start, cursor_, "struct")) {
             token_ = kTokenStruct;
             return NoError();
           }
-          if (attribute_ == "enum") {
+          if (TokenIs(start, cursor_, "enum")) {
             token_ = kTokenEnum;
             return NoError();
           }
-          if (attribute_ == "union") {
+          if (TokenIs(start, cursor_, "union")) {
             token_ = kTokenUnion;
             return NoError();
           }
-          if (attribute_ == "namespace") {
+          if (TokenIs(start, cursor_, "namespace")) {
             token_ = kTokenNameSpace;
             return NoError();
           }
-          if (attribute_ == "root_type") {
+          if (TokenIs(start, cursor_, "root_type")) {
             token_ = kTokenRootType;
             return NoError();
           }
-          if (attribute_ == "include") {
+          if (TokenIs(start, cursor_, "include")) {
             token_ = kTokenInclude;
             return NoError();
           }
-          if (attribute_ == "attribute") {
+          if (TokenIs(start, cursor_, "attribute")) {
             token_ = kTokenAttribute;
             return NoError();
           }
-          if (attribute_ == "file_identifier") {
+          if (TokenIs(start, cursor_, "file_identifier")) {
             token_ = kTokenFileIdentifier;
             return NoError();
           }
-          if (attribute_ == "file_extension") {
+          if (TokenIs(start, cursor_, "file_extension")) {
             token_ = kTokenFileExtension;
             return NoError();
           }
-          if (attribute_ == "null") {
+          if (TokenIs(start, cursor_, "null")) {
             token_ = kTokenNull;
             return NoError();
           }
-          if (attribute_ == "rpc_service") {
+          if (TokenIs(start, cursor_, "rpc_service")) {
             token_ = kTokenService;
             return NoError();
           }
-          if (attribute_ == "native_include") {
+          if (TokenIs(start, cursor_, "native_include")) {
             token_ = kTokenNativeInclude;
             return NoError();
           }
@@ -836,13 +928,16 @@ CheckedError Parser::ParseTable(const StructDef &struct_def, std::string *value,
   size_t fieldn = 0;
   for (;;) {
     if ((!opts.strict_json || !fieldn) && Is('}')) { NEXT(); break; }
-    std::string name = attribute_;
+    // Resolve the key while attribute_ still holds it; the name is only
+    // materialized into its own string for the unknown-field paths.
+    auto field = struct_def.fields.Lookup(attribute_);
+    std::string name;
+    if (!field) name = attribute_;
     if (Is(kTokenStringConstant)) {
       NEXT();
     } else {
       EXPECT(opts.strict_json ? kTokenStringConstant : kTokenIdentifier);
     }
-    auto field = struct_def.fields.Lookup(name);
     if (!field) {
       if (!opts.skip_unexpected_fields_in_json) {
         return Error("unknown field: " + name);
@@ -1853,8 +1948,81 @@ bool Parser::Parse(const char *source, const char **include_paths,
   return !DoParse(source, include_paths, source_filename).Check();
 }
 
+bool Parser::ParseJson(const char *json) {
+  return !DoParseJson(json).Check();
+}
+
+void Parser::Reset() {
+  builder_.Clear();
+  field_stack_.clear();
+  error_.clear();
+  source_ = cursor_ = nullptr;
+  line_ = 1;
+  token_ = -1;
+  attribute_.clear();
+  doc_comment_.clear();
+}
+
+void Parser::UseSharedSchema(const Parser &schema) {
+  // Only a freshly constructed parser (or one already viewing a schema)
+  // may become a view; it must not own definitions of its own.
+  assert(borrowed_schema_ || structs_.vec.empty());
+  types_.DisownAll();
+  structs_.DisownAll();
+  enums_.DisownAll();
+  services_.DisownAll();
+  if (!borrowed_schema_) {
+    for (auto it = namespaces_.begin(); it != namespaces_.end(); ++it) {
+      delete *it;
+    }
+  }
+  for (auto it = schema.types_.dict.begin();
+       it != schema.types_.dict.end(); ++it) {
+    types_.Add(it->first, it->second);
+  }
+  for (auto it = schema.structs_.dict.begin();
+       it != schema.structs_.dict.end(); ++it) {
+    structs_.Add(it->first, it->second);
+  }
+  for (auto it = schema.enums_.dict.begin();
+       it != schema.enums_.dict.end(); ++it) {
+    enums_.Add(it->first, it->second);
+  }
+  for (auto it = schema.services_.dict.begin();
+       it != schema.services_.dict.end(); ++it) {
+    services_.Add(it->first, it->second);
+  }
+  namespaces_ = schema.namespaces_;
+  root_struct_def_ = schema.root_struct_def_;
+  file_identifier_ = schema.file_identifier_;
+  file_extension_ = schema.file_extension_;
+  opts = schema.opts;
+  Reset();
+  borrowed_schema_ = true;
+}
+
+CheckedError Parser::DoParseJson(const char *json) {
+  if (!root_struct_def_)
+    return Error("no root type set to parse json with");
+  Reset();
+  source_ = cursor_ = json;
+  ECHECK(SkipByteOrderMark());
+  NEXT();
+  if (token_ != '{') return Error("expecting: { instead got: " +
+                                  TokenToStringId(token_));
+  uoffset_t toff;
+  ECHECK(ParseTable(*root_struct_def_, nullptr, &toff));
+  builder_.Finish(Offset<Table>(toff),
+            file_identifier_.length() ? file_identifier_.c_str() : nullptr);
+  EXPECT(kTokenEof);
+  return NoError();
+}
+
 CheckedError Parser::DoParse(const char *source, const char **include_paths,
                              const char *source_filename) {
+  // A parser viewing another parser's schema must not mutate it; see
+  // UseSharedSchema().
+  assert(!borrowed_schema_);
   file_being_parsed_ = source_filename ? source_filename : "";
   if (source_filename &&
       included_files_.find(source_filename) == included_files_.end()) {
@@ -1913,7 +2081,31 @@ CheckedError Parser::DoParse(const char *source, const char **include_paths,
         std::string contents;
         if (!LoadFile(filepath.c_str(), true, &contents))
           return Error("unable to load include file: " + name);
-        ECHECK(DoParse(contents.c_str(), include_paths, filepath.c_str()));
+        bool merged = false;
+        if (opts.use_schema_cache) {
+          auto source_hash = HashFnv1a<uint64_t>(contents.c_str());
+          merged = LoadSchemaCache(filepath, source_hash);
+          if (!merged) {
+            // Parse the include on its own, so the result can be cached as
+            // a self-contained unit, then merge it into this parser.
+            Parser include_parser(opts);
+            if (!include_parser.Parse(contents.c_str(), include_paths,
+                                      filepath.c_str())) {
+              error_ = include_parser.error_;
+              return CheckedError(true);
+            }
+            // Services are not represented in binary schemas; files that
+            // declare them take the uncached path below.
+            if (include_parser.services_.vec.empty()) {
+              if (!MergeInclude(include_parser, filepath))
+                return Error("unable to merge include file: " + name);
+              SaveSchemaCache(include_parser, filepath, source_hash);
+              merged = true;
+            }
+          }
+        }
+        if (!merged)
+          ECHECK(DoParse(contents.c_str(), include_paths, filepath.c_str()));
         // We generally do not want to output code for any included files:
         if (!opts.generate_all) MarkGenerated();
         // This is the easiest way to continue this file after an include:
@@ -2158,6 +2350,593 @@ Offset<reflection::Type> Type::Serialize(FlatBufferBuilder *builder) const {
                                              (enum_def ? enum_def->index : -1));
 }
 
+// Schema deserialization, the reverse of Serialize() above. This rebuilds
+// just enough parser state from a binary schema to drive the JSON parser
+// and text generator, without touching any schema text.
+
+// Splits a fully qualified name as stored in the binary schema and returns
+// the matching (or a freshly created) Namespace owned by namespaces.
+static Namespace *DeserializeNamespace(std::vector<Namespace *> &namespaces,
+                                       const std::string &qualified_name) {
+  std::vector<std::string> components;
+  for (size_t pos = 0;;) {
+    auto dot = qualified_name.find('.', pos);
+    if (dot == std::string::npos) break;
+    components.push_back(qualified_name.substr(pos, dot - pos));
+    pos = dot + 1;
+  }
+  for (auto it = namespaces.begin(); it != namespaces.end(); ++it) {
+    if ((*it)->components == components) return *it;
+  }
+  auto ns = new Namespace();
+  ns->components = components;
+  namespaces.push_back(ns);
+  return ns;
+}
+
+static std::string UnqualifiedName(const std::string &qualified_name) {
+  auto dot = qualified_name.find_last_of('.');
+  return dot == std::string::npos ? qualified_name
+                                  : qualified_name.substr(dot + 1);
+}
+
+// The index in a serialized Type refers into the (name-sorted) objects or
+// enums vector, which matches the order of structs/enums below, see
+// AssignIndices() and CreateVectorOfSortedTables() in Serialize().
+static Type DeserializeType(const reflection::Type *type,
+                            const std::vector<StructDef *> &structs,
+                            const std::vector<EnumDef *> &enums) {
+  Type t;
+  if (!type) return t;
+  t.base_type = static_cast<BaseType>(type->base_type());
+  t.element = static_cast<BaseType>(type->element());
+  auto index = type->index();
+  if (index >= 0) {
+    auto effective = t.base_type == BASE_TYPE_VECTOR ? t.element : t.base_type;
+    if (effective == BASE_TYPE_STRUCT) {
+      t.struct_def = structs[index];
+    } else {
+      t.enum_def = enums[index];
+    }
+  }
+  return t;
+}
+
+void Parser::DeserializeAttributes(
+    Definition *def,
+    const Vector<Offset<reflection::KeyValue>> *attrs) {
+  if (!attrs) return;
+  for (auto it = attrs->begin(); it != attrs->end(); ++it) {
+    auto key = it->key()->str();
+    auto value = new Value();
+    if (it->value()) value->constant = it->value()->str();
+    def->attributes.Add(key, value);
+    // Serialized attributes are by definition custom ones.
+    if (known_attributes_.find(key) == known_attributes_.end())
+      known_attributes_[key] = false;
+  }
+}
+
+bool Parser::Deserialize(const uint8_t *buf, size_t size) {
+  flatbuffers::Verifier verifier(buf, size);
+  if (!reflection::VerifySchemaBuffer(verifier)) return false;
+  auto schema = reflection::GetSchema(buf);
+  // First create all definitions, so type references between them resolve.
+  // Definitions that already exist under the same qualified name are reused
+  // rather than recreated, so schemas with overlapping contents (e.g.
+  // cached includes sharing a sub-include) can be merged into one Parser.
+  std::vector<StructDef *> structs;
+  std::vector<bool> new_structs;
+  for (auto it = schema->objects()->begin();
+       it != schema->objects()->end(); ++it) {
+    auto qualified_name = it->name()->str();
+    auto struct_def = structs_.Lookup(qualified_name);
+    new_structs.push_back(struct_def == nullptr);
+    if (!struct_def) {
+      struct_def = new StructDef();
+      struct_def->name = UnqualifiedName(qualified_name);
+      struct_def->defined_namespace =
+          DeserializeNamespace(namespaces_, qualified_name);
+      struct_def->fixed = it->is_struct();
+      struct_def->minalign = static_cast<size_t>(it->minalign());
+      struct_def->bytesize = static_cast<size_t>(it->bytesize());
+      struct_def->predecl = false;
+      // Structs must be written in declaration order; see ParseTable().
+      struct_def->sortbysize = !struct_def->fixed;
+      structs_.Add(qualified_name, struct_def);
+    }
+    structs.push_back(struct_def);
+  }
+  std::vector<EnumDef *> enums;
+  std::vector<bool> new_enums;
+  for (auto it = schema->enums()->begin(); it != schema->enums()->end(); ++it) {
+    auto qualified_name = it->name()->str();
+    auto enum_def = enums_.Lookup(qualified_name);
+    new_enums.push_back(enum_def == nullptr);
+    if (!enum_def) {
+      enum_def = new EnumDef();
+      enum_def->name = UnqualifiedName(qualified_name);
+      enum_def->defined_namespace =
+          DeserializeNamespace(namespaces_, qualified_name);
+      enum_def->is_union = it->is_union();
+      enums_.Add(qualified_name, enum_def);
+    }
+    enums.push_back(enum_def);
+  }
+  // Now fill in fields and values, resolving types against the above.
+  for (auto it = schema->objects()->begin();
+       it != schema->objects()->end(); ++it) {
+    if (!new_structs[it - schema->objects()->begin()]) continue;
+    auto struct_def = structs[it - schema->objects()->begin()];
+    // The fields vector is sorted by name; recover declaration order via id.
+    std::vector<const reflection::Field *> fields(it->fields()->size());
+    for (auto field_it = it->fields()->begin();
+         field_it != it->fields()->end(); ++field_it) {
+      fields[field_it->id()] = *field_it;
+    }
+    for (auto field_it = fields.begin(); field_it != fields.end(); ++field_it) {
+      auto field = *field_it;
+      auto field_def = new FieldDef();
+      field_def->name = field->name()->str();
+      field_def->value.type = DeserializeType(field->type(), structs, enums);
+      field_def->value.offset = static_cast<voffset_t>(field->offset());
+      if (IsInteger(field_def->value.type.base_type)) {
+        field_def->value.constant = NumToString(field->default_integer());
+      } else if (IsFloat(field_def->value.type.base_type)) {
+        field_def->value.constant = NumToString(field->default_real());
+      }
+      field_def->deprecated = field->deprecated();
+      field_def->required = field->required();
+      field_def->key = field->key();
+      if (field_def->key) struct_def->has_key = true;
+      DeserializeAttributes(field_def, field->attributes());
+      if (struct_def->fields.Add(field_def->name, field_def)) return false;
+    }
+    if (struct_def->fixed) {
+      // Padding is not serialized; recover it from the field offsets, the
+      // same way AddField()/PadLastField() assigned it.
+      for (size_t i = 0; i < fields.size(); i++) {
+        auto field_def = struct_def->fields.vec[i];
+        auto end = field_def->value.offset + InlineSize(field_def->value.type);
+        auto next = i + 1 < fields.size()
+                        ? struct_def->fields.vec[i + 1]->value.offset
+                        : struct_def->bytesize;
+        field_def->padding = next - end;
+      }
+    }
+    DeserializeAttributes(struct_def, it->attributes());
+  }
+  for (auto it = schema->enums()->begin(); it != schema->enums()->end(); ++it) {
+    if (!new_enums[it - schema->enums()->begin()]) continue;
+    auto enum_def = enums[it - schema->enums()->begin()];
+    enum_def->underlying_type =
+        DeserializeType(it->underlying_type(), structs, enums);
+    for (auto val_it = it->values()->begin(); val_it != it->values()->end();
+         ++val_it) {
+      auto enum_val = new EnumVal(val_it->name()->str(), val_it->value());
+      if (val_it->object()) {
+        enum_val->struct_def = structs_.Lookup(val_it->object()->name()->str());
+      }
+      if (enum_def->vals.Add(enum_val->name, enum_val)) return false;
+    }
+    DeserializeAttributes(enum_def, it->attributes());
+  }
+  if (file_identifier_.empty() && schema->file_ident())
+    file_identifier_ = schema->file_ident()->str();
+  if (file_extension_.empty() && schema->file_ext())
+    file_extension_ = schema->file_ext()->str();
+  if (!root_struct_def_ && schema->root_table())
+    root_struct_def_ = structs_.Lookup(schema->root_table()->name()->str());
+  return true;
+}
+
+// Compiled schema cache. flatc spends most of its startup re-lexing the same
+// include files on every invocation; with opts.use_schema_cache, each include
+// is parsed once and saved next to it as <file>.bfbsc: a binary schema plus
+// the attribute/doc-comment sidecar and include bookkeeping that binary
+// schemas do not carry. Later runs load the artifact instead of the text,
+// after checking that neither the file nor any of its transitive includes
+// changed (content hashes); any mismatch falls back to a normal parse.
+
+static const char kSchemaCacheIdent[4] = { 'B', 'F', 'S', 'C' };
+static const uint32_t kSchemaCacheVersion = 1;
+
+// The cache artifact uses explicit little-endian scalars with bounds checks,
+// so a truncated or foreign file simply reads as a cache miss.
+static void CachePushScalar(std::string *buf, uint64_t val, size_t bytes) {
+  for (size_t i = 0; i < bytes; i++)
+    buf->push_back(static_cast<char>((val >> (i * 8)) & 0xFF));
+}
+
+static void CachePushString(std::string *buf, const std::string &s) {
+  CachePushScalar(buf, s.size(), 4);
+  buf->append(s);
+}
+
+static bool CacheReadScalar(const std::string &buf, size_t *pos, size_t bytes,
+                            uint64_t *val) {
+  if (*pos + bytes > buf.size()) return false;
+  *val = 0;
+  for (size_t i = 0; i < bytes; i++)
+    *val |= static_cast<uint64_t>(static_cast<uint8_t>(buf[*pos + i]))
+            << (i * 8);
+  *pos += bytes;
+  return true;
+}
+
+static bool CacheReadString(const std::string &buf, size_t *pos,
+                            std::string *s) {
+  uint64_t len;
+  if (!CacheReadScalar(buf, pos, 4, &len)) return false;
+  if (*pos + len > buf.size()) return false;
+  s->assign(buf, *pos, static_cast<size_t>(len));
+  *pos += static_cast<size_t>(len);
+  return true;
+}
+
+// Attributes and doc comments for one definition. Binary schemas store only
+// custom attributes (see SerializeAttributes), but known attributes like
+// "hash" or "nested_flatbuffer" are consumed after parsing, by the JSON
+// parser and the code generators, so the cache has to carry all of them.
+static void CachePushMeta(std::string *buf, const Definition &def) {
+  CachePushScalar(buf, def.attributes.dict.size(), 4);
+  for (auto kv = def.attributes.dict.begin(); kv != def.attributes.dict.end();
+       ++kv) {
+    CachePushString(buf, kv->first);
+    CachePushScalar(buf, static_cast<uint64_t>(kv->second->type.base_type), 1);
+    CachePushString(buf, kv->second->constant);
+  }
+  CachePushScalar(buf, def.doc_comment.size(), 4);
+  for (auto it = def.doc_comment.begin(); it != def.doc_comment.end(); ++it)
+    CachePushString(buf, *it);
+}
+
+// Reads what CachePushMeta wrote. With def == nullptr this just validates
+// the encoding, so a whole artifact can be checked before any parser state
+// is mutated.
+static bool CacheReadMeta(const std::string &buf, size_t *pos, Parser *parser,
+                          Definition *def) {
+  uint64_t num_attrs;
+  if (!CacheReadScalar(buf, pos, 4, &num_attrs)) return false;
+  for (uint64_t i = 0; i < num_attrs; i++) {
+    std::string key, constant;
+    uint64_t base_type;
+    if (!CacheReadString(buf, pos, &key) ||
+        !CacheReadScalar(buf, pos, 1, &base_type) ||
+        !CacheReadString(buf, pos, &constant))
+      return false;
+    if (def) {
+      auto value = def->attributes.Lookup(key);
+      if (!value) {
+        value = new Value();
+        def->attributes.Add(key, value);
+      }
+      value->type = Type(static_cast<BaseType>(base_type));
+      value->constant = constant;
+      if (parser->known_attributes_.find(key) ==
+          parser->known_attributes_.end())
+        parser->known_attributes_[key] = false;
+    }
+  }
+  uint64_t num_doc;
+  if (!CacheReadScalar(buf, pos, 4, &num_doc)) return false;
+  // Replace rather than append: a definition may already carry these lines
+  // if it came in earlier via a shared sub-include.
+  if (def) def->doc_comment.clear();
+  for (uint64_t i = 0; i < num_doc; i++) {
+    std::string line;
+    if (!CacheReadString(buf, pos, &line)) return false;
+    if (def) def->doc_comment.push_back(line);
+  }
+  return true;
+}
+
+static void CopyMeta(const Definition &src, Definition *dest) {
+  dest->doc_comment = src.doc_comment;
+  for (auto kv = src.attributes.dict.begin(); kv != src.attributes.dict.end();
+       ++kv) {
+    auto value = dest->attributes.Lookup(kv->first);
+    if (!value) {
+      value = new Value();
+      dest->attributes.Add(kv->first, value);
+    }
+    // Attribute values are scalars or strings, so the type carries no
+    // definition pointers into src's parser.
+    value->type = Type(kv->second->type.base_type);
+    value->constant = kv->second->constant;
+  }
+}
+
+// Folds a separately parsed include file into this parser: the definitions
+// via Serialize()/Deserialize() (which resolves overlapping sub-includes by
+// qualified name), then everything a binary schema does not carry.
+bool Parser::MergeInclude(Parser &include_parser,
+                          const std::string &filepath) {
+  include_parser.Serialize();
+  if (!Deserialize(include_parser.builder_.GetBufferPointer(),
+                   include_parser.builder_.GetSize()))
+    return false;
+  for (auto it = include_parser.structs_.vec.begin();
+       it != include_parser.structs_.vec.end(); ++it) {
+    auto &src = **it;
+    auto dest = structs_.Lookup(
+        src.defined_namespace->GetFullyQualifiedName(src.name));
+    if (!dest) return false;
+    CopyMeta(src, dest);
+    for (auto field_it = src.fields.vec.begin();
+         field_it != src.fields.vec.end(); ++field_it) {
+      auto dest_field = dest->fields.Lookup((*field_it)->name);
+      if (!dest_field) return false;
+      CopyMeta(**field_it, dest_field);
+    }
+  }
+  for (auto it = include_parser.enums_.vec.begin();
+       it != include_parser.enums_.vec.end(); ++it) {
+    auto &src = **it;
+    auto dest = enums_.Lookup(
+        src.defined_namespace->GetFullyQualifiedName(src.name));
+    if (!dest) return false;
+    CopyMeta(src, dest);
+    for (auto val_it = src.vals.vec.begin(); val_it != src.vals.vec.end();
+         ++val_it) {
+      auto dest_val = dest->vals.Lookup((*val_it)->name);
+      if (!dest_val) return false;
+      dest_val->doc_comment = (*val_it)->doc_comment;
+    }
+  }
+  // Custom attribute declarations become available to including files even
+  // when the include itself never uses them.
+  for (auto it = include_parser.known_attributes_.begin();
+       it != include_parser.known_attributes_.end(); ++it) {
+    if (known_attributes_.find(it->first) == known_attributes_.end())
+      known_attributes_[it->first] = it->second;
+  }
+  for (auto it = include_parser.included_files_.begin();
+       it != include_parser.included_files_.end(); ++it) {
+    included_files_[it->first] = it->second;
+  }
+  for (auto it = include_parser.files_included_per_file_.begin();
+       it != include_parser.files_included_per_file_.end(); ++it) {
+    files_included_per_file_[it->first].insert(it->second.begin(),
+                                               it->second.end());
+  }
+  native_included_files_.insert(native_included_files_.end(),
+                                include_parser.native_included_files_.begin(),
+                                include_parser.native_included_files_.end());
+  included_files_[filepath] = true;
+  return true;
+}
+
+void Parser::SaveSchemaCache(Parser &include_parser,
+                             const std::string &filepath,
+                             uint64_t source_hash) {
+  std::string buf;
+  buf.append(kSchemaCacheIdent, sizeof(kSchemaCacheIdent));
+  CachePushScalar(&buf, kSchemaCacheVersion, 4);
+  CachePushScalar(&buf, source_hash, 8);
+  // Transitive includes with their content hashes, so the artifact can be
+  // rejected when any file underneath it changes.
+  std::string includes;
+  uint64_t num_includes = 0;
+  for (auto it = include_parser.included_files_.begin();
+       it != include_parser.included_files_.end(); ++it) {
+    if (it->first == filepath) continue;
+    std::string contents;
+    if (!LoadFile(it->first.c_str(), true, &contents)) return;  // Don't cache.
+    CachePushString(&includes, it->first);
+    CachePushScalar(&includes, HashFnv1a<uint64_t>(contents.c_str()), 8);
+    num_includes++;
+  }
+  CachePushScalar(&buf, num_includes, 4);
+  buf += includes;
+  // The include graph, for GetIncludedFilesRecursive() / make rules.
+  CachePushScalar(&buf, include_parser.files_included_per_file_.size(), 4);
+  for (auto it = include_parser.files_included_per_file_.begin();
+       it != include_parser.files_included_per_file_.end(); ++it) {
+    CachePushString(&buf, it->first);
+    CachePushScalar(&buf, it->second.size(), 4);
+    for (auto f = it->second.begin(); f != it->second.end(); ++f)
+      CachePushString(&buf, *f);
+  }
+  // Custom attribute declarations (possibly unused in the include itself).
+  std::string customs;
+  uint64_t num_customs = 0;
+  for (auto it = include_parser.known_attributes_.begin();
+       it != include_parser.known_attributes_.end(); ++it) {
+    if (it->second) continue;
+    CachePushString(&customs, it->first);
+    num_customs++;
+  }
+  CachePushScalar(&buf, num_customs, 4);
+  buf += customs;
+  // The schema itself, followed by the attribute/doc-comment sidecar.
+  include_parser.Serialize();
+  CachePushString(&buf,
+                  std::string(reinterpret_cast<const char *>(
+                                  include_parser.builder_.GetBufferPointer()),
+                              include_parser.builder_.GetSize()));
+  CachePushScalar(&buf, include_parser.structs_.vec.size(), 4);
+  for (auto it = include_parser.structs_.vec.begin();
+       it != include_parser.structs_.vec.end(); ++it) {
+    auto &struct_def = **it;
+    CachePushString(&buf, struct_def.defined_namespace->GetFullyQualifiedName(
+                              struct_def.name));
+    CachePushMeta(&buf, struct_def);
+    CachePushScalar(&buf, struct_def.fields.vec.size(), 4);
+    for (auto field_it = struct_def.fields.vec.begin();
+         field_it != struct_def.fields.vec.end(); ++field_it) {
+      CachePushString(&buf, (*field_it)->name);
+      CachePushMeta(&buf, **field_it);
+    }
+  }
+  CachePushScalar(&buf, include_parser.enums_.vec.size(), 4);
+  for (auto it = include_parser.enums_.vec.begin();
+       it != include_parser.enums_.vec.end(); ++it) {
+    auto &enum_def = **it;
+    CachePushString(
+        &buf, enum_def.defined_namespace->GetFullyQualifiedName(enum_def.name));
+    CachePushMeta(&buf, enum_def);
+    CachePushScalar(&buf, enum_def.vals.vec.size(), 4);
+    for (auto val_it = enum_def.vals.vec.begin();
+         val_it != enum_def.vals.vec.end(); ++val_it) {
+      CachePushString(&buf, (*val_it)->name);
+      CachePushScalar(&buf, (*val_it)->doc_comment.size(), 4);
+      for (auto line = (*val_it)->doc_comment.begin();
+           line != (*val_it)->doc_comment.end(); ++line)
+        CachePushString(&buf, *line);
+    }
+  }
+  // Failing to write is not an error, just a missed optimization.
+  SaveFile((filepath + ".bfbsc").c_str(), buf, true);
+}
+
+bool Parser::LoadSchemaCache(const std::string &filepath,
+                             uint64_t source_hash) {
+  std::string buf;
+  if (!LoadFile((filepath + ".bfbsc").c_str(), true, &buf)) return false;
+  size_t pos = 0;
+  if (buf.size() < sizeof(kSchemaCacheIdent) ||
+      memcmp(buf.data(), kSchemaCacheIdent, sizeof(kSchemaCacheIdent)) != 0)
+    return false;
+  pos += sizeof(kSchemaCacheIdent);
+  uint64_t version, stored_hash;
+  if (!CacheReadScalar(buf, &pos, 4, &version) ||
+      version != kSchemaCacheVersion)
+    return false;
+  if (!CacheReadScalar(buf, &pos, 8, &stored_hash) ||
+      stored_hash != source_hash)
+    return false;
+  // Verify every transitive include is still bit-identical to what the
+  // artifact was built from, before touching any parser state.
+  uint64_t num_includes;
+  if (!CacheReadScalar(buf, &pos, 4, &num_includes)) return false;
+  std::vector<std::string> include_files;
+  for (uint64_t i = 0; i < num_includes; i++) {
+    std::string path, contents;
+    uint64_t include_hash;
+    if (!CacheReadString(buf, &pos, &path) ||
+        !CacheReadScalar(buf, &pos, 8, &include_hash))
+      return false;
+    if (!LoadFile(path.c_str(), true, &contents) ||
+        HashFnv1a<uint64_t>(contents.c_str()) != include_hash)
+      return false;
+    include_files.push_back(path);
+  }
+  uint64_t num_included_per_file;
+  if (!CacheReadScalar(buf, &pos, 4, &num_included_per_file)) return false;
+  std::map<std::string, std::set<std::string>> included_per_file;
+  for (uint64_t i = 0; i < num_included_per_file; i++) {
+    std::string file;
+    uint64_t num_files;
+    if (!CacheReadString(buf, &pos, &file) ||
+        !CacheReadScalar(buf, &pos, 4, &num_files))
+      return false;
+    auto &files = included_per_file[file];
+    for (uint64_t j = 0; j < num_files; j++) {
+      std::string included;
+      if (!CacheReadString(buf, &pos, &included)) return false;
+      files.insert(included);
+    }
+  }
+  uint64_t num_customs;
+  if (!CacheReadScalar(buf, &pos, 4, &num_customs)) return false;
+  std::vector<std::string> customs;
+  for (uint64_t i = 0; i < num_customs; i++) {
+    std::string key;
+    if (!CacheReadString(buf, &pos, &key)) return false;
+    customs.push_back(key);
+  }
+  std::string schema;
+  if (!CacheReadString(buf, &pos, &schema)) return false;
+  // Dry-run the sidecar so a truncated artifact is rejected up front.
+  {
+    auto check_pos = pos;
+    for (int pass = 0; pass < 2; pass++) {
+      uint64_t num_defs;
+      if (!CacheReadScalar(buf, &check_pos, 4, &num_defs)) return false;
+      for (uint64_t i = 0; i < num_defs; i++) {
+        std::string ignored;
+        if (!CacheReadString(buf, &check_pos, &ignored)) return false;
+        if (!CacheReadMeta(buf, &check_pos, this, nullptr)) return false;
+        uint64_t num_members;
+        if (!CacheReadScalar(buf, &check_pos, 4, &num_members)) return false;
+        for (uint64_t j = 0; j < num_members; j++) {
+          if (!CacheReadString(buf, &check_pos, &ignored)) return false;
+          if (pass == 0) {  // Struct fields carry full meta blocks.
+            if (!CacheReadMeta(buf, &check_pos, this, nullptr)) return false;
+          } else {  // Enum values carry doc comments only.
+            uint64_t num_doc;
+            if (!CacheReadScalar(buf, &check_pos, 4, &num_doc)) return false;
+            for (uint64_t k = 0; k < num_doc; k++)
+              if (!CacheReadString(buf, &check_pos, &ignored)) return false;
+          }
+        }
+      }
+    }
+    if (check_pos != buf.size()) return false;
+  }
+  if (!Deserialize(reinterpret_cast<const uint8_t *>(schema.data()),
+                   schema.size()))
+    return false;
+  uint64_t num_structs;
+  if (!CacheReadScalar(buf, &pos, 4, &num_structs)) return false;
+  for (uint64_t i = 0; i < num_structs; i++) {
+    std::string qualified_name;
+    if (!CacheReadString(buf, &pos, &qualified_name)) return false;
+    auto struct_def = structs_.Lookup(qualified_name);
+    if (!struct_def) return false;
+    if (!CacheReadMeta(buf, &pos, this, struct_def)) return false;
+    uint64_t num_fields;
+    if (!CacheReadScalar(buf, &pos, 4, &num_fields)) return false;
+    for (uint64_t j = 0; j < num_fields; j++) {
+      std::string field_name;
+      if (!CacheReadString(buf, &pos, &field_name)) return false;
+      auto field_def = struct_def->fields.Lookup(field_name);
+      if (!field_def) return false;
+      if (!CacheReadMeta(buf, &pos, this, field_def)) return false;
+    }
+  }
+  uint64_t num_enums;
+  if (!CacheReadScalar(buf, &pos, 4, &num_enums)) return false;
+  for (uint64_t i = 0; i < num_enums; i++) {
+    std::string qualified_name;
+    if (!CacheReadString(buf, &pos, &qualified_name)) return false;
+    auto enum_def = enums_.Lookup(qualified_name);
+    if (!enum_def) return false;
+    if (!CacheReadMeta(buf, &pos, this, enum_def)) return false;
+    uint64_t num_vals;
+    if (!CacheReadScalar(buf, &pos, 4, &num_vals)) return false;
+    for (uint64_t j = 0; j < num_vals; j++) {
+      std::string val_name;
+      if (!CacheReadString(buf, &pos, &val_name)) return false;
+      auto enum_val = enum_def->vals.Lookup(val_name);
+      if (!enum_val) return false;
+      uint64_t num_doc;
+      if (!CacheReadScalar(buf, &pos, 4, &num_doc)) return false;
+      enum_val->doc_comment.clear();
+      for (uint64_t k = 0; k < num_doc; k++) {
+        std::string line;
+        if (!CacheReadString(buf, &pos, &line)) return false;
+        enum_val->doc_comment.push_back(line);
+      }
+    }
+  }
+  for (auto it = customs.begin(); it != customs.end(); ++it) {
+    if (known_attributes_.find(*it) == known_attributes_.end())
+      known_attributes_[*it] = false;
+  }
+  for (auto it = included_per_file.begin(); it != included_per_file.end();
+       ++it) {
+    files_included_per_file_[it->first].insert(it->second.begin(),
+                                               it->second.end());
+  }
+  for (auto it = include_files.begin(); it != include_files.end(); ++it) {
+    included_files_[*it] = true;
+  }
+  included_files_[filepath] = true;
+  return true;
+}
+
 flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<
   reflection::KeyValue>>>
     Definition::SerializeAttributes(FlatBufferBuilder *builder,
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 
+#include <set>
+
+#include "flatbuffers/hash.h"
 #include "flatbuffers/reflection.h"
 #include "flatbuffers/util.h"
 
@@ -108,6 +111,53 @@ std::string GetAnyValueS(reflection::BaseType type, const uint8_t *data,
   }
 }
 
+FieldAccessPlan::FieldAccessPlan(
+    const reflection::Object &object,
+    const std::vector<const reflection::Field *> &fields) {
+  (void)object;
+  entries_.reserve(fields.size());
+  for (auto it = fields.begin(); it != fields.end(); ++it) {
+    auto &field = **it;
+    Entry entry;
+    entry.offset = field.offset();
+    entry.base_type = static_cast<uint8_t>(field.type()->base_type());
+    entry.size = static_cast<uint8_t>(
+        GetTypeSize(field.type()->base_type()));
+    entry.default_i = field.default_integer();
+    entry.default_f = field.default_real();
+    entries_.push_back(entry);
+  }
+}
+
+void FieldAccessPlan::ExtractI(const Table &table, int64_t *dst) const {
+  for (size_t i = 0; i < entries_.size(); i++) {
+    auto &entry = entries_[i];
+    auto field_ptr = table.GetAddressOf(entry.offset);
+    dst[i] = field_ptr
+        ? GetAnyValueI(static_cast<reflection::BaseType>(entry.base_type),
+                       field_ptr)
+        : entry.default_i;
+  }
+}
+
+void FieldAccessPlan::ExtractF(const Table &table, double *dst) const {
+  for (size_t i = 0; i < entries_.size(); i++) {
+    auto &entry = entries_[i];
+    auto field_ptr = table.GetAddressOf(entry.offset);
+    dst[i] = field_ptr
+        ? GetAnyValueF(static_cast<reflection::BaseType>(entry.base_type),
+                       field_ptr)
+        : entry.default_f;
+  }
+}
+
+void FieldAccessPlan::ExtractAddressOf(const Table &table,
+                                       const uint8_t **dst) const {
+  for (size_t i = 0; i < entries_.size(); i++) {
+    dst[i] = table.GetAddressOf(entries_[i].offset);
+  }
+}
+
 void SetAnyValueI(reflection::BaseType type, uint8_t *data, int64_t val) {
 # define FLATBUFFERS_SET(T) WriteScalar(data, static_cast<T>(val))
   switch (type) {
@@ -159,32 +209,43 @@ void SetAnyValueS(reflection::BaseType type, uint8_t *data, const char *val) {
 // pass in your root_table type as well.
 class ResizeContext {
  public:
+  // A single resize operation: insert (delta > 0) or remove (delta < 0)
+  // bytes at "start".
+  struct Op {
+    uoffset_t start;
+    int delta;
+  };
+
   ResizeContext(const reflection::Schema &schema, uoffset_t start, int delta,
                 std::vector<uint8_t> *flatbuf,
                 const reflection::Object *root_table = nullptr)
-     : schema_(schema), startptr_(flatbuf->data() + start),
-       delta_(delta), buf_(*flatbuf),
+     : schema_(schema), buf_(*flatbuf),
        dag_check_(flatbuf->size() / sizeof(uoffset_t), false) {
-    auto mask = static_cast<int>(sizeof(largest_scalar_t) - 1);
-    delta_ = (delta_ + mask) & ~mask;
-    if (!delta_) return;  // We can't shrink by less than largest_scalar_t.
-    // Now change all the offsets by delta_.
-    auto root = GetAnyRoot(buf_.data());
-    Straddle<uoffset_t, 1>(buf_.data(), root, buf_.data());
-    ResizeTable(root_table ? *root_table : *schema.root_table(), root);
-    // We can now add or remove bytes at start.
-    if (delta_ > 0) buf_.insert(buf_.begin() + start, delta_, 0);
-    else buf_.erase(buf_.begin() + start, buf_.begin() + start - delta_);
+    Op op;
+    op.start = start;
+    op.delta = delta;
+    Init(std::vector<Op>(1, op), root_table);
+  }
+
+  // Apply several resize operations in one fixup pass over the buffer.
+  // The operations' ranges must not overlap.
+  ResizeContext(const reflection::Schema &schema, const std::vector<Op> &ops,
+                std::vector<uint8_t> *flatbuf,
+                const reflection::Object *root_table = nullptr)
+     : schema_(schema), buf_(*flatbuf),
+       dag_check_(flatbuf->size() / sizeof(uoffset_t), false) {
+    Init(ops, root_table);
   }
 
   // Check if the range between first (lower address) and second straddles
-  // the insertion point. If it does, change the offset at offsetloc (of
-  // type T, with direction D).
+  // any insertion point. If it does, change the offset at offsetloc (of
+  // type T, with direction D) by the sum of the straddled deltas.
   template<typename T, int D> void Straddle(const void *first,
                                             const void *second,
                                             void *offsetloc) {
-    if (first <= startptr_ && second >= startptr_) {
-      WriteScalar<T>(offsetloc, ReadScalar<T>(offsetloc) + delta_ * D);
+    auto delta = DeltaForRange(first, second);
+    if (delta) {
+      WriteScalar<T>(offsetloc, ReadScalar<T>(offsetloc) + delta * D);
       DagCheck(offsetloc) = true;
     }
   }
@@ -206,9 +267,9 @@ class ResizeContext {
       return;  // Table already visited.
     auto vtable = table->GetVTable();
     // Early out: since all fields inside the table must point forwards in
-    // memory, if the insertion point is before the table we can stop here.
+    // memory, if all insertion points are before the table we can stop here.
     auto tableloc = reinterpret_cast<uint8_t *>(table);
-    if (startptr_ <= tableloc) {
+    if (startptrs_.back() <= tableloc) {
       // Check if insertion point is between the table and a vtable that
       // precedes it. This can't happen in current construction code, but check
       // just in case we ever change the way flatbuffers are built.
@@ -281,9 +342,59 @@ class ResizeContext {
   void operator=(const ResizeContext &rc);
 
  private:
+  void Init(std::vector<Op> ops, const reflection::Object *root_table) {
+    // Round all deltas to scalar alignment (we can't resize by less than
+    // largest_scalar_t), and drop the resulting no-ops.
+    auto mask = static_cast<int>(sizeof(largest_scalar_t) - 1);
+    for (auto it = ops.begin(); it != ops.end();) {
+      it->delta = (it->delta + mask) & ~mask;
+      if (it->delta) ++it;
+      else it = ops.erase(it);
+    }
+    if (ops.empty()) return;
+    std::sort(ops.begin(), ops.end(), OpLess);
+    // Parallel arrays of insertion points and prefix sums of their deltas,
+    // so DeltaForRange() can find the total shift for any range with two
+    // binary searches.
+    startptrs_.reserve(ops.size());
+    prefix_deltas_.reserve(ops.size() + 1);
+    prefix_deltas_.push_back(0);
+    for (auto it = ops.begin(); it != ops.end(); ++it) {
+      startptrs_.push_back(buf_.data() + it->start);
+      prefix_deltas_.push_back(prefix_deltas_.back() + it->delta);
+    }
+    // Now change all the offsets by the deltas they straddle.
+    auto root = GetAnyRoot(buf_.data());
+    Straddle<uoffset_t, 1>(buf_.data(), root, buf_.data());
+    ResizeTable(root_table ? *root_table : *schema_.root_table(), root);
+    // We can now add or remove bytes at each op's start. Go back to front
+    // so the positions of the earlier ops stay valid.
+    for (auto it = ops.rbegin(); it != ops.rend(); ++it) {
+      if (it->delta > 0) {
+        buf_.insert(buf_.begin() + it->start, it->delta, 0);
+      } else {
+        buf_.erase(buf_.begin() + it->start,
+                   buf_.begin() + it->start - it->delta);
+      }
+    }
+  }
+
+  // The summed size change of all insertion points within [first, second].
+  int DeltaForRange(const void *first, const void *second) const {
+    if (second < first) return 0;
+    auto lo = std::lower_bound(startptrs_.begin(), startptrs_.end(),
+                               reinterpret_cast<const uint8_t *>(first));
+    auto hi = std::upper_bound(startptrs_.begin(), startptrs_.end(),
+                               reinterpret_cast<const uint8_t *>(second));
+    return prefix_deltas_[hi - startptrs_.begin()] -
+           prefix_deltas_[lo - startptrs_.begin()];
+  }
+
+  static bool OpLess(const Op &a, const Op &b) { return a.start < b.start; }
+
   const reflection::Schema &schema_;
-  uint8_t *startptr_;
-  int delta_;
+  std::vector<const uint8_t *> startptrs_;
+  std::vector<int> prefix_deltas_;
   std::vector<uint8_t> &buf_;
   std::vector<uint8_t> dag_check_;
 };
@@ -334,6 +445,81 @@ uint8_t *ResizeAnyVector(const reflection::Schema &schema, uoffset_t newsize,
   return flatbuf->data() + start;
 }
 
+void BufferMutationSession::SetString(const String *str,
+                                      const std::string &val) {
+  auto str_start = static_cast<uoffset_t>(
+      reinterpret_cast<const uint8_t *>(str) - flatbuf_->data());
+  Mutation m;
+  m.start = str_start + static_cast<uoffset_t>(sizeof(uoffset_t));
+  m.delta = static_cast<int>(val.size()) - static_cast<int>(str->Length());
+  m.header_pos = str_start;
+  m.new_len = static_cast<uoffset_t>(val.size());
+  m.str_value = val;
+  m.is_string = true;
+  if (m.delta) {
+    // Clear the old string, since we don't want parts of it remaining.
+    memset(flatbuf_->data() + m.start, 0, str->Length());
+  }
+  mutations_.push_back(m);
+}
+
+void BufferMutationSession::ResizeAnyVector(const VectorOfAny *vec,
+                                            uoffset_t newsize,
+                                            uoffset_t num_elems,
+                                            uoffset_t elem_size) {
+  auto delta_elem = static_cast<int>(newsize) - static_cast<int>(num_elems);
+  auto vec_start = static_cast<uoffset_t>(
+      reinterpret_cast<const uint8_t *>(vec) - flatbuf_->data());
+  Mutation m;
+  m.start = vec_start + static_cast<uoffset_t>(sizeof(uoffset_t)) +
+            elem_size * num_elems;
+  m.delta = delta_elem * static_cast<int>(elem_size);
+  m.header_pos = vec_start;
+  m.new_len = newsize;
+  m.is_string = false;
+  if (delta_elem < 0) {
+    // Clear elements we're throwing away, since some might remain in the
+    // buffer.
+    auto size_clear = -delta_elem * elem_size;
+    memset(flatbuf_->data() + m.start - size_clear, 0, size_clear);
+  }
+  mutations_.push_back(m);
+}
+
+void BufferMutationSession::Apply() {
+  if (mutations_.empty()) return;
+  // Sort by position so the shift of each mutation's bytes is the prefix
+  // sum of the deltas before it.
+  std::sort(mutations_.begin(), mutations_.end(), MutationLess);
+  // All full-buffer offset fixups and reallocations happen in here, once
+  // for the whole batch.
+  std::vector<ResizeContext::Op> ops;
+  ops.reserve(mutations_.size());
+  for (auto it = mutations_.begin(); it != mutations_.end(); ++it) {
+    ResizeContext::Op op;
+    op.start = it->start;
+    op.delta = it->delta;
+    ops.push_back(op);
+  }
+  ResizeContext(schema_, ops, flatbuf_, root_table_);
+  // Rewrite length fields and string contents at their shifted positions.
+  // Newly inserted vector elements are already zero.
+  auto mask = static_cast<int>(sizeof(largest_scalar_t) - 1);
+  int shift = 0;
+  for (auto it = mutations_.begin(); it != mutations_.end(); ++it) {
+    if (it->delta) {
+      WriteScalar(flatbuf_->data() + it->header_pos + shift, it->new_len);
+    }
+    if (it->is_string) {
+      // Safe because the resize above created the right amount of space.
+      memcpy(flatbuf_->data() + it->start + shift, it->str_value.c_str(),
+             it->str_value.size() + 1);
+    }
+    shift += (it->delta + mask) & ~mask;
+  }
+  mutations_.clear();
+}
+
 const uint8_t *AddFlatBuffer(std::vector<uint8_t> &flatbuf,
                              const uint8_t *newbuf, size_t newlen) {
   // Align to sizeof(uoffset_t) past sizeof(largest_scalar_t) since we're
@@ -481,6 +667,261 @@ Offset<const Table *> CopyTable(FlatBufferBuilder &fbb,
   }
 }
 
+// The recursion behind OptimizeLayout below. Structured like CopyTable,
+// except that pass 1 creates the subobjects of each table in *reverse*
+// field order: the builder grows towards lower addresses, so the finished
+// buffer then reads parent first, first field's subtree next. "shared"
+// memoizes tables already emitted, keeping DAGs shared instead of
+// duplicating them the way CopyTable does.
+static Offset<const Table *> OptimizeTable(
+    FlatBufferBuilder &fbb, const reflection::Schema &schema,
+    const reflection::Object &objectdef, const Table &table,
+    std::map<const Table *, uoffset_t> &shared) {
+  auto seen = shared.find(&table);
+  if (seen != shared.end()) return seen->second;
+  auto fielddefs = objectdef.fields();
+  std::vector<uoffset_t> offsets(fielddefs->size());
+  for (uoffset_t i = fielddefs->size(); i--; ) {
+    auto &fielddef = *fielddefs->Get(i);
+    offsets[i] = 0;
+    if (!table.CheckField(fielddef.offset())) continue;
+    switch (fielddef.type()->base_type()) {
+      case reflection::String: {
+        offsets[i] = fbb.CreateSharedString(GetFieldS(table, fielddef)).o;
+        break;
+      }
+      case reflection::Obj: {
+        auto &subobjectdef = *schema.objects()->Get(fielddef.type()->index());
+        if (!subobjectdef.is_struct()) {
+          offsets[i] = OptimizeTable(fbb, schema, subobjectdef,
+                                     *GetFieldT(table, fielddef), shared).o;
+        }
+        break;
+      }
+      case reflection::Union: {
+        auto &subobjectdef = GetUnionType(schema, objectdef, fielddef, table);
+        offsets[i] = OptimizeTable(fbb, schema, subobjectdef,
+                                   *GetFieldT(table, fielddef), shared).o;
+        break;
+      }
+      case reflection::Vector: {
+        auto vec = table.GetPointer<const Vector<Offset<Table>> *>(
+                                                           fielddef.offset());
+        auto element_base_type = fielddef.type()->element();
+        auto elemobjectdef = element_base_type == reflection::Obj
+            ? schema.objects()->Get(fielddef.type()->index())
+            : nullptr;
+        switch (element_base_type) {
+          case reflection::String: {
+            std::vector<Offset<const String *>> elements(vec->size());
+            auto vec_s = reinterpret_cast<const Vector<Offset<String>> *>(vec);
+            for (uoffset_t j = vec_s->size(); j--; ) {
+              elements[j] = fbb.CreateSharedString(vec_s->Get(j)).o;
+            }
+            offsets[i] = fbb.CreateVector(elements).o;
+            break;
+          }
+          case reflection::Obj: {
+            if (!elemobjectdef->is_struct()) {
+              std::vector<Offset<const Table *>> elements(vec->size());
+              // Reversed for the same reason as the field loop: element 0
+              // ends up adjacent to the vector.
+              for (uoffset_t j = vec->size(); j--; ) {
+                elements[j] = OptimizeTable(fbb, schema, *elemobjectdef,
+                                            *vec->Get(j), shared);
+              }
+              offsets[i] = fbb.CreateVector(elements).o;
+              break;
+            }
+            // FALL-THRU:
+          }
+          default: {  // Scalars and structs.
+            auto element_size = GetTypeSize(element_base_type);
+            if (elemobjectdef && elemobjectdef->is_struct())
+              element_size = elemobjectdef->bytesize();
+            fbb.StartVector(element_size, vec->size());
+            fbb.PushBytes(vec->Data(), element_size * vec->size());
+            offsets[i] = fbb.EndVector(vec->size());
+            break;
+          }
+        }
+        break;
+      }
+      default:  // Scalars.
+        break;
+    }
+  }
+  auto start = fbb.StartTable();
+  for (uoffset_t i = 0; i < fielddefs->size(); i++) {
+    auto &fielddef = *fielddefs->Get(i);
+    if (!table.CheckField(fielddef.offset())) continue;
+    auto base_type = fielddef.type()->base_type();
+    switch (base_type) {
+      case reflection::Obj: {
+        auto &subobjectdef = *schema.objects()->Get(fielddef.type()->index());
+        if (subobjectdef.is_struct()) {
+          CopyInline(fbb, fielddef, table, subobjectdef.minalign(),
+                     subobjectdef.bytesize());
+          break;
+        }
+        // else: FALL-THRU:
+      }
+      case reflection::Union:
+      case reflection::String:
+      case reflection::Vector:
+        fbb.AddOffset(fielddef.offset(), Offset<void>(offsets[i]));
+        break;
+      default: {  // Scalars.
+        auto size = GetTypeSize(base_type);
+        CopyInline(fbb, fielddef, table, size, size);
+        break;
+      }
+    }
+  }
+  auto result =
+      fbb.EndTable(start, static_cast<voffset_t>(fielddefs->size()));
+  shared[&table] = result;
+  return result;
+}
+
+Offset<const Table *> OptimizeLayout(FlatBufferBuilder &fbb,
+                                     const reflection::Schema &schema,
+                                     const reflection::Object &objectdef,
+                                     const Table &table) {
+  std::map<const Table *, uoffset_t> shared;
+  return OptimizeTable(fbb, schema, objectdef, table, shared);
+}
+
+// Computes the byte span and the number of reachable bytes of a table's
+// transitive closure. Used by ExtractSubtree below to decide whether a
+// subtree can be sliced out with a bulk copy.
+class SubtreeSpan {
+ public:
+  explicit SubtreeSpan(const reflection::Schema &schema)
+    : schema_(schema), lo_(nullptr), hi_(nullptr), bytes_(0) {}
+
+  void Walk(const reflection::Object &objectdef, const Table *table) {
+    if (!Visit(table)) return;  // DAGs: visit shared tables once.
+    auto tableloc = reinterpret_cast<const uint8_t *>(table);
+    auto vtable = table->GetVTable();
+    if (Visit(vtable)) Note(vtable, ReadScalar<voffset_t>(vtable));
+    Note(tableloc, ReadScalar<voffset_t>(vtable + sizeof(voffset_t)));
+    auto fielddefs = objectdef.fields();
+    for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+      auto &fielddef = **it;
+      auto base_type = fielddef.type()->base_type();
+      // Scalars and structs are in-line in the table span noted above.
+      if (base_type <= reflection::Double) continue;
+      auto offset = table->GetOptionalFieldOffset(fielddef.offset());
+      if (!offset) continue;
+      auto subobjectdef = base_type == reflection::Obj ?
+          schema_.objects()->Get(fielddef.type()->index()) : nullptr;
+      if (subobjectdef && subobjectdef->is_struct()) continue;
+      auto ref = tableloc + offset + ReadScalar<uoffset_t>(tableloc + offset);
+      switch (base_type) {
+        case reflection::String:
+          NoteString(ref);
+          break;
+        case reflection::Obj:
+          Walk(*subobjectdef, reinterpret_cast<const Table *>(ref));
+          break;
+        case reflection::Union:
+          Walk(GetUnionType(schema_, objectdef, fielddef, *table),
+               reinterpret_cast<const Table *>(ref));
+          break;
+        case reflection::Vector: {
+          if (!Visit(ref)) break;
+          auto vec = reinterpret_cast<const Vector<uoffset_t> *>(ref);
+          auto elem_type = fielddef.type()->element();
+          auto elemobjectdef = elem_type == reflection::Obj
+              ? schema_.objects()->Get(fielddef.type()->index())
+              : nullptr;
+          if (elem_type == reflection::String ||
+              (elemobjectdef && !elemobjectdef->is_struct())) {
+            Note(ref, sizeof(uoffset_t) + vec->size() * sizeof(uoffset_t));
+            for (uoffset_t i = 0; i < vec->size(); i++) {
+              auto loc = vec->Data() + i * sizeof(uoffset_t);
+              auto elem = loc + ReadScalar<uoffset_t>(loc);
+              if (elem_type == reflection::String) {
+                NoteString(elem);
+              } else {
+                Walk(*elemobjectdef, reinterpret_cast<const Table *>(elem));
+              }
+            }
+          } else {  // Scalars and structs: elements are in-line.
+            auto elem_size = GetTypeSize(elem_type);
+            if (elemobjectdef) elem_size = elemobjectdef->bytesize();
+            Note(ref, sizeof(uoffset_t) + vec->size() * elem_size);
+          }
+          break;
+        }
+        default:
+          assert(false);
+      }
+    }
+  }
+
+  const uint8_t *lo() const { return lo_; }
+  const uint8_t *hi() const { return hi_; }
+  size_t bytes() const { return bytes_; }
+
+ private:
+  // Returns true the first time a heap object is seen, so shared objects
+  // get counted once.
+  bool Visit(const void *p) { return visited_.insert(p).second; }
+
+  void Note(const uint8_t *start, size_t len) {
+    if (!lo_ || start < lo_) lo_ = start;
+    if (start + len > hi_) hi_ = start + len;
+    bytes_ += len;
+  }
+
+  void NoteString(const uint8_t *str) {
+    if (Visit(str)) {
+      Note(str, sizeof(uoffset_t) +
+                reinterpret_cast<const String *>(str)->Length() + 1);
+    }
+  }
+
+  const reflection::Schema &schema_;
+  std::set<const void *> visited_;
+  const uint8_t *lo_;
+  const uint8_t *hi_;
+  size_t bytes_;
+};
+
+bool ExtractSubtree(const reflection::Schema &schema,
+                    const reflection::Object &objectdef,
+                    const Table &table,
+                    std::vector<uint8_t> *out) {
+  SubtreeSpan span(schema);
+  span.Walk(objectdef, &table);
+  auto span_len = static_cast<size_t>(span.hi() - span.lo());
+  // The span covers every reachable byte, so copying it verbatim is always
+  // correct; it is only worth doing while the span isn't dominated by
+  // unrelated bytes interleaved with the subtree. Allow 50% slack for
+  // alignment padding and small gaps, otherwise rebuild compactly.
+  if (span_len > span.bytes() + span.bytes() / 2 + 16) {
+    FlatBufferBuilder fbb;
+    fbb.Finish(Offset<Table>(CopyTable(fbb, schema, objectdef, table).o));
+    out->assign(fbb.GetBufferPointer(),
+                fbb.GetBufferPointer() + fbb.GetSize());
+    return false;
+  }
+  // Emit [root offset][padding][span bytes], with the padding chosen so
+  // every copied byte keeps its alignment (mod FLATBUFFERS_MAX_ALIGNMENT).
+  auto tableloc = reinterpret_cast<const uint8_t *>(&table);
+  auto lo_align = static_cast<size_t>(reinterpret_cast<uintptr_t>(span.lo()) &
+                                      (FLATBUFFERS_MAX_ALIGNMENT - 1));
+  auto pad = (lo_align - sizeof(uoffset_t)) & (FLATBUFFERS_MAX_ALIGNMENT - 1);
+  out->clear();
+  out->resize(sizeof(uoffset_t) + pad + span_len);
+  WriteScalar(out->data(), static_cast<uoffset_t>(
+      sizeof(uoffset_t) + pad + (tableloc - span.lo())));
+  memcpy(out->data() + sizeof(uoffset_t) + pad, span.lo(), span_len);
+  return true;
+}
+
 bool VerifyStruct(flatbuffers::Verifier &v,
                   const flatbuffers::Table &parent_table,
                   voffset_t field_offset,
@@ -707,4 +1148,1319 @@ bool Verify(const reflection::Schema &schema,
   return VerifyObject(v, schema, root, flatbuffers::GetAnyRoot(buf), true);
 }
 
+// ------------------------- SCHEMA EVOLUTION -------------------------
+
+// Like CopyInline above, but reading the bytes at the source schema's
+// field offset while registering them under the target schema's.
+static void CopyInlineMapped(FlatBufferBuilder &fbb,
+                             const reflection::Field &src_field,
+                             const reflection::Field &dst_field,
+                             const Table &table, size_t align, size_t size) {
+  fbb.Align(align);
+  fbb.PushBytes(table.GetStruct<const uint8_t *>(src_field.offset()), size);
+  fbb.TrackField(dst_field.offset(), fbb.GetSize());
+}
+
+SchemaTranscoder::SchemaTranscoder(const reflection::Schema &src,
+                                   const reflection::Schema &dst)
+  : src_(src), dst_(dst), valid_(true) {
+  auto src_root = src.root_table();
+  auto dst_root = dst.root_table();
+  if (!src_root || !dst_root) {
+    Fail("schema has no root table");
+    return;
+  }
+  CompileObject(*src_root, *dst_root);
+}
+
+void SchemaTranscoder::Fail(const std::string &msg) {
+  valid_ = false;
+  if (error_.empty()) error_ = msg;
+}
+
+// Structs are stored in-line, so a struct type must be byte-identical
+// between the versions (evolution rules don't allow changing them anyway).
+bool SchemaTranscoder::CompileStruct(const reflection::Object &src_object,
+                                     const reflection::Object &dst_object) {
+  if (!src_object.is_struct() || !dst_object.is_struct() ||
+      src_object.bytesize() != dst_object.bytesize() ||
+      src_object.minalign() != dst_object.minalign() ||
+      src_object.fields()->size() != dst_object.fields()->size()) {
+    return false;
+  }
+  auto src_fields = src_object.fields();
+  for (auto it = src_fields->begin(); it != src_fields->end(); ++it) {
+    auto &src_field = **it;
+    auto dst_field = dst_object.fields()->LookupByKey(
+                                            src_field.name()->c_str());
+    if (!dst_field || dst_field->offset() != src_field.offset() ||
+        dst_field->type()->base_type() != src_field.type()->base_type()) {
+      return false;
+    }
+    if (src_field.type()->base_type() == reflection::Obj &&
+        !CompileStruct(*src_.objects()->Get(src_field.type()->index()),
+                       *dst_.objects()->Get(dst_field->type()->index()))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t SchemaTranscoder::CompileObject(const reflection::Object &src_object,
+                                       const reflection::Object &dst_object) {
+  auto existing = plan_index_.find(&src_object);
+  if (existing != plan_index_.end()) return existing->second;
+  // Claim the plan slot up front so cyclic schemas terminate.
+  auto plan_slot = plans_.size();
+  plan_index_[&src_object] = plan_slot;
+  plans_.push_back(TablePlan());
+  plans_[plan_slot].src_object = &src_object;
+  plans_[plan_slot].dst_object = &dst_object;
+  plans_[plan_slot].identical = false;
+  plans_[plan_slot].compiled = false;
+
+  // Compile into locals: recursion below may grow plans_.
+  std::vector<MappedField> fields;
+  bool identical = true;
+  auto dst_fields = dst_object.fields();
+  for (auto it = dst_fields->begin(); it != dst_fields->end(); ++it) {
+    auto &dst_field = **it;
+    MappedField mapped;
+    mapped.src_field =
+        src_object.fields()->LookupByKey(dst_field.name()->c_str());
+    mapped.dst_field = &dst_field;
+    mapped.subplan = 0;
+    if (!mapped.src_field) {
+      // A new field: absent in transcoded output, so its default applies.
+      // Unless it is required, in which case no source record can satisfy
+      // the target schema.
+      if (dst_field.required()) {
+        Fail("required field added: " + dst_field.name()->str());
+      }
+      fields.push_back(mapped);
+      continue;
+    }
+    auto &src_field = *mapped.src_field;
+    auto src_type = src_field.type();
+    auto dst_type = dst_field.type();
+    if (src_type->base_type() != dst_type->base_type() ||
+        (src_type->base_type() == reflection::Vector &&
+         src_type->element() != dst_type->element())) {
+      Fail("field changed type: " + dst_field.name()->str());
+      fields.push_back(mapped);
+      continue;
+    }
+    // A moved vtable slot doesn't affect the mapping, but rules out
+    // copying the table's bytes verbatim.
+    if (src_field.offset() != dst_field.offset()) identical = false;
+    auto effective_base = src_type->base_type() == reflection::Vector
+                          ? src_type->element() : src_type->base_type();
+    if (effective_base == reflection::Obj) {
+      auto &src_sub = *src_.objects()->Get(src_type->index());
+      auto &dst_sub = *dst_.objects()->Get(dst_type->index());
+      if (src_sub.is_struct() || dst_sub.is_struct()) {
+        if (!CompileStruct(src_sub, dst_sub)) {
+          Fail("struct changed layout: " + dst_field.name()->str());
+        }
+      } else {
+        mapped.subplan = CompileObject(src_sub, dst_sub);
+        // A plan still being compiled is a cycle; assume it changed.
+        if (!plans_[mapped.subplan].compiled ||
+            !plans_[mapped.subplan].identical) {
+          identical = false;
+        }
+      }
+    } else if (effective_base == reflection::Union) {
+      // The type tag is copied verbatim, so every source variant must
+      // exist in the target under the same name and value.
+      auto src_enum = src_.enums()->Get(src_type->index());
+      auto dst_enum = dst_.enums()->Get(dst_type->index());
+      auto src_vals = src_enum->values();
+      for (auto val = src_vals->begin(); val != src_vals->end(); ++val) {
+        auto &src_val = **val;
+        if (!src_val.object()) continue;  // NONE
+        const reflection::EnumVal *dst_val = nullptr;
+        auto dst_vals = dst_enum->values();
+        for (auto cand = dst_vals->begin(); cand != dst_vals->end(); ++cand) {
+          if ((*cand)->name()->str() == src_val.name()->str()) {
+            dst_val = *cand;
+            break;
+          }
+        }
+        if (!dst_val || dst_val->value() != src_val.value() ||
+            !dst_val->object()) {
+          Fail("union changed: " + dst_field.name()->str());
+          continue;
+        }
+        auto variant_plan =
+            CompileObject(*src_val.object(), *dst_val->object());
+        if (!plans_[variant_plan].compiled ||
+            !plans_[variant_plan].identical) {
+          identical = false;
+        }
+      }
+    }
+    fields.push_back(mapped);
+  }
+  // Fields dropped from the target would survive a verbatim copy, so a
+  // table losing fields must be rebuilt to actually shed them.
+  auto src_fields = src_object.fields();
+  for (auto it = src_fields->begin(); it != src_fields->end(); ++it) {
+    if (!dst_fields->LookupByKey((*it)->name()->c_str())) identical = false;
+  }
+
+  plans_[plan_slot].fields = fields;
+  plans_[plan_slot].identical = identical;
+  plans_[plan_slot].compiled = true;
+  return plan_slot;
+}
+
+bool SchemaTranscoder::TranscodeTable(size_t plan_index, const Table &table,
+                                      FlatBufferBuilder &fbb, uoffset_t *out) {
+  auto &plan = plans_[plan_index];
+  if (plan.identical) {
+    // Unchanged subtree: slice its bytes out verbatim when they are
+    // (mostly) contiguous, exactly like ExtractSubtree above; internal
+    // offsets are all relative, so they stay valid in the new buffer.
+    SubtreeSpan span(src_);
+    span.Walk(*plan.src_object, &table);
+    auto span_len = static_cast<size_t>(span.hi() - span.lo());
+    if (span_len <= span.bytes() + span.bytes() / 2 + 16) {
+      // Pad so every copied byte keeps its address modulo the maximum
+      // alignment (the finished buffer's size is a multiple of it).
+      fbb.Align(FLATBUFFERS_MAX_ALIGNMENT);
+      auto lo_align = static_cast<size_t>(
+          reinterpret_cast<uintptr_t>(span.lo()) &
+          (FLATBUFFERS_MAX_ALIGNMENT - 1));
+      fbb.Pad((0 - lo_align - span_len) & (FLATBUFFERS_MAX_ALIGNMENT - 1));
+      fbb.PushBytes(span.lo(), span_len);
+      *out = fbb.GetSize() - static_cast<uoffset_t>(
+          reinterpret_cast<const uint8_t *>(&table) - span.lo());
+      return true;
+    }
+    // Sparse span (e.g. vtables shared with distant tables): rebuild
+    // compactly below instead, which is still a plain field-wise copy.
+  }
+  // Pass 1: like CopyTable above, generate all subobjects first, one
+  // offset slot per target field.
+  std::vector<uoffset_t> offsets(plan.fields.size());
+  for (size_t i = 0; i < plan.fields.size(); i++) {
+    auto &mapped = plan.fields[i];
+    offsets[i] = 0;
+    if (!mapped.src_field) continue;
+    auto &src_field = *mapped.src_field;
+    if (!table.CheckField(src_field.offset())) continue;
+    switch (src_field.type()->base_type()) {
+      case reflection::String: {
+        offsets[i] = fbb.CreateString(GetFieldS(table, src_field)).o;
+        break;
+      }
+      case reflection::Obj: {
+        auto &src_sub = *src_.objects()->Get(src_field.type()->index());
+        if (!src_sub.is_struct() &&
+            !TranscodeTable(mapped.subplan, *GetFieldT(table, src_field),
+                            fbb, &offsets[i])) {
+          return false;
+        }
+        break;
+      }
+      case reflection::Union: {
+        auto &variant = GetUnionType(src_, *plan.src_object, src_field,
+                                     table);
+        auto it = plan_index_.find(&variant);
+        if (it == plan_index_.end()) return false;  // Value out of range.
+        if (!TranscodeTable(it->second, *GetFieldT(table, src_field), fbb,
+                            &offsets[i])) {
+          return false;
+        }
+        break;
+      }
+      case reflection::Vector: {
+        auto vec = table.GetPointer<const Vector<Offset<Table>> *>(
+                                                           src_field.offset());
+        auto element_base_type = src_field.type()->element();
+        auto elemobjectdef = element_base_type == reflection::Obj
+            ? src_.objects()->Get(src_field.type()->index())
+            : nullptr;
+        switch (element_base_type) {
+          case reflection::String: {
+            std::vector<Offset<const String *>> elements(vec->size());
+            auto vec_s = reinterpret_cast<const Vector<Offset<String>> *>(vec);
+            for (uoffset_t j = 0; j < vec_s->size(); j++) {
+              elements[j] = fbb.CreateString(vec_s->Get(j)).o;
+            }
+            offsets[i] = fbb.CreateVector(elements).o;
+            break;
+          }
+          case reflection::Obj: {
+            if (!elemobjectdef->is_struct()) {
+              std::vector<Offset<const Table *>> elements(vec->size());
+              for (uoffset_t j = 0; j < vec->size(); j++) {
+                uoffset_t elem = 0;
+                if (!TranscodeTable(mapped.subplan, *vec->Get(j), fbb, &elem))
+                  return false;
+                elements[j] = elem;
+              }
+              offsets[i] = fbb.CreateVector(elements).o;
+              break;
+            }
+            // FALL-THRU:
+          }
+          default: {  // Scalars and structs.
+            auto element_size = GetTypeSize(element_base_type);
+            if (elemobjectdef && elemobjectdef->is_struct())
+              element_size = elemobjectdef->bytesize();
+            fbb.StartVector(element_size, vec->size());
+            fbb.PushBytes(vec->Data(), element_size * vec->size());
+            offsets[i] = fbb.EndVector(vec->size());
+            break;
+          }
+        }
+        break;
+      }
+      default:  // Scalars.
+        break;
+    }
+  }
+  // Pass 2: build the table in the target's layout.
+  auto start = fbb.StartTable();
+  for (size_t i = 0; i < plan.fields.size(); i++) {
+    auto &mapped = plan.fields[i];
+    auto &dst_field = *mapped.dst_field;
+    if (!mapped.src_field || !table.CheckField(mapped.src_field->offset())) {
+      if (dst_field.required()) return false;
+      continue;
+    }
+    auto base_type = dst_field.type()->base_type();
+    switch (base_type) {
+      case reflection::Obj: {
+        auto &dst_sub = *dst_.objects()->Get(dst_field.type()->index());
+        if (dst_sub.is_struct()) {
+          CopyInlineMapped(fbb, *mapped.src_field, dst_field, table,
+                           dst_sub.minalign(), dst_sub.bytesize());
+          break;
+        }
+        // else: FALL-THRU:
+      }
+      case reflection::Union:
+      case reflection::String:
+      case reflection::Vector:
+        fbb.AddOffset(dst_field.offset(), Offset<void>(offsets[i]));
+        break;
+      default: {  // Scalars.
+        auto size = GetTypeSize(base_type);
+        CopyInlineMapped(fbb, *mapped.src_field, dst_field, table, size,
+                         size);
+        break;
+      }
+    }
+  }
+  *out = fbb.EndTable(
+      start, static_cast<voffset_t>(plan.dst_object->fields()->size()));
+  return true;
+}
+
+bool SchemaTranscoder::Transcode(const Table &root, FlatBufferBuilder &fbb) {
+  assert(valid_);
+  uoffset_t root_offset = 0;
+  if (!TranscodeTable(0, root, fbb, &root_offset)) return false;
+  fbb.Finish(Offset<Table>(root_offset));
+  return true;
+}
+
+// ------------------------- STRUCTURAL DIFFING -------------------------
+
+// Delta wire format (all integers little-endian):
+//   delta     = magic:u64, tableop
+//   tableop   = kOpKeep
+//             | kOpNew   len:u32, standalone subtree buffer (ExtractSubtree)
+//             | kOpPatch offsetgroup scalargroup
+// Each group is count:u32 followed by entries in ascending field index
+// order, so the applier consumes the stream in the same two passes the
+// builder needs anyway (offsets first, in-line data second):
+//   offsetentry = index:u16, kFieldAbsent
+//               | index:u16, kFieldValue  len:u32, bytes  (string contents,
+//                 or the raw elements of a scalar/struct vector)
+//               | index:u16, kFieldTable  [tag:u8 if union], tableop
+//               | index:u16, kFieldVector size:u32, size * elem
+//   elem        = kElemKeep                       (copy old element)
+//               | kElemNew  len:u32, bytes        (string elements)
+//               | kElemNew  tableop               (table elements)
+//   scalarentry = index:u16, kFieldAbsent
+//               | index:u16, kFieldScalar bytes   (scalar or struct, size
+//                 known from the schema)
+// Fields not listed in a patch are taken from the old buffer.
+
+static const uint64_t kDeltaMagic = 0x3141544c45444246ULL;  // "FBDELTA1"
+
+static const uint8_t kOpKeep = 0;
+static const uint8_t kOpNew = 1;
+static const uint8_t kOpPatch = 2;
+static const uint8_t kFieldAbsent = 0;
+static const uint8_t kFieldScalar = 1;
+static const uint8_t kFieldValue = 2;
+static const uint8_t kFieldTable = 3;
+static const uint8_t kFieldVector = 4;
+static const uint8_t kElemKeep = 0;
+static const uint8_t kElemNew = 1;
+
+template<typename T> static void DeltaWrite(std::vector<uint8_t> *out, T v) {
+  out->resize(out->size() + sizeof(T));
+  WriteScalar(&(*out)[out->size() - sizeof(T)], v);
+}
+
+static void DeltaWriteBytes(std::vector<uint8_t> *out, const void *p,
+                            size_t len) {
+  auto bytes = static_cast<const uint8_t *>(p);
+  out->insert(out->end(), bytes, bytes + len);
+}
+
+// Bounds-checked cursor over a received delta. After a failed read, ok()
+// is false and all further reads yield zeros.
+class DeltaReader {
+ public:
+  DeltaReader(const uint8_t *buf, size_t len)
+    : p_(buf), end_(buf + len), ok_(true) {}
+
+  template<typename T> T Read() {
+    if (static_cast<size_t>(end_ - p_) < sizeof(T)) {
+      ok_ = false;
+      return 0;
+    }
+    auto v = ReadScalar<T>(p_);
+    p_ += sizeof(T);
+    return v;
+  }
+
+  const uint8_t *Bytes(size_t len) {
+    if (static_cast<size_t>(end_ - p_) < len) {
+      ok_ = false;
+      return nullptr;
+    }
+    auto r = p_;
+    p_ += len;
+    return r;
+  }
+
+  bool ok() const { return ok_; }
+  bool AtEnd() const { return p_ == end_; }
+
+ private:
+  const uint8_t *p_;
+  const uint8_t *end_;
+  bool ok_;
+};
+
+// True for field types stored as an offset in the table (built in pass 1),
+// false for scalars and structs (stored in-line, written in pass 2).
+static bool IsOffsetField(const reflection::Schema &schema,
+                          const reflection::Field &fielddef) {
+  switch (fielddef.type()->base_type()) {
+    case reflection::String:
+    case reflection::Vector:
+    case reflection::Union:
+      return true;
+    case reflection::Obj:
+      return !schema.objects()->Get(fielddef.type()->index())->is_struct();
+    default:
+      return false;
+  }
+}
+
+static uint8_t GetUnionTag(const reflection::Object &objectdef,
+                           const reflection::Field &unionfield,
+                           const Table &table) {
+  auto type_field = objectdef.fields()->LookupByKey(
+      (unionfield.name()->str() + UnionTypeFieldSuffix()).c_str());
+  assert(type_field);
+  return GetFieldI<uint8_t>(table, *type_field);
+}
+
+static bool StringsEqual(const String *a, const String *b) {
+  if (!a || !b) return a == b;
+  return a->size() == b->size() && !memcmp(a->c_str(), b->c_str(), a->size());
+}
+
+static bool FieldEquals(const reflection::Schema &schema,
+                        const reflection::Object &objectdef,
+                        const reflection::Field &fielddef,
+                        const Table &a, const Table &b);
+
+static bool SubtreeEquals(const reflection::Schema &schema,
+                          const reflection::Object &objectdef,
+                          const Table *a, const Table *b) {
+  if (a == b) return true;
+  if (!a || !b) return false;
+  auto fielddefs = objectdef.fields();
+  for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+    if (!FieldEquals(schema, objectdef, **it, *a, *b)) return false;
+  }
+  return true;
+}
+
+static bool FieldEquals(const reflection::Schema &schema,
+                        const reflection::Object &objectdef,
+                        const reflection::Field &fielddef,
+                        const Table &a, const Table &b) {
+  auto base_type = fielddef.type()->base_type();
+  // Scalars compare by value, so an explicitly stored default equals an
+  // absent field.
+  if (IsInteger(base_type)) {
+    return GetAnyFieldI(a, fielddef) == GetAnyFieldI(b, fielddef);
+  }
+  if (IsFloat(base_type)) {
+    return GetAnyFieldF(a, fielddef) == GetAnyFieldF(b, fielddef);
+  }
+  auto present_a = a.CheckField(fielddef.offset());
+  auto present_b = b.CheckField(fielddef.offset());
+  if (present_a != present_b) return false;
+  if (!present_a) return true;
+  switch (base_type) {
+    case reflection::String:
+      return StringsEqual(GetFieldS(a, fielddef), GetFieldS(b, fielddef));
+    case reflection::Obj: {
+      auto &subobjectdef = *schema.objects()->Get(fielddef.type()->index());
+      if (subobjectdef.is_struct()) {
+        return !memcmp(a.GetStruct<const uint8_t *>(fielddef.offset()),
+                       b.GetStruct<const uint8_t *>(fielddef.offset()),
+                       subobjectdef.bytesize());
+      }
+      return SubtreeEquals(schema, subobjectdef, GetFieldT(a, fielddef),
+                           GetFieldT(b, fielddef));
+    }
+    case reflection::Union: {
+      if (GetUnionTag(objectdef, fielddef, a) !=
+          GetUnionTag(objectdef, fielddef, b)) {
+        return false;
+      }
+      auto &subobjectdef = GetUnionType(schema, objectdef, fielddef, a);
+      return SubtreeEquals(schema, subobjectdef, GetFieldT(a, fielddef),
+                           GetFieldT(b, fielddef));
+    }
+    case reflection::Vector: {
+      auto vec_a = GetFieldAnyV(a, fielddef);
+      auto vec_b = GetFieldAnyV(b, fielddef);
+      if (vec_a->size() != vec_b->size()) return false;
+      auto element_base_type = fielddef.type()->element();
+      auto elemobjectdef = element_base_type == reflection::Obj
+          ? schema.objects()->Get(fielddef.type()->index())
+          : nullptr;
+      if (element_base_type == reflection::String) {
+        auto sa = reinterpret_cast<const Vector<Offset<String>> *>(vec_a);
+        auto sb = reinterpret_cast<const Vector<Offset<String>> *>(vec_b);
+        for (uoffset_t i = 0; i < sa->size(); i++) {
+          if (!StringsEqual(sa->Get(i), sb->Get(i))) return false;
+        }
+        return true;
+      }
+      if (elemobjectdef && !elemobjectdef->is_struct()) {
+        auto ta = reinterpret_cast<const Vector<Offset<Table>> *>(vec_a);
+        auto tb = reinterpret_cast<const Vector<Offset<Table>> *>(vec_b);
+        for (uoffset_t i = 0; i < ta->size(); i++) {
+          if (!SubtreeEquals(schema, *elemobjectdef, ta->Get(i), tb->Get(i)))
+            return false;
+        }
+        return true;
+      }
+      auto element_size = GetTypeSize(element_base_type);
+      if (elemobjectdef) element_size = elemobjectdef->bytesize();
+      return !memcmp(vec_a->Data(), vec_b->Data(),
+                     vec_a->size() * element_size);
+    }
+    default:
+      return true;
+  }
+}
+
+bool TablesEqual(const reflection::Schema &schema,
+                 const reflection::Object &objectdef,
+                 const Table &a, const Table &b) {
+  return SubtreeEquals(schema, objectdef, &a, &b);
+}
+
+static void DeltaNewSubtree(const reflection::Schema &schema,
+                            const reflection::Object &objectdef,
+                            const Table &to, std::vector<uint8_t> *out) {
+  std::vector<uint8_t> fragment;
+  ExtractSubtree(schema, objectdef, to, &fragment);
+  DeltaWrite<uint8_t>(out, kOpNew);
+  DeltaWrite<uint32_t>(out, static_cast<uint32_t>(fragment.size()));
+  DeltaWriteBytes(out, fragment.data(), fragment.size());
+}
+
+static void DiffTable(const reflection::Schema &schema,
+                      const reflection::Object &objectdef,
+                      const Table &from, const Table &to,
+                      std::vector<uint8_t> *out);
+
+static void DiffOffsetField(const reflection::Schema &schema,
+                            const reflection::Object &objectdef,
+                            const reflection::Field &fielddef,
+                            const Table &from, const Table &to,
+                            std::vector<uint8_t> *out) {
+  if (!to.CheckField(fielddef.offset())) {
+    DeltaWrite<uint8_t>(out, kFieldAbsent);
+    return;
+  }
+  auto from_present = from.CheckField(fielddef.offset());
+  switch (fielddef.type()->base_type()) {
+    case reflection::String: {
+      auto str = GetFieldS(to, fielddef);
+      DeltaWrite<uint8_t>(out, kFieldValue);
+      DeltaWrite<uint32_t>(out, str->size());
+      DeltaWriteBytes(out, str->c_str(), str->size());
+      break;
+    }
+    case reflection::Obj: {
+      auto &subobjectdef = *schema.objects()->Get(fielddef.type()->index());
+      DeltaWrite<uint8_t>(out, kFieldTable);
+      if (from_present) {
+        DiffTable(schema, subobjectdef, *GetFieldT(from, fielddef),
+                  *GetFieldT(to, fielddef), out);
+      } else {
+        DeltaNewSubtree(schema, subobjectdef, *GetFieldT(to, fielddef), out);
+      }
+      break;
+    }
+    case reflection::Union: {
+      auto tag = GetUnionTag(objectdef, fielddef, to);
+      auto &subobjectdef = GetUnionType(schema, objectdef, fielddef, to);
+      DeltaWrite<uint8_t>(out, kFieldTable);
+      DeltaWrite<uint8_t>(out, tag);
+      if (from_present && GetUnionTag(objectdef, fielddef, from) == tag) {
+        DiffTable(schema, subobjectdef, *GetFieldT(from, fielddef),
+                  *GetFieldT(to, fielddef), out);
+      } else {
+        DeltaNewSubtree(schema, subobjectdef, *GetFieldT(to, fielddef), out);
+      }
+      break;
+    }
+    case reflection::Vector: {
+      auto element_base_type = fielddef.type()->element();
+      auto elemobjectdef = element_base_type == reflection::Obj
+          ? schema.objects()->Get(fielddef.type()->index())
+          : nullptr;
+      auto to_vec = GetFieldAnyV(to, fielddef);
+      if (element_base_type != reflection::String &&
+          !(elemobjectdef && !elemobjectdef->is_struct())) {
+        // Scalars and structs: ship the raw elements.
+        auto element_size = GetTypeSize(element_base_type);
+        if (elemobjectdef) element_size = elemobjectdef->bytesize();
+        DeltaWrite<uint8_t>(out, kFieldValue);
+        DeltaWrite<uint32_t>(out, to_vec->size() * element_size);
+        DeltaWriteBytes(out, to_vec->Data(), to_vec->size() * element_size);
+        break;
+      }
+      // Strings and tables: diff per element against the same index.
+      auto from_vec =
+          from_present ? GetFieldAnyV(from, fielddef) : nullptr;
+      auto from_size = from_vec ? from_vec->size() : 0;
+      DeltaWrite<uint8_t>(out, kFieldVector);
+      DeltaWrite<uint32_t>(out, to_vec->size());
+      for (uoffset_t i = 0; i < to_vec->size(); i++) {
+        if (element_base_type == reflection::String) {
+          auto to_s = reinterpret_cast<const Vector<Offset<String>> *>(
+              to_vec)->Get(i);
+          auto from_s = i < from_size
+              ? reinterpret_cast<const Vector<Offset<String>> *>(
+                    from_vec)->Get(i)
+              : nullptr;
+          if (from_s && StringsEqual(from_s, to_s)) {
+            DeltaWrite<uint8_t>(out, kElemKeep);
+          } else {
+            DeltaWrite<uint8_t>(out, kElemNew);
+            DeltaWrite<uint32_t>(out, to_s->size());
+            DeltaWriteBytes(out, to_s->c_str(), to_s->size());
+          }
+        } else {
+          auto to_t = reinterpret_cast<const Vector<Offset<Table>> *>(
+              to_vec)->Get(i);
+          auto from_t = i < from_size
+              ? reinterpret_cast<const Vector<Offset<Table>> *>(
+                    from_vec)->Get(i)
+              : nullptr;
+          if (from_t && SubtreeEquals(schema, *elemobjectdef, from_t, to_t)) {
+            DeltaWrite<uint8_t>(out, kElemKeep);
+          } else {
+            DeltaWrite<uint8_t>(out, kElemNew);
+            if (from_t) {
+              DiffTable(schema, *elemobjectdef, *from_t, *to_t, out);
+            } else {
+              DeltaNewSubtree(schema, *elemobjectdef, *to_t, out);
+            }
+          }
+        }
+      }
+      break;
+    }
+    default:
+      assert(false);
+  }
+}
+
+static void DiffTable(const reflection::Schema &schema,
+                      const reflection::Object &objectdef,
+                      const Table &from, const Table &to,
+                      std::vector<uint8_t> *out) {
+  auto fielddefs = objectdef.fields();
+  std::vector<uint16_t> changed_offsets, changed_scalars;
+  for (uoffset_t i = 0; i < fielddefs->size(); i++) {
+    auto &fielddef = *fielddefs->Get(i);
+    if (FieldEquals(schema, objectdef, fielddef, from, to)) continue;
+    if (IsOffsetField(schema, fielddef)) {
+      changed_offsets.push_back(static_cast<uint16_t>(i));
+    } else {
+      changed_scalars.push_back(static_cast<uint16_t>(i));
+    }
+  }
+  DeltaWrite<uint8_t>(out, kOpPatch);
+  DeltaWrite<uint32_t>(out, static_cast<uint32_t>(changed_offsets.size()));
+  for (auto it = changed_offsets.begin(); it != changed_offsets.end(); ++it) {
+    DeltaWrite<uint16_t>(out, *it);
+    DiffOffsetField(schema, objectdef, *fielddefs->Get(*it), from, to, out);
+  }
+  DeltaWrite<uint32_t>(out, static_cast<uint32_t>(changed_scalars.size()));
+  for (auto it = changed_scalars.begin(); it != changed_scalars.end(); ++it) {
+    auto &fielddef = *fielddefs->Get(*it);
+    DeltaWrite<uint16_t>(out, *it);
+    if (!to.CheckField(fielddef.offset())) {
+      // Only reachable if "to" stores fewer explicit defaults than "from";
+      // the value is equal anyway, but record the absence faithfully.
+      DeltaWrite<uint8_t>(out, kFieldAbsent);
+      continue;
+    }
+    auto size = GetTypeSize(fielddef.type()->base_type());
+    if (fielddef.type()->base_type() == reflection::Obj) {
+      size = schema.objects()->Get(fielddef.type()->index())->bytesize();
+    }
+    DeltaWrite<uint8_t>(out, kFieldScalar);
+    DeltaWriteBytes(out, to.GetStruct<const uint8_t *>(fielddef.offset()),
+                    size);
+  }
+}
+
+bool MakeDelta(const reflection::Schema &schema,
+               const reflection::Object &objectdef,
+               const Table &from, const Table &to,
+               std::vector<uint8_t> *delta) {
+  delta->clear();
+  DeltaWrite<uint64_t>(delta, kDeltaMagic);
+  if (SubtreeEquals(schema, objectdef, &from, &to)) {
+    DeltaWrite<uint8_t>(delta, kOpKeep);
+    return false;
+  }
+  DiffTable(schema, objectdef, from, to, delta);
+  return true;
+}
+
+static bool ApplyTableOp(DeltaReader &r, const reflection::Schema &schema,
+                         const reflection::Object &objectdef,
+                         const Table *from, FlatBufferBuilder &fbb,
+                         uoffset_t *out) {
+  switch (r.Read<uint8_t>()) {
+    case kOpKeep: {
+      if (!from) return false;
+      *out = CopyTable(fbb, schema, objectdef, *from).o;
+      return true;
+    }
+    case kOpNew: {
+      auto len = r.Read<uint32_t>();
+      auto fragment = r.Bytes(len);
+      if (!fragment || len < sizeof(uoffset_t)) return false;
+      *out = CopyTable(fbb, schema, objectdef,
+                       *GetAnyRoot(fragment)).o;
+      return true;
+    }
+    case kOpPatch:
+      break;
+    default:
+      return false;
+  }
+  if (!from) return false;
+  auto fielddefs = objectdef.fields();
+  auto nfields = fielddefs->size();
+  // Per field: 0 = take from the old buffer, 1 = patched (offsets/bytes
+  // below), 2 = absent in the new buffer.
+  std::vector<uint8_t> state(nfields, 0);
+  std::vector<uoffset_t> offsets(nfields, 0);
+  std::vector<const uint8_t *> scalar_bytes(nfields, nullptr);
+  // Patched offset fields, in ascending field index order.
+  auto n_offset = r.Read<uint32_t>();
+  for (uint32_t e = 0; e < n_offset; e++) {
+    auto index = r.Read<uint16_t>();
+    if (!r.ok() || index >= nfields) return false;
+    auto &fielddef = *fielddefs->Get(index);
+    if (!IsOffsetField(schema, fielddef)) return false;
+    state[index] = 1;
+    switch (r.Read<uint8_t>()) {
+      case kFieldAbsent:
+        state[index] = 2;
+        break;
+      case kFieldValue: {
+        auto len = r.Read<uint32_t>();
+        auto bytes = r.Bytes(len);
+        if (!bytes) return false;
+        if (fielddef.type()->base_type() == reflection::String) {
+          offsets[index] = fbb.CreateString(
+              reinterpret_cast<const char *>(bytes), len).o;
+        } else {
+          auto element_base_type = fielddef.type()->element();
+          auto element_size = GetTypeSize(element_base_type);
+          if (element_base_type == reflection::Obj) {
+            element_size =
+                schema.objects()->Get(fielddef.type()->index())->bytesize();
+          }
+          if (!element_size || len % element_size) return false;
+          fbb.StartVector(element_size, len / element_size);
+          fbb.PushBytes(bytes, len);
+          offsets[index] = fbb.EndVector(len / element_size);
+        }
+        break;
+      }
+      case kFieldTable: {
+        const reflection::Object *subobjectdef;
+        const Table *from_sub = nullptr;
+        if (fielddef.type()->base_type() == reflection::Union) {
+          auto tag = r.Read<uint8_t>();
+          auto enumdef = schema.enums()->Get(fielddef.type()->index());
+          auto enumval = enumdef->values()->LookupByKey(tag);
+          if (!enumval || !enumval->object()) return false;
+          subobjectdef = enumval->object();
+          if (from->CheckField(fielddef.offset()) &&
+              GetUnionTag(objectdef, fielddef, *from) == tag) {
+            from_sub = GetFieldT(*from, fielddef);
+          }
+        } else {
+          subobjectdef = schema.objects()->Get(fielddef.type()->index());
+          if (from->CheckField(fielddef.offset())) {
+            from_sub = GetFieldT(*from, fielddef);
+          }
+        }
+        if (!ApplyTableOp(r, schema, *subobjectdef, from_sub, fbb,
+                          &offsets[index])) {
+          return false;
+        }
+        break;
+      }
+      case kFieldVector: {
+        auto element_base_type = fielddef.type()->element();
+        auto elemobjectdef = element_base_type == reflection::Obj
+            ? schema.objects()->Get(fielddef.type()->index())
+            : nullptr;
+        auto from_vec = from->CheckField(fielddef.offset())
+            ? GetFieldAnyV(*from, fielddef)
+            : nullptr;
+        auto from_size = from_vec ? from_vec->size() : 0;
+        auto size = r.Read<uint32_t>();
+        if (!r.ok()) return false;
+        std::vector<uoffset_t> elements(size);
+        for (uoffset_t i = 0; i < size; i++) {
+          auto elemop = r.Read<uint8_t>();
+          if (element_base_type == reflection::String) {
+            if (elemop == kElemKeep) {
+              if (i >= from_size) return false;
+              elements[i] = fbb.CreateString(
+                  reinterpret_cast<const Vector<Offset<String>> *>(
+                      from_vec)->Get(i)).o;
+            } else if (elemop == kElemNew) {
+              auto len = r.Read<uint32_t>();
+              auto bytes = r.Bytes(len);
+              if (!bytes) return false;
+              elements[i] = fbb.CreateString(
+                  reinterpret_cast<const char *>(bytes), len).o;
+            } else {
+              return false;
+            }
+          } else {
+            auto from_t = i < from_size
+                ? reinterpret_cast<const Vector<Offset<Table>> *>(
+                      from_vec)->Get(i)
+                : nullptr;
+            if (elemop == kElemKeep) {
+              if (!from_t) return false;
+              elements[i] = CopyTable(fbb, schema, *elemobjectdef,
+                                      *from_t).o;
+            } else if (elemop == kElemNew) {
+              if (!ApplyTableOp(r, schema, *elemobjectdef, from_t, fbb,
+                                &elements[i])) {
+                return false;
+              }
+            } else {
+              return false;
+            }
+          }
+        }
+        fbb.StartVector(sizeof(uoffset_t), size);
+        for (auto i = size; i--; ) {
+          fbb.PushElement(Offset<void>(elements[i]));
+        }
+        offsets[index] = fbb.EndVector(size);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  // Offset fields not in the patch are copied from the old buffer.
+  for (uoffset_t i = 0; i < nfields; i++) {
+    auto &fielddef = *fielddefs->Get(i);
+    if (state[i] || !IsOffsetField(schema, fielddef) ||
+        !from->CheckField(fielddef.offset())) {
+      continue;
+    }
+    state[i] = 1;
+    switch (fielddef.type()->base_type()) {
+      case reflection::String:
+        offsets[i] = fbb.CreateString(GetFieldS(*from, fielddef)).o;
+        break;
+      case reflection::Obj:
+        offsets[i] = CopyTable(
+            fbb, schema, *schema.objects()->Get(fielddef.type()->index()),
+            *GetFieldT(*from, fielddef)).o;
+        break;
+      case reflection::Union:
+        offsets[i] = CopyTable(
+            fbb, schema, GetUnionType(schema, objectdef, fielddef, *from),
+            *GetFieldT(*from, fielddef)).o;
+        break;
+      case reflection::Vector: {
+        // Rebuild the old vector wholesale; CopyTable's vector cases
+        // cover exactly this, so borrow a single-field copy from it by
+        // copying the elements here.
+        auto vec = from->GetPointer<const Vector<Offset<Table>> *>(
+            fielddef.offset());
+        auto element_base_type = fielddef.type()->element();
+        auto elemobjectdef = element_base_type == reflection::Obj
+            ? schema.objects()->Get(fielddef.type()->index())
+            : nullptr;
+        if (element_base_type == reflection::String) {
+          auto vec_s = reinterpret_cast<const Vector<Offset<String>> *>(vec);
+          std::vector<uoffset_t> elements(vec_s->size());
+          for (uoffset_t j = 0; j < vec_s->size(); j++) {
+            elements[j] = fbb.CreateString(vec_s->Get(j)).o;
+          }
+          fbb.StartVector(sizeof(uoffset_t), vec_s->size());
+          for (auto j = vec_s->size(); j--; ) {
+            fbb.PushElement(Offset<void>(elements[j]));
+          }
+          offsets[i] = fbb.EndVector(vec_s->size());
+        } else if (elemobjectdef && !elemobjectdef->is_struct()) {
+          std::vector<uoffset_t> elements(vec->size());
+          for (uoffset_t j = 0; j < vec->size(); j++) {
+            elements[j] =
+                CopyTable(fbb, schema, *elemobjectdef, *vec->Get(j)).o;
+          }
+          fbb.StartVector(sizeof(uoffset_t), vec->size());
+          for (auto j = vec->size(); j--; ) {
+            fbb.PushElement(Offset<void>(elements[j]));
+          }
+          offsets[i] = fbb.EndVector(vec->size());
+        } else {
+          auto element_size = GetTypeSize(element_base_type);
+          if (elemobjectdef) element_size = elemobjectdef->bytesize();
+          fbb.StartVector(element_size, vec->size());
+          fbb.PushBytes(vec->Data(), element_size * vec->size());
+          offsets[i] = fbb.EndVector(vec->size());
+        }
+        break;
+      }
+      default:
+        assert(false);
+    }
+  }
+  // Patched in-line fields.
+  auto n_scalar = r.Read<uint32_t>();
+  for (uint32_t e = 0; e < n_scalar; e++) {
+    auto index = r.Read<uint16_t>();
+    if (!r.ok() || index >= nfields) return false;
+    auto &fielddef = *fielddefs->Get(index);
+    if (IsOffsetField(schema, fielddef)) return false;
+    auto fieldop = r.Read<uint8_t>();
+    if (fieldop == kFieldAbsent) {
+      state[index] = 2;
+    } else if (fieldop == kFieldScalar) {
+      auto size = GetTypeSize(fielddef.type()->base_type());
+      if (fielddef.type()->base_type() == reflection::Obj) {
+        size = schema.objects()->Get(fielddef.type()->index())->bytesize();
+      }
+      scalar_bytes[index] = r.Bytes(size);
+      if (!scalar_bytes[index]) return false;
+      state[index] = 1;
+    } else {
+      return false;
+    }
+  }
+  if (!r.ok()) return false;
+  // Now build the table itself.
+  auto start = fbb.StartTable();
+  for (uoffset_t i = 0; i < nfields; i++) {
+    auto &fielddef = *fielddefs->Get(i);
+    if (state[i] == 2) continue;
+    if (IsOffsetField(schema, fielddef)) {
+      if (state[i] == 1) {
+        fbb.AddOffset(fielddef.offset(), Offset<void>(offsets[i]));
+      }
+      continue;
+    }
+    size_t align = GetTypeSize(fielddef.type()->base_type());
+    size_t size = align;
+    if (fielddef.type()->base_type() == reflection::Obj) {
+      auto &subobjectdef = *schema.objects()->Get(fielddef.type()->index());
+      align = subobjectdef.minalign();
+      size = subobjectdef.bytesize();
+    }
+    if (state[i] == 1) {
+      fbb.Align(align);
+      fbb.PushBytes(scalar_bytes[i], size);
+      fbb.TrackField(fielddef.offset(), fbb.GetSize());
+    } else if (from->CheckField(fielddef.offset())) {
+      CopyInline(fbb, fielddef, *from, align, size);
+    }
+  }
+  *out = fbb.EndTable(start, static_cast<voffset_t>(nfields));
+  return true;
+}
+
+bool ApplyDelta(const reflection::Schema &schema,
+                const reflection::Object &objectdef,
+                const Table &from, const uint8_t *delta, size_t delta_len,
+                FlatBufferBuilder &fbb) {
+  DeltaReader r(delta, delta_len);
+  if (r.Read<uint64_t>() != kDeltaMagic) return false;
+  uoffset_t root = 0;
+  if (!ApplyTableOp(r, schema, objectdef, &from, fbb, &root)) return false;
+  if (!r.ok() || !r.AtEnd()) return false;
+  fbb.Finish(Offset<Table>(root));
+  return true;
+}
+
+// ------------------------- FLEXBUFFER CONVERSION -------------------------
+
+// Element count of any FlexBuffer vector representation.
+static size_t FlexVectorSize(const flexbuffers::Reference &value) {
+  auto type = value.GetType();
+  if (flexbuffers::IsTypedVector(type)) return value.AsTypedVector().size();
+  if (flexbuffers::IsFixedTypedVector(type))
+    return value.AsFixedTypedVector().size();
+  return value.AsVector().size();
+}
+
+static flexbuffers::Reference FlexVectorElement(
+    const flexbuffers::Reference &value, size_t i) {
+  auto type = value.GetType();
+  if (flexbuffers::IsTypedVector(type)) return value.AsTypedVector()[i];
+  if (flexbuffers::IsFixedTypedVector(type))
+    return value.AsFixedTypedVector()[i];
+  return value.AsVector()[i];
+}
+
+static bool IsFlexVector(const flexbuffers::Reference &value) {
+  auto type = value.GetType();
+  return type == flexbuffers::TYPE_VECTOR || flexbuffers::IsTypedVector(type) ||
+         flexbuffers::IsFixedTypedVector(type);
+}
+
+// Whether the contents of a typed vector with the given element type can be
+// memcpy'd into a scalar vector of "base_type". Both formats store
+// little-endian data, so equal element width and kind (integer vs float) is
+// all that's needed, on any host.
+static bool FlexElementCompatible(flexbuffers::Type element_type,
+                                  uint8_t element_width,
+                                  reflection::BaseType base_type) {
+  if (element_width != GetTypeSize(base_type)) return false;
+  switch (element_type) {
+    case flexbuffers::TYPE_INT:
+    case flexbuffers::TYPE_UINT:  return IsInteger(base_type);
+    case flexbuffers::TYPE_FLOAT: return IsFloat(base_type);
+    default:                      return false;
+  }
+}
+
+// Adds one scalar field from a FlexBuffer value, against the schema default
+// so default-valued fields stay absent from the output.
+static bool AddScalarFromFlex(FlatBufferBuilder &fbb,
+                              const reflection::Field &fielddef,
+                              const flexbuffers::Reference &value) {
+  if (!value.IsNumeric()) return false;
+# define FLATBUFFERS_ADD(T, GET, DEF) \
+    fbb.AddElement(fielddef.offset(), static_cast<T>(value.GET()), \
+                   static_cast<T>(fielddef.DEF())); \
+    break;
+  switch (fielddef.type()->base_type()) {
+    case reflection::Bool:
+    case reflection::UByte:  FLATBUFFERS_ADD(uint8_t,  AsUInt64, default_integer)
+    case reflection::Byte:   FLATBUFFERS_ADD(int8_t,   AsInt64,  default_integer)
+    case reflection::Short:  FLATBUFFERS_ADD(int16_t,  AsInt64,  default_integer)
+    case reflection::UShort: FLATBUFFERS_ADD(uint16_t, AsUInt64, default_integer)
+    case reflection::Int:    FLATBUFFERS_ADD(int32_t,  AsInt64,  default_integer)
+    case reflection::UInt:   FLATBUFFERS_ADD(uint32_t, AsUInt64, default_integer)
+    case reflection::Long:   FLATBUFFERS_ADD(int64_t,  AsInt64,  default_integer)
+    case reflection::ULong:  FLATBUFFERS_ADD(uint64_t, AsUInt64, default_integer)
+    case reflection::Float:  FLATBUFFERS_ADD(float,    AsDouble, default_real)
+    case reflection::Double: FLATBUFFERS_ADD(double,   AsDouble, default_real)
+    default: return false;
+  }
+# undef FLATBUFFERS_ADD
+  return true;
+}
+
+// Serializes a FlexBuffer vector as a scalar vector of "element_base_type".
+// Typed vectors (and blobs, for ubyte targets) whose elements are already
+// stored at the target width are bulk-copied; anything else falls back to
+// converting element by element.
+static bool CreateScalarVectorFromFlex(FlatBufferBuilder &fbb,
+                                       reflection::BaseType element_base_type,
+                                       const flexbuffers::Reference &value,
+                                       uoffset_t *out) {
+  auto element_size = GetTypeSize(element_base_type);
+  auto type = value.GetType();
+  if (flexbuffers::IsTypedVector(type)) {
+    auto vec = value.AsTypedVector();
+    if (FlexElementCompatible(flexbuffers::ToTypedVectorElementType(type),
+                              vec.byte_width(), element_base_type)) {
+      auto len = vec.size();
+      fbb.StartVector(len, element_size);
+      fbb.PushBytes(vec.data(), element_size * len);
+      *out = fbb.EndVector(len);
+      return true;
+    }
+  } else if (type == flexbuffers::TYPE_BLOB) {
+    if (element_size != 1 || !IsInteger(element_base_type)) return false;
+    auto blob = value.AsBlob();
+    auto len = blob.size();
+    fbb.StartVector(len, element_size);
+    fbb.PushBytes(blob.data(), len);
+    *out = fbb.EndVector(len);
+    return true;
+  }
+  if (!IsFlexVector(value)) return false;
+  auto len = FlexVectorSize(value);
+  fbb.StartVector(len, element_size);
+# define FLATBUFFERS_PUSH(T, GET) \
+    for (size_t i = len; i > 0;) \
+      fbb.PushElement(static_cast<T>(FlexVectorElement(value, --i).GET())); \
+    break;
+  switch (element_base_type) {
+    case reflection::Bool:
+    case reflection::UByte:  FLATBUFFERS_PUSH(uint8_t,  AsUInt64)
+    case reflection::Byte:   FLATBUFFERS_PUSH(int8_t,   AsInt64)
+    case reflection::Short:  FLATBUFFERS_PUSH(int16_t,  AsInt64)
+    case reflection::UShort: FLATBUFFERS_PUSH(uint16_t, AsUInt64)
+    case reflection::Int:    FLATBUFFERS_PUSH(int32_t,  AsInt64)
+    case reflection::UInt:   FLATBUFFERS_PUSH(uint32_t, AsUInt64)
+    case reflection::Long:   FLATBUFFERS_PUSH(int64_t,  AsInt64)
+    case reflection::ULong:  FLATBUFFERS_PUSH(uint64_t, AsUInt64)
+    case reflection::Float:  FLATBUFFERS_PUSH(float,    AsDouble)
+    case reflection::Double: FLATBUFFERS_PUSH(double,   AsDouble)
+    default: return false;
+  }
+# undef FLATBUFFERS_PUSH
+  *out = fbb.EndVector(len);
+  return true;
+}
+
+bool FlexToFlatConverter::PlannedFieldLess(const PlannedField &a,
+                                           const PlannedField &b) {
+  return strcmp(a.field->name()->c_str(), b.field->name()->c_str()) < 0;
+}
+
+FlexToFlatConverter::FlexToFlatConverter(const reflection::Schema &schema,
+                                         const reflection::Object *root)
+    : schema_(schema) {
+  CompileObject(root ? *root : *schema.root_table());
+}
+
+size_t FlexToFlatConverter::CompileObject(const reflection::Object &objectdef) {
+  auto existing = plan_index_.find(&objectdef);
+  if (existing != plan_index_.end()) return existing->second;
+  // Claim the plan slot before recursing, so cyclic schemas terminate.
+  auto plan_index = plans_.size();
+  plan_index_[&objectdef] = plan_index;
+  plans_.push_back(TablePlan());
+  plans_.back().object = &objectdef;
+  plans_.back().last_keys = nullptr;
+  plans_.back().last_num_keys = 0;
+  plans_.back().last_keys_hash = 0;
+  // Compile into a local: recursion below may grow (and reallocate) plans_.
+  std::vector<PlannedField> fields;
+  auto fielddefs = objectdef.fields();
+  for (auto it = fielddefs->begin(); it != fielddefs->end(); ++it) {
+    auto &fielddef = **it;
+    auto base_type = fielddef.type()->base_type();
+    // Unions (and their type fields) have no natural map encoding: skip.
+    if (base_type == reflection::Union || base_type == reflection::UType)
+      continue;
+    PlannedField planned;
+    planned.field = &fielddef;
+    planned.subplan = 0;
+    if (base_type == reflection::Obj ||
+        (base_type == reflection::Vector &&
+         fielddef.type()->element() == reflection::Obj)) {
+      auto &subobjectdef = *schema_.objects()->Get(fielddef.type()->index());
+      if (subobjectdef.is_struct()) continue;  // Structs: skip, as above.
+      planned.subplan = CompileObject(subobjectdef);
+    }
+    fields.push_back(planned);
+  }
+  // Sort by name to match the key order flexbuffers::Builder writes maps in,
+  // so MatchKeys below is a single linear merge.
+  std::sort(fields.begin(), fields.end(), PlannedFieldLess);
+  plans_[plan_index].fields.swap(fields);
+  return plan_index;
+}
+
+void FlexToFlatConverter::MatchKeys(TablePlan &plan,
+                                    const flexbuffers::Map &map) {
+  auto keys = map.Keys();
+  auto num_keys = keys.size();
+  // Hash the key strings: the data pointer alone is not a safe cache key,
+  // since a freed buffer's address may be reused by a different document.
+  auto hash = FnvTraits<uint64_t>::kOffsetBasis;
+  for (size_t i = 0; i < num_keys; i++) {
+    auto key = keys[i].AsKey();
+    // Include the terminator so adjacent keys hash distinctly.
+    hash = HashBytesFnv1a(key, strlen(key) + 1, hash);
+  }
+  // Maps built against a shared key vector (see flexbuffers::Builder's
+  // key sharing) all point at the same serialized keys, so one match
+  // serves every such document.
+  if (plan.last_keys == keys.data() && plan.last_num_keys == num_keys &&
+      plan.last_keys_hash == hash) {
+    return;
+  }
+  plan.key_index.assign(plan.fields.size(), -1);
+  size_t field_idx = 0;
+  size_t key_idx = 0;
+  while (field_idx < plan.fields.size() && key_idx < num_keys) {
+    auto cmp = strcmp(plan.fields[field_idx].field->name()->c_str(),
+                      keys[key_idx].AsKey());
+    if (cmp == 0) {
+      plan.key_index[field_idx++] = static_cast<int>(key_idx++);
+    } else if (cmp < 0) {
+      field_idx++;  // Field not present in the document.
+    } else {
+      key_idx++;    // Unknown key: ignored.
+    }
+  }
+  plan.last_keys = keys.data();
+  plan.last_num_keys = num_keys;
+  plan.last_keys_hash = hash;
+}
+
+bool FlexToFlatConverter::ConvertTable(size_t plan_index,
+                                       const flexbuffers::Map &map,
+                                       FlatBufferBuilder &fbb,
+                                       uoffset_t *out) {
+  auto &plan = plans_[plan_index];
+  MatchKeys(plan, map);
+  // Copy the match out: recursing into the same plan below re-matches and
+  // overwrites the cached one.
+  auto key_index = plan.key_index;
+  auto values = map.Values();
+  // Pass 1: like CopyTable above, generate all subobjects first and collect
+  // their offsets.
+  std::vector<uoffset_t> offsets(plan.fields.size(), 0);
+  for (size_t i = 0; i < plan.fields.size(); i++) {
+    if (key_index[i] < 0) continue;
+    auto &fielddef = *plan.fields[i].field;
+    auto value = values[static_cast<size_t>(key_index[i])];
+    switch (fielddef.type()->base_type()) {
+      case reflection::String: {
+        if (!value.IsString()) return false;
+        auto s = value.AsString();
+        offsets[i] = fbb.CreateString(s.c_str(), s.length()).o;
+        break;
+      }
+      case reflection::Obj: {
+        if (!value.IsMap()) return false;
+        if (!ConvertTable(plan.fields[i].subplan, value.AsMap(), fbb,
+                          &offsets[i])) {
+          return false;
+        }
+        break;
+      }
+      case reflection::Vector: {
+        auto element_base_type = fielddef.type()->element();
+        switch (element_base_type) {
+          case reflection::String: {
+            if (!IsFlexVector(value)) return false;
+            auto len = FlexVectorSize(value);
+            std::vector<Offset<const String *>> elements(len);
+            for (size_t j = 0; j < len; j++) {
+              auto element = FlexVectorElement(value, j);
+              if (!element.IsString()) return false;
+              auto s = element.AsString();
+              elements[j] = fbb.CreateString(s.c_str(), s.length()).o;
+            }
+            offsets[i] = fbb.CreateVector(elements).o;
+            break;
+          }
+          case reflection::Obj: {
+            if (!IsFlexVector(value)) return false;
+            auto len = FlexVectorSize(value);
+            std::vector<Offset<const Table *>> elements(len);
+            for (size_t j = 0; j < len; j++) {
+              auto element = FlexVectorElement(value, j);
+              if (!element.IsMap()) return false;
+              uoffset_t element_offset;
+              if (!ConvertTable(plan.fields[i].subplan, element.AsMap(), fbb,
+                                &element_offset)) {
+                return false;
+              }
+              elements[j] = element_offset;
+            }
+            offsets[i] = fbb.CreateVector(elements).o;
+            break;
+          }
+          default: {  // Scalars.
+            if (!CreateScalarVectorFromFlex(fbb, element_base_type, value,
+                                            &offsets[i])) {
+              return false;
+            }
+            break;
+          }
+        }
+        break;
+      }
+      default:  // Scalars, handled in pass 2.
+        break;
+    }
+  }
+  // Pass 2: build the table itself.
+  auto start = fbb.StartTable();
+  for (size_t i = 0; i < plan.fields.size(); i++) {
+    auto &fielddef = *plan.fields[i].field;
+    if (key_index[i] < 0) {
+      if (fielddef.required()) return false;
+      continue;
+    }
+    switch (fielddef.type()->base_type()) {
+      case reflection::String:
+      case reflection::Obj:
+      case reflection::Vector:
+        fbb.AddOffset(fielddef.offset(), Offset<void>(offsets[i]));
+        break;
+      default: {  // Scalars.
+        if (!AddScalarFromFlex(fbb, fielddef,
+                               values[static_cast<size_t>(key_index[i])])) {
+          return false;
+        }
+        break;
+      }
+    }
+  }
+  *out = fbb.EndTable(start,
+                      static_cast<voffset_t>(plan.object->fields()->size()));
+  return true;
+}
+
+bool FlexToFlatConverter::Convert(const flexbuffers::Reference &document,
+                                  FlatBufferBuilder &fbb) {
+  if (!document.IsMap()) return false;
+  uoffset_t root;
+  if (!ConvertTable(0, document.AsMap(), fbb, &root)) return false;
+  fbb.Finish(Offset<Table>(root));
+  return true;
+}
+
 }  // namespace flatbuffers
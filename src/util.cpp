@@ -16,6 +16,12 @@
 
 #include "flatbuffers/util.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace flatbuffers {
 
 bool FileExistsRaw(const char *name) {
@@ -83,4 +89,100 @@ FileExistsFunction SetFileExistsFunction(
   return previous_function;
 }
 
+// Maps "filename" in its entirety, returning nullptr when it can't be
+// mapped (missing, empty, not a regular file, or mapping failed). With
+// "copy_on_write" the view is writable and written pages are materialized
+// privately, page by page, leaving the file untouched.
+static const uint8_t *MapWholeFile(const char *filename, bool copy_on_write,
+                                   size_t *size) {
+  #ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    const uint8_t *data = nullptr;
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0 &&
+        static_cast<uint64_t>(file_size.QuadPart) <= SIZE_MAX) {
+      HANDLE mapping = CreateFileMappingA(
+                         file, nullptr,
+                         copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY,
+                         0, 0, nullptr);
+      if (mapping) {
+        // The view keeps the mapping (and file) alive until unmapped.
+        data = static_cast<const uint8_t *>(
+                 MapViewOfFile(mapping,
+                               copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ,
+                               0, 0, 0));
+        CloseHandle(mapping);
+        if (data) *size = static_cast<size_t>(file_size.QuadPart);
+      }
+    }
+    CloseHandle(file);
+    return data;
+  #else
+    auto fd = open(filename, O_RDONLY);
+    if (fd < 0) return nullptr;
+    const uint8_t *data = nullptr;
+    struct stat file_info;
+    if (fstat(fd, &file_info) == 0 && S_ISREG(file_info.st_mode) &&
+        file_info.st_size > 0) {
+      auto mapping = mmap(nullptr, static_cast<size_t>(file_info.st_size),
+                          copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ,
+                          copy_on_write ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+      if (mapping != MAP_FAILED) {
+        // The mapping holds its own reference to the file.
+        data = static_cast<const uint8_t *>(mapping);
+        *size = static_cast<size_t>(file_info.st_size);
+      }
+    }
+    close(fd);
+    return data;
+  #endif
+}
+
+static void UnmapWholeFile(const uint8_t *data, size_t size) {
+  #ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(data);
+  #else
+    munmap(const_cast<uint8_t *>(data), size);
+  #endif
+}
+
+bool MappedFile::Open(const char *filename) {
+  return OpenInternal(filename, false);
+}
+
+bool MappedFile::OpenCopyOnWrite(const char *filename) {
+  return OpenInternal(filename, true);
+}
+
+bool MappedFile::OpenInternal(const char *filename, bool copy_on_write) {
+  Close();
+  data_ = MapWholeFile(filename, copy_on_write, &size_);
+  if (data_) {
+    mapped_ = true;
+    writable_ = copy_on_write;
+    return true;
+  }
+  // Fall back to a plain (and hookable) read; this also covers empty
+  // files, which can't be mapped. The copy is private, so it satisfies
+  // copy-on-write semantics trivially, just not lazily.
+  if (!LoadFile(filename, true, &fallback_)) return false;
+  data_ = reinterpret_cast<const uint8_t *>(&fallback_[0]);
+  size_ = fallback_.size();
+  writable_ = copy_on_write;
+  return true;
+}
+
+void MappedFile::Close() {
+  if (mapped_) UnmapWholeFile(data_, size_);
+  fallback_.clear();
+  data_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+  writable_ = false;
+}
+
 }  // namespace flatbuffers
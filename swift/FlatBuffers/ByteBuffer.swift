@@ -40,6 +40,8 @@ public final class ByteBuffer {
     
     public var data : UnsafeMutableRawBufferPointer { get { return _buffer; } }
 
+    public var unsafeRawPointer : UnsafeRawPointer { get { return UnsafeRawPointer(_buffer.baseAddress!); } }
+
     public convenience init(capacity: Int) {
         let buffer = UnsafeMutableRawBufferPointer.allocate(count: capacity)
         self.init(buffer: buffer, pos: 0)
@@ -92,6 +92,23 @@ public struct Table {
         return UnsafeMutableRawBufferPointer(start: self.bb.data.baseAddress?.advanced(by: pos), count: len)
     }
     
+    // Get the data of a vector whose offset is stored at "offset" in this object as a
+    // typed UnsafeBufferPointer over the elements. If the vector is not present in the
+    // ByteBuffer, then a null value will be returned. Reads through the pointer bypass
+    // the per-element accessor overhead of ByteBuffer.
+    public func __vector_as_buffer<T>(_ offset: Int) -> UnsafeBufferPointer<T>? {
+        let o = self.__offset(offset);
+
+        if (0 == o) {
+            return nil;
+        }
+
+        let pos = self.__vector(o);
+        let len = self.__vector_len(o);
+        let base = UnsafeRawPointer(self.bb.data.baseAddress!.advanced(by: pos))
+        return UnsafeBufferPointer(start: base.assumingMemoryBound(to: T.self), count: len)
+    }
+
     // Initialize any Table-derived type to point to the union at the given offset.
     public func __union<T>(_ offset: Int) -> T where T : FlatbufferObject {
         var offset = offset
@@ -0,0 +1,280 @@
+/*
+ * Copyright 2016 Google Inc. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Micro and macro benchmarks for the hot paths of the library: buffer
+// construction, verification, keyed lookup, JSON in both directions,
+// reflection-based copying and flexbuffers construction. All fixtures are
+// derived from tests/monster_test.fbs, so numbers are comparable between
+// commits as long as that schema is unchanged.
+//
+// Run all benchmarks with no arguments, or pass a substring to run only
+// the benchmarks whose name contains it:
+//
+//   flatbench Build
+//
+// The harness is deliberately self-contained (no third-party benchmark
+// dependency): each benchmark is repeated with a growing iteration count
+// until it has run for a minimum wall-clock interval, and the per-
+// iteration time is reported in nanoseconds.
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/idl.h"
+#include "flatbuffers/util.h"
+#include "flatbuffers/reflection.h"
+#include "flatbuffers/flexbuffers.h"
+
+#include "monster_test_generated.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+using namespace MyGame::Example;
+
+// Accumulates a value from every iteration so the compiler can't remove
+// the benchmarked work as dead code.
+static uint64_t benchmark_sink = 0;
+
+// Fixtures shared by the benchmarks, built once at startup.
+static std::string g_schemafile;  // tests/monster_test.fbs source.
+static std::string g_jsonfile;    // canonical monster as JSON.
+static std::string g_bfbsfile;    // binary schema for reflection.
+static flatbuffers::FlatBufferBuilder g_monster;  // canonical monster.
+static flatbuffers::FlatBufferBuilder g_sorted;   // many keyed monsters.
+static flatbuffers::Parser g_parser;  // schema (and JSON fixture) parsed.
+
+static const int kSortedMonsters = 1000;
+
+// Builds the same moderately-sized monster every time: a struct, scalars,
+// a string, a scalar vector, a string vector, a vector of keyed tables
+// and a nested table. This is the unit of work for the construction,
+// verification and text generation benchmarks.
+static flatbuffers::Offset<Monster> BuildCanonicalMonster(
+    flatbuffers::FlatBufferBuilder &fbb) {
+  auto vec = Vec3(1, 2, 3, 0, Color_Red, Test(10, 20));
+  auto name = fbb.CreateString("MyMonster");
+  uint8_t inv_data[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+  auto inventory = fbb.CreateVector(inv_data, sizeof(inv_data));
+  flatbuffers::Offset<flatbuffers::String> names[] = {
+    fbb.CreateString("bob"), fbb.CreateString("fred"), fbb.CreateString("wilma")
+  };
+  auto strings = fbb.CreateVector(names, 3);
+  flatbuffers::Offset<Monster> mlocs[] = {
+    CreateMonster(fbb, nullptr, 0, 0, fbb.CreateString("Barney")),
+    CreateMonster(fbb, nullptr, 0, 0, fbb.CreateString("Fred")),
+    CreateMonster(fbb, nullptr, 0, 0, fbb.CreateString("Wilma"))
+  };
+  auto tables = fbb.CreateVectorOfSortedTables(mlocs, 3);
+  auto enemy = CreateMonster(fbb, nullptr, 0, 0, fbb.CreateString("Enemy"));
+  MonsterBuilder mb(fbb);
+  mb.add_pos(&vec);
+  mb.add_hp(80);
+  mb.add_name(name);
+  mb.add_inventory(inventory);
+  mb.add_testarrayoftables(tables);
+  mb.add_testarrayofstring(strings);
+  mb.add_enemy(enemy);
+  return mb.Finish();
+}
+
+static void BM_BuildMonster(int iterations) {
+  flatbuffers::FlatBufferBuilder fbb;
+  for (int i = 0; i < iterations; i++) {
+    fbb.Clear();
+    FinishMonsterBuffer(fbb, BuildCanonicalMonster(fbb));
+    benchmark_sink += fbb.GetSize();
+  }
+}
+
+static void BM_BuildScalarVector(int iterations) {
+  int data[1000];
+  for (int i = 0; i < 1000; i++) data[i] = i;
+  flatbuffers::FlatBufferBuilder fbb;
+  for (int i = 0; i < iterations; i++) {
+    fbb.Clear();
+    benchmark_sink += fbb.CreateVector(data, 1000).o;
+  }
+}
+
+static void BM_BuildStrings(int iterations) {
+  flatbuffers::FlatBufferBuilder fbb;
+  for (int i = 0; i < iterations; i++) {
+    fbb.Clear();
+    for (int j = 0; j < 100; j++) {
+      benchmark_sink += fbb.CreateString("a reasonably sized string").o;
+    }
+  }
+}
+
+static void BM_Verify(int iterations) {
+  for (int i = 0; i < iterations; i++) {
+    flatbuffers::Verifier verifier(g_monster.GetBufferPointer(),
+                                   g_monster.GetSize());
+    benchmark_sink += VerifyMonsterBuffer(verifier);
+  }
+}
+
+static void BM_LookupByKey(int iterations) {
+  auto monster = GetMonster(g_sorted.GetBufferPointer());
+  auto tables = monster->testarrayoftables();
+  char key[32];
+  for (int i = 0; i < iterations; i++) {
+    sprintf(key, "monster%04d", i % kSortedMonsters);
+    benchmark_sink += tables->LookupByKey(key)->hp();
+  }
+}
+
+static void BM_GenerateText(int iterations) {
+  for (int i = 0; i < iterations; i++) {
+    std::string text;
+    GenerateText(g_parser, g_monster.GetBufferPointer(), &text);
+    benchmark_sink += text.size();
+  }
+}
+
+// The parser keeps the schema's state, so parsing a document currently
+// means re-parsing the schema as well; BM_ParseSchema measures that
+// fixed cost on its own, and the difference to BM_ParseJson is the cost
+// of the JSON document itself.
+static void BM_ParseSchema(int iterations) {
+  const char *include_directories[] = { "tests", nullptr };
+  for (int i = 0; i < iterations; i++) {
+    flatbuffers::Parser parser;
+    benchmark_sink += parser.Parse(g_schemafile.c_str(), include_directories);
+  }
+}
+
+static void BM_ParseJson(int iterations) {
+  const char *include_directories[] = { "tests", nullptr };
+  for (int i = 0; i < iterations; i++) {
+    flatbuffers::Parser parser;
+    parser.Parse(g_schemafile.c_str(), include_directories);
+    benchmark_sink += parser.Parse(g_jsonfile.c_str(), include_directories);
+    benchmark_sink += parser.builder_.GetSize();
+  }
+}
+
+static void BM_ReflectionCopyTable(int iterations) {
+  auto &schema = *reflection::GetSchema(g_bfbsfile.c_str());
+  auto root = flatbuffers::GetAnyRoot(g_monster.GetBufferPointer());
+  flatbuffers::FlatBufferBuilder fbb;
+  for (int i = 0; i < iterations; i++) {
+    fbb.Clear();
+    auto copy = flatbuffers::CopyTable(fbb, schema, *schema.root_table(),
+                                       *root);
+    fbb.Finish(copy);
+    benchmark_sink += fbb.GetSize();
+  }
+}
+
+static void BM_FlexBuffersBuilder(int iterations) {
+  for (int i = 0; i < iterations; i++) {
+    flexbuffers::Builder slb;
+    slb.Map([&]() {
+      slb.String("name", "MyMonster");
+      slb.Int("hp", 80);
+      slb.Vector("inventory", [&]() {
+        for (int j = 0; j < 10; j++) slb.Int(j);
+      });
+    });
+    slb.Finish();
+    benchmark_sink += slb.GetBuffer().size();
+  }
+}
+
+static double NowSeconds() {
+  return std::chrono::duration<double>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Runs "func" with a growing iteration count until the timed region lasts
+// at least kMinSeconds, then reports the per-iteration time of the last
+// (longest) run. Quick and simple; for stable numbers run on a quiet
+// machine and compare medians of a few invocations.
+static void RunBenchmark(const char *name, void (*func)(int iterations),
+                         const char *filter) {
+  if (filter && !strstr(name, filter)) return;
+  static const double kMinSeconds = 0.5;
+  int iterations = 1;
+  for (;;) {
+    auto start = NowSeconds();
+    func(iterations);
+    auto elapsed = NowSeconds() - start;
+    if (elapsed >= kMinSeconds || iterations >= INT_MAX / 2) {
+      printf("%-24s %12d iterations %12.1f ns/op\n", name, iterations,
+             elapsed * 1e9 / iterations);
+      return;
+    }
+    // Aim past the threshold in one step, but never grow more than 10x
+    // at a time in case the first runs were too short to measure.
+    auto target = static_cast<int64_t>(iterations *
+      (elapsed > 0 ? kMinSeconds * 1.2 / elapsed : 10.0));
+    iterations = static_cast<int>(
+      std::min<int64_t>(std::max<int64_t>(target, iterations + 1),
+                        std::min<int64_t>(iterations * 10LL, INT_MAX / 2)));
+  }
+}
+
+static bool SetupFixtures() {
+  if (!flatbuffers::LoadFile("tests/monster_test.fbs", false, &g_schemafile) ||
+      !flatbuffers::LoadFile("tests/monsterdata_test.golden", false,
+                             &g_jsonfile) ||
+      !flatbuffers::LoadFile("tests/monster_test.bfbs", true, &g_bfbsfile)) {
+    printf("couldn't load fixture files (run from the project root)\n");
+    return false;
+  }
+  const char *include_directories[] = { "tests", nullptr };
+  if (!g_parser.Parse(g_schemafile.c_str(), include_directories)) {
+    printf("schema didn't parse: %s\n", g_parser.error_.c_str());
+    return false;
+  }
+  FinishMonsterBuffer(g_monster, BuildCanonicalMonster(g_monster));
+  // A large sorted vector of keyed tables for the lookup benchmark.
+  std::vector<flatbuffers::Offset<Monster>> mlocs;
+  char name[32];
+  for (int i = 0; i < kSortedMonsters; i++) {
+    sprintf(name, "monster%04d", i);
+    mlocs.push_back(CreateMonster(g_sorted, nullptr, 0,
+                                  static_cast<int16_t>(i),
+                                  g_sorted.CreateString(name, strlen(name))));
+  }
+  auto tables = g_sorted.CreateVectorOfSortedTables(&mlocs);
+  auto root_name = g_sorted.CreateString("root");
+  MonsterBuilder mb(g_sorted);
+  mb.add_name(root_name);
+  mb.add_testarrayoftables(tables);
+  FinishMonsterBuffer(g_sorted, mb.Finish());
+  return true;
+}
+
+int main(int argc, const char *argv[]) {
+  auto filter = argc > 1 ? argv[1] : nullptr;
+  if (!SetupFixtures()) return 1;
+  RunBenchmark("BuildMonster", BM_BuildMonster, filter);
+  RunBenchmark("BuildScalarVector", BM_BuildScalarVector, filter);
+  RunBenchmark("BuildStrings", BM_BuildStrings, filter);
+  RunBenchmark("Verify", BM_Verify, filter);
+  RunBenchmark("LookupByKey", BM_LookupByKey, filter);
+  RunBenchmark("GenerateText", BM_GenerateText, filter);
+  RunBenchmark("ParseSchema", BM_ParseSchema, filter);
+  RunBenchmark("ParseJson", BM_ParseJson, filter);
+  RunBenchmark("ReflectionCopyTable", BM_ReflectionCopyTable, filter);
+  RunBenchmark("FlexBuffersBuilder", BM_FlexBuffersBuilder, filter);
+  // Keep the sink observable so none of the above can be elided.
+  fprintf(stderr, "(checksum: %016llx)\n",
+          static_cast<unsigned long long>(benchmark_sink));
+  return 0;
+}
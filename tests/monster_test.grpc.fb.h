@@ -28,6 +28,7 @@ namespace Example {
 
 class MonsterStorage GRPC_FINAL {
  public:
+  typedef flatbuffers::GrpcStreamWriter< Monster> RetrieveWriter;
   class StubInterface {
    public:
     virtual ~StubInterface() {}
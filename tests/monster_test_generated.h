@@ -5,6 +5,7 @@
 #define FLATBUFFERS_GENERATED_MONSTERTEST_MYGAME_EXAMPLE_H_
 
 #include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/hash.h"
 
 namespace MyGame {
 namespace Example2 {
@@ -302,10 +303,13 @@ struct MonsterT : public flatbuffers::NativeTable {
 struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef MonsterT NativeTableType;
   bool Verify(flatbuffers::Verifier &verifier) const {
-    return VerifyTableStart(verifier) &&
+    if (!VerifyTableStart(verifier)) return false;
+    flatbuffers::uoffset_t extent = 0;
+    return VerifyFieldsExtent(verifier, extent) &&
            verifier.EndTable();
   }
   MonsterT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  MonsterT *UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   void UnPackTo(MonsterT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   static flatbuffers::Offset<Monster> Pack(flatbuffers::FlatBufferBuilder &_fbb, const MonsterT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
 };
@@ -357,11 +361,14 @@ struct TestSimpleTableWithEnum FLATBUFFERS_FINAL_CLASS : private flatbuffers::Ta
     return SetField<int8_t>(VT_COLOR, static_cast<int8_t>(_color), 2);
   }
   bool Verify(flatbuffers::Verifier &verifier) const {
-    return VerifyTableStart(verifier) &&
-           VerifyField<int8_t>(verifier, VT_COLOR) &&
+    if (!VerifyTableStart(verifier)) return false;
+    flatbuffers::uoffset_t extent = 0;
+    extent = FieldExtent(VT_COLOR, sizeof(int8_t), extent);
+    return VerifyFieldsExtent(verifier, extent) &&
            verifier.EndTable();
   }
   TestSimpleTableWithEnumT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  TestSimpleTableWithEnumT *UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   void UnPackTo(TestSimpleTableWithEnumT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   static flatbuffers::Offset<TestSimpleTableWithEnum> Pack(flatbuffers::FlatBufferBuilder &_fbb, const TestSimpleTableWithEnumT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
 };
@@ -431,14 +438,17 @@ struct Stat FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
     return SetField<uint16_t>(VT_COUNT, _count, 0);
   }
   bool Verify(flatbuffers::Verifier &verifier) const {
-    return VerifyTableStart(verifier) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_ID) &&
+    if (!VerifyTableStart(verifier)) return false;
+    flatbuffers::uoffset_t extent = 0;
+    extent = FieldExtent(VT_ID, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_VAL, sizeof(int64_t), extent);
+    extent = FieldExtent(VT_COUNT, sizeof(uint16_t), extent);
+    return VerifyFieldsExtent(verifier, extent) &&
            verifier.Verify(id()) &&
-           VerifyField<int64_t>(verifier, VT_VAL) &&
-           VerifyField<uint16_t>(verifier, VT_COUNT) &&
            verifier.EndTable();
   }
   StatT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  StatT *UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   void UnPackTo(StatT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   static flatbuffers::Offset<Stat> Pack(flatbuffers::FlatBufferBuilder &_fbb, const StatT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
 };
@@ -773,54 +783,58 @@ struct Monster FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
     return GetPointer<flatbuffers::Vector<const Ability *> *>(VT_TESTARRAYOFSORTEDSTRUCT);
   }
   bool Verify(flatbuffers::Verifier &verifier) const {
-    return VerifyTableStart(verifier) &&
-           VerifyField<Vec3>(verifier, VT_POS) &&
-           VerifyField<int16_t>(verifier, VT_MANA) &&
-           VerifyField<int16_t>(verifier, VT_HP) &&
-           VerifyFieldRequired<flatbuffers::uoffset_t>(verifier, VT_NAME) &&
+    if (!VerifyTableStart(verifier)) return false;
+    flatbuffers::uoffset_t extent = 0;
+    extent = FieldExtent(VT_POS, sizeof(Vec3), extent);
+    extent = FieldExtent(VT_MANA, sizeof(int16_t), extent);
+    extent = FieldExtent(VT_HP, sizeof(int16_t), extent);
+    extent = FieldExtent(VT_NAME, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_INVENTORY, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_COLOR, sizeof(int8_t), extent);
+    extent = FieldExtent(VT_TEST_TYPE, sizeof(uint8_t), extent);
+    extent = FieldExtent(VT_TEST, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_TEST4, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_TESTARRAYOFSTRING, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_TESTARRAYOFTABLES, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_ENEMY, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_TESTNESTEDFLATBUFFER, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_TESTEMPTY, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_TESTBOOL, sizeof(uint8_t), extent);
+    extent = FieldExtent(VT_TESTHASHS32_FNV1, sizeof(int32_t), extent);
+    extent = FieldExtent(VT_TESTHASHU32_FNV1, sizeof(uint32_t), extent);
+    extent = FieldExtent(VT_TESTHASHS64_FNV1, sizeof(int64_t), extent);
+    extent = FieldExtent(VT_TESTHASHU64_FNV1, sizeof(uint64_t), extent);
+    extent = FieldExtent(VT_TESTHASHS32_FNV1A, sizeof(int32_t), extent);
+    extent = FieldExtent(VT_TESTHASHU32_FNV1A, sizeof(uint32_t), extent);
+    extent = FieldExtent(VT_TESTHASHS64_FNV1A, sizeof(int64_t), extent);
+    extent = FieldExtent(VT_TESTHASHU64_FNV1A, sizeof(uint64_t), extent);
+    extent = FieldExtent(VT_TESTARRAYOFBOOLS, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_TESTF, sizeof(float), extent);
+    extent = FieldExtent(VT_TESTF2, sizeof(float), extent);
+    extent = FieldExtent(VT_TESTF3, sizeof(float), extent);
+    extent = FieldExtent(VT_TESTARRAYOFSTRING2, sizeof(flatbuffers::uoffset_t), extent);
+    extent = FieldExtent(VT_TESTARRAYOFSORTEDSTRUCT, sizeof(flatbuffers::uoffset_t), extent);
+    return VerifyFieldsExtent(verifier, extent) &&
+           verifier.Check(CheckField(VT_NAME)) &&
            verifier.Verify(name()) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_INVENTORY) &&
            verifier.Verify(inventory()) &&
-           VerifyField<int8_t>(verifier, VT_COLOR) &&
-           VerifyField<uint8_t>(verifier, VT_TEST_TYPE) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_TEST) &&
            VerifyAny(verifier, test(), test_type()) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_TEST4) &&
            verifier.Verify(test4()) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_TESTARRAYOFSTRING) &&
            verifier.Verify(testarrayofstring()) &&
            verifier.VerifyVectorOfStrings(testarrayofstring()) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_TESTARRAYOFTABLES) &&
            verifier.Verify(testarrayoftables()) &&
            verifier.VerifyVectorOfTables(testarrayoftables()) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_ENEMY) &&
            verifier.VerifyTable(enemy()) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_TESTNESTEDFLATBUFFER) &&
            verifier.Verify(testnestedflatbuffer()) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_TESTEMPTY) &&
            verifier.VerifyTable(testempty()) &&
-           VerifyField<uint8_t>(verifier, VT_TESTBOOL) &&
-           VerifyField<int32_t>(verifier, VT_TESTHASHS32_FNV1) &&
-           VerifyField<uint32_t>(verifier, VT_TESTHASHU32_FNV1) &&
-           VerifyField<int64_t>(verifier, VT_TESTHASHS64_FNV1) &&
-           VerifyField<uint64_t>(verifier, VT_TESTHASHU64_FNV1) &&
-           VerifyField<int32_t>(verifier, VT_TESTHASHS32_FNV1A) &&
-           VerifyField<uint32_t>(verifier, VT_TESTHASHU32_FNV1A) &&
-           VerifyField<int64_t>(verifier, VT_TESTHASHS64_FNV1A) &&
-           VerifyField<uint64_t>(verifier, VT_TESTHASHU64_FNV1A) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_TESTARRAYOFBOOLS) &&
            verifier.Verify(testarrayofbools()) &&
-           VerifyField<float>(verifier, VT_TESTF) &&
-           VerifyField<float>(verifier, VT_TESTF2) &&
-           VerifyField<float>(verifier, VT_TESTF3) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_TESTARRAYOFSTRING2) &&
            verifier.Verify(testarrayofstring2()) &&
            verifier.VerifyVectorOfStrings(testarrayofstring2()) &&
-           VerifyField<flatbuffers::uoffset_t>(verifier, VT_TESTARRAYOFSORTEDSTRUCT) &&
            verifier.Verify(testarrayofsortedstruct()) &&
            verifier.EndTable();
   }
   MonsterT *UnPack(const flatbuffers::resolver_function_t *_resolver = nullptr) const;
+  MonsterT *UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   void UnPackTo(MonsterT *_o, const flatbuffers::resolver_function_t *_resolver = nullptr) const;
   static flatbuffers::Offset<Monster> Pack(flatbuffers::FlatBufferBuilder &_fbb, const MonsterT* _o, const flatbuffers::rehasher_function_t *_rehasher = nullptr);
 };
@@ -1080,6 +1094,12 @@ inline MonsterT *Monster::UnPack(const flatbuffers::resolver_function_t *_resolv
   return _o;
 }
 
+inline MonsterT *Monster::UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = _arena.Make<MonsterT>();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
 inline void Monster::UnPackTo(MonsterT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
@@ -1106,6 +1126,12 @@ inline TestSimpleTableWithEnumT *TestSimpleTableWithEnum::UnPack(const flatbuffe
   return _o;
 }
 
+inline TestSimpleTableWithEnumT *TestSimpleTableWithEnum::UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = _arena.Make<TestSimpleTableWithEnumT>();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
 inline void TestSimpleTableWithEnum::UnPackTo(TestSimpleTableWithEnumT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
@@ -1125,12 +1151,22 @@ inline flatbuffers::Offset<TestSimpleTableWithEnum> CreateTestSimpleTableWithEnu
       _color);
 }
 
+inline void ExtractTestSimpleTableWithEnumColor(const flatbuffers::Vector<flatbuffers::Offset<TestSimpleTableWithEnum>> *_vec, int8_t *_dst) {
+  flatbuffers::ExtractScalarColumn<TestSimpleTableWithEnum, int8_t>(_vec, TestSimpleTableWithEnum::VT_COLOR, static_cast<int8_t>(2), _dst);
+}
+
 inline StatT *Stat::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
   auto _o = new StatT();
   UnPackTo(_o, _resolver);
   return _o;
 }
 
+inline StatT *Stat::UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = _arena.Make<StatT>();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
 inline void Stat::UnPackTo(StatT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
@@ -1156,12 +1192,26 @@ inline flatbuffers::Offset<Stat> CreateStat(flatbuffers::FlatBufferBuilder &_fbb
       _count);
 }
 
+inline void ExtractStatVal(const flatbuffers::Vector<flatbuffers::Offset<Stat>> *_vec, int64_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Stat, int64_t>(_vec, Stat::VT_VAL, static_cast<int64_t>(0), _dst);
+}
+
+inline void ExtractStatCount(const flatbuffers::Vector<flatbuffers::Offset<Stat>> *_vec, uint16_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Stat, uint16_t>(_vec, Stat::VT_COUNT, static_cast<uint16_t>(0), _dst);
+}
+
 inline MonsterT *Monster::UnPack(const flatbuffers::resolver_function_t *_resolver) const {
   auto _o = new MonsterT();
   UnPackTo(_o, _resolver);
   return _o;
 }
 
+inline MonsterT *Monster::UnPack(flatbuffers::ObjectArena &_arena, const flatbuffers::resolver_function_t *_resolver) const {
+  auto _o = _arena.Make<MonsterT>();
+  UnPackTo(_o, _resolver);
+  return _o;
+}
+
 inline void Monster::UnPackTo(MonsterT *_o, const flatbuffers::resolver_function_t *_resolver) const {
   (void)_o;
   (void)_resolver;
@@ -1265,6 +1315,70 @@ inline flatbuffers::Offset<Monster> CreateMonster(flatbuffers::FlatBufferBuilder
       _testarrayofsortedstruct);
 }
 
+inline void ExtractMonsterMana(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, int16_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, int16_t>(_vec, Monster::VT_MANA, static_cast<int16_t>(150), _dst);
+}
+
+inline void ExtractMonsterHp(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, int16_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, int16_t>(_vec, Monster::VT_HP, static_cast<int16_t>(100), _dst);
+}
+
+inline void ExtractMonsterColor(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, int8_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, int8_t>(_vec, Monster::VT_COLOR, static_cast<int8_t>(8), _dst);
+}
+
+inline void ExtractMonsterTestType(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, uint8_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, uint8_t>(_vec, Monster::VT_TEST_TYPE, static_cast<uint8_t>(0), _dst);
+}
+
+inline void ExtractMonsterTestbool(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, uint8_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, uint8_t>(_vec, Monster::VT_TESTBOOL, static_cast<uint8_t>(0), _dst);
+}
+
+inline void ExtractMonsterTesthashs32Fnv1(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, int32_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, int32_t>(_vec, Monster::VT_TESTHASHS32_FNV1, static_cast<int32_t>(0), _dst);
+}
+
+inline void ExtractMonsterTesthashu32Fnv1(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, uint32_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, uint32_t>(_vec, Monster::VT_TESTHASHU32_FNV1, static_cast<uint32_t>(0), _dst);
+}
+
+inline void ExtractMonsterTesthashs64Fnv1(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, int64_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, int64_t>(_vec, Monster::VT_TESTHASHS64_FNV1, static_cast<int64_t>(0), _dst);
+}
+
+inline void ExtractMonsterTesthashu64Fnv1(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, uint64_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, uint64_t>(_vec, Monster::VT_TESTHASHU64_FNV1, static_cast<uint64_t>(0), _dst);
+}
+
+inline void ExtractMonsterTesthashs32Fnv1a(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, int32_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, int32_t>(_vec, Monster::VT_TESTHASHS32_FNV1A, static_cast<int32_t>(0), _dst);
+}
+
+inline void ExtractMonsterTesthashu32Fnv1a(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, uint32_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, uint32_t>(_vec, Monster::VT_TESTHASHU32_FNV1A, static_cast<uint32_t>(0), _dst);
+}
+
+inline void ExtractMonsterTesthashs64Fnv1a(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, int64_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, int64_t>(_vec, Monster::VT_TESTHASHS64_FNV1A, static_cast<int64_t>(0), _dst);
+}
+
+inline void ExtractMonsterTesthashu64Fnv1a(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, uint64_t *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, uint64_t>(_vec, Monster::VT_TESTHASHU64_FNV1A, static_cast<uint64_t>(0), _dst);
+}
+
+inline void ExtractMonsterTestf(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, float *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, float>(_vec, Monster::VT_TESTF, static_cast<float>(3.14159f), _dst);
+}
+
+inline void ExtractMonsterTestf2(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, float *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, float>(_vec, Monster::VT_TESTF2, static_cast<float>(3.0f), _dst);
+}
+
+inline void ExtractMonsterTestf3(const flatbuffers::Vector<flatbuffers::Offset<Monster>> *_vec, float *_dst) {
+  flatbuffers::ExtractScalarColumn<Monster, float>(_vec, Monster::VT_TESTF3, static_cast<float>(0.0f), _dst);
+}
+
 inline bool VerifyAny(flatbuffers::Verifier &verifier, const void *obj, Any type) {
   switch (type) {
     case Any_NONE: {
@@ -1356,6 +1470,224 @@ inline void AnyUnion::Reset() {
   type = Any_NONE;
 }
 
+}  // namespace Example
+
+namespace Example2 {
+
+bool Equals(const Monster *lhs, const Monster *rhs);
+flatbuffers::hash_value_t HashOf(const Monster *obj, flatbuffers::hash_value_t hash);
+flatbuffers::hash_value_t HashOf(const Monster *obj);
+
+}  // namespace Example2
+
+namespace Example {
+
+bool Equals(const TestSimpleTableWithEnum *lhs, const TestSimpleTableWithEnum *rhs);
+flatbuffers::hash_value_t HashOf(const TestSimpleTableWithEnum *obj, flatbuffers::hash_value_t hash);
+flatbuffers::hash_value_t HashOf(const TestSimpleTableWithEnum *obj);
+
+bool Equals(const Stat *lhs, const Stat *rhs);
+flatbuffers::hash_value_t HashOf(const Stat *obj, flatbuffers::hash_value_t hash);
+flatbuffers::hash_value_t HashOf(const Stat *obj);
+
+bool Equals(const Monster *lhs, const Monster *rhs);
+flatbuffers::hash_value_t HashOf(const Monster *obj, flatbuffers::hash_value_t hash);
+flatbuffers::hash_value_t HashOf(const Monster *obj);
+
+bool EqualsAny(const void *lhs, const void *rhs, Any type);
+flatbuffers::hash_value_t HashAny(const void *obj, Any type, flatbuffers::hash_value_t hash);
+
+inline bool EqualsAny(const void *lhs, const void *rhs, Any type) {
+  if (lhs == rhs) return true;
+  switch (type) {
+    case Any_Monster: {
+      return lhs && rhs &&
+             Equals(reinterpret_cast<const Monster *>(lhs),
+                    reinterpret_cast<const Monster *>(rhs));
+    }
+    case Any_TestSimpleTableWithEnum: {
+      return lhs && rhs &&
+             Equals(reinterpret_cast<const TestSimpleTableWithEnum *>(lhs),
+                    reinterpret_cast<const TestSimpleTableWithEnum *>(rhs));
+    }
+    case Any_MyGame_Example2_Monster: {
+      return lhs && rhs &&
+             Equals(reinterpret_cast<const MyGame::Example2::Monster *>(lhs),
+                    reinterpret_cast<const MyGame::Example2::Monster *>(rhs));
+    }
+    default: return false;
+  }
+}
+
+inline flatbuffers::hash_value_t HashAny(const void *obj, Any type, flatbuffers::hash_value_t hash) {
+  switch (type) {
+    case Any_Monster: {
+      auto ptr = reinterpret_cast<const Monster *>(obj);
+      return ptr ? HashOf(ptr, hash) : hash;
+    }
+    case Any_TestSimpleTableWithEnum: {
+      auto ptr = reinterpret_cast<const TestSimpleTableWithEnum *>(obj);
+      return ptr ? HashOf(ptr, hash) : hash;
+    }
+    case Any_MyGame_Example2_Monster: {
+      auto ptr = reinterpret_cast<const MyGame::Example2::Monster *>(obj);
+      return ptr ? HashOf(ptr, hash) : hash;
+    }
+    default: return hash;
+  }
+}
+
+}  // namespace Example
+
+namespace Example2 {
+
+inline bool Equals(const Monster *lhs, const Monster *rhs) {
+  if (lhs == rhs) return true;
+  if (!lhs || !rhs) return false;
+  return true;
+}
+
+inline flatbuffers::hash_value_t HashOf(const Monster *obj, flatbuffers::hash_value_t hash) {
+  if (!obj) return hash;
+  return hash;
+}
+
+inline flatbuffers::hash_value_t HashOf(const Monster *obj) {
+  return HashOf(obj, flatbuffers::FnvTraits<flatbuffers::hash_value_t>::kOffsetBasis);
+}
+
+}  // namespace Example2
+
+namespace Example {
+
+inline bool Equals(const TestSimpleTableWithEnum *lhs, const TestSimpleTableWithEnum *rhs) {
+  if (lhs == rhs) return true;
+  if (!lhs || !rhs) return false;
+  if (lhs->color() != rhs->color()) return false;
+  return true;
+}
+
+inline flatbuffers::hash_value_t HashOf(const TestSimpleTableWithEnum *obj, flatbuffers::hash_value_t hash) {
+  if (!obj) return hash;
+  hash = flatbuffers::HashScalarFnv1a(static_cast<int8_t>(obj->color()), hash);
+  return hash;
+}
+
+inline flatbuffers::hash_value_t HashOf(const TestSimpleTableWithEnum *obj) {
+  return HashOf(obj, flatbuffers::FnvTraits<flatbuffers::hash_value_t>::kOffsetBasis);
+}
+
+inline bool Equals(const Stat *lhs, const Stat *rhs) {
+  if (lhs == rhs) return true;
+  if (!lhs || !rhs) return false;
+  if (!flatbuffers::EqualsString(lhs->id(), rhs->id())) return false;
+  if (lhs->val() != rhs->val()) return false;
+  if (lhs->count() != rhs->count()) return false;
+  return true;
+}
+
+inline flatbuffers::hash_value_t HashOf(const Stat *obj, flatbuffers::hash_value_t hash) {
+  if (!obj) return hash;
+  hash = flatbuffers::HashStringFnv1a(obj->id(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->val(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->count(), hash);
+  return hash;
+}
+
+inline flatbuffers::hash_value_t HashOf(const Stat *obj) {
+  return HashOf(obj, flatbuffers::FnvTraits<flatbuffers::hash_value_t>::kOffsetBasis);
+}
+
+inline bool Equals(const Monster *lhs, const Monster *rhs) {
+  if (lhs == rhs) return true;
+  if (!lhs || !rhs) return false;
+  if (!flatbuffers::EqualsStruct(lhs->pos(), rhs->pos())) return false;
+  if (lhs->mana() != rhs->mana()) return false;
+  if (lhs->hp() != rhs->hp()) return false;
+  if (!flatbuffers::EqualsString(lhs->name(), rhs->name())) return false;
+  if (!flatbuffers::EqualsVectorOfScalars(lhs->inventory(), rhs->inventory())) return false;
+  if (lhs->color() != rhs->color()) return false;
+  if (lhs->test_type() != rhs->test_type()) return false;
+  if (!EqualsAny(lhs->test(), rhs->test(), lhs->test_type())) return false;
+  if (!flatbuffers::EqualsVectorOfStructs(lhs->test4(), rhs->test4())) return false;
+  if (!flatbuffers::EqualsVectorOfStrings(lhs->testarrayofstring(), rhs->testarrayofstring())) return false;
+  {
+    auto l = lhs->testarrayoftables();
+    auto r = rhs->testarrayoftables();
+    if (l != r) {
+      if (!l || !r || l->size() != r->size()) return false;
+      for (flatbuffers::uoffset_t i = 0; i < l->size(); i++) {
+        if (!Equals(l->Get(i), r->Get(i))) return false;
+      }
+    }
+  }
+  if (!Equals(lhs->enemy(), rhs->enemy())) return false;
+  if (!flatbuffers::EqualsVectorOfScalars(lhs->testnestedflatbuffer(), rhs->testnestedflatbuffer())) return false;
+  if (!Equals(lhs->testempty(), rhs->testempty())) return false;
+  if (lhs->testbool() != rhs->testbool()) return false;
+  if (lhs->testhashs32_fnv1() != rhs->testhashs32_fnv1()) return false;
+  if (lhs->testhashu32_fnv1() != rhs->testhashu32_fnv1()) return false;
+  if (lhs->testhashs64_fnv1() != rhs->testhashs64_fnv1()) return false;
+  if (lhs->testhashu64_fnv1() != rhs->testhashu64_fnv1()) return false;
+  if (lhs->testhashs32_fnv1a() != rhs->testhashs32_fnv1a()) return false;
+  if (lhs->testhashu32_fnv1a() != rhs->testhashu32_fnv1a()) return false;
+  if (lhs->testhashs64_fnv1a() != rhs->testhashs64_fnv1a()) return false;
+  if (lhs->testhashu64_fnv1a() != rhs->testhashu64_fnv1a()) return false;
+  if (!flatbuffers::EqualsVectorOfScalars(lhs->testarrayofbools(), rhs->testarrayofbools())) return false;
+  if (lhs->testf() != rhs->testf()) return false;
+  if (lhs->testf2() != rhs->testf2()) return false;
+  if (lhs->testf3() != rhs->testf3()) return false;
+  if (!flatbuffers::EqualsVectorOfStrings(lhs->testarrayofstring2(), rhs->testarrayofstring2())) return false;
+  if (!flatbuffers::EqualsVectorOfStructs(lhs->testarrayofsortedstruct(), rhs->testarrayofsortedstruct())) return false;
+  return true;
+}
+
+inline flatbuffers::hash_value_t HashOf(const Monster *obj, flatbuffers::hash_value_t hash) {
+  if (!obj) return hash;
+  hash = flatbuffers::HashStructFnv1a(obj->pos(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->mana(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->hp(), hash);
+  hash = flatbuffers::HashStringFnv1a(obj->name(), hash);
+  hash = flatbuffers::HashVectorOfScalarsFnv1a(obj->inventory(), hash);
+  hash = flatbuffers::HashScalarFnv1a(static_cast<int8_t>(obj->color()), hash);
+  hash = flatbuffers::HashScalarFnv1a(static_cast<uint8_t>(obj->test_type()), hash);
+  hash = HashAny(obj->test(), obj->test_type(), hash);
+  hash = flatbuffers::HashVectorOfStructsFnv1a(obj->test4(), hash);
+  hash = flatbuffers::HashVectorOfStringsFnv1a(obj->testarrayofstring(), hash);
+  {
+    auto vec = obj->testarrayoftables();
+    hash = flatbuffers::HashScalarFnv1a(vec ? vec->size() : 0, hash);
+    if (vec) {
+      for (flatbuffers::uoffset_t i = 0; i < vec->size(); i++) {
+        hash = HashOf(vec->Get(i), hash);
+      }
+    }
+  }
+  hash = HashOf(obj->enemy(), hash);
+  hash = flatbuffers::HashVectorOfScalarsFnv1a(obj->testnestedflatbuffer(), hash);
+  hash = HashOf(obj->testempty(), hash);
+  hash = flatbuffers::HashScalarFnv1a(static_cast<uint8_t>(obj->testbool()), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testhashs32_fnv1(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testhashu32_fnv1(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testhashs64_fnv1(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testhashu64_fnv1(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testhashs32_fnv1a(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testhashu32_fnv1a(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testhashs64_fnv1a(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testhashu64_fnv1a(), hash);
+  hash = flatbuffers::HashVectorOfScalarsFnv1a(obj->testarrayofbools(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testf(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testf2(), hash);
+  hash = flatbuffers::HashScalarFnv1a(obj->testf3(), hash);
+  hash = flatbuffers::HashVectorOfStringsFnv1a(obj->testarrayofstring2(), hash);
+  hash = flatbuffers::HashVectorOfStructsFnv1a(obj->testarrayofsortedstruct(), hash);
+  return hash;
+}
+
+inline flatbuffers::hash_value_t HashOf(const Monster *obj) {
+  return HashOf(obj, flatbuffers::FnvTraits<flatbuffers::hash_value_t>::kOffsetBasis);
+}
+
 inline const MyGame::Example::Monster *GetMonster(const void *buf) {
   return flatbuffers::GetRoot<MyGame::Example::Monster>(buf);
 }
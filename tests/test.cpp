@@ -296,6 +296,46 @@ void AccessFlatBufferTest(const uint8_t *flatbuf, size_t length,
   TEST_EQ(GetBufferStartFromRootPointer(monster), flatbuf);
 }
 
+// monster_test_generated.h is built with --gen-fast-verifiers, so every
+// VerifyMonsterBuffer call above and below already runs the specialized
+// verifiers. This checks their rejection behaviour on damaged buffers.
+void FastVerifierTest(const uint8_t *flatbuf, size_t length) {
+  // The canonical buffer passes, and is read right up to its last byte.
+  flatbuffers::Verifier verifier(flatbuf, length);
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  TEST_EQ(verifier.GetComputedSize(), length);
+
+  // Every truncation must fail: since verification covers the very last
+  // byte, any shorter buffer cuts off a range some extent check or offset
+  // chase still needs.
+  for (size_t len = 0; len < length; len++) {
+    flatbuffers::Verifier trunc_verifier(flatbuf, len);
+    TEST_EQ(VerifyMonsterBuffer(trunc_verifier), false);
+  }
+
+  // A root offset pointing at the end of the buffer must be rejected.
+  std::vector<uint8_t> corrupt(flatbuf, flatbuf + length);
+  flatbuffers::WriteScalar(corrupt.data(),
+                           static_cast<flatbuffers::uoffset_t>(length));
+  flatbuffers::Verifier root_verifier(corrupt.data(), length);
+  TEST_EQ(VerifyMonsterBuffer(root_verifier), false);
+  std::memcpy(corrupt.data(), flatbuf, sizeof(flatbuffers::uoffset_t));
+
+  // Single-bit corruptions: some remain valid buffers (e.g. a flip inside
+  // a scalar value), but whenever the verifier accepts one, it must only
+  // ever have claimed bytes inside the buffer.
+  for (size_t byte = 0; byte < length; byte++) {
+    for (int bit = 0; bit < 8; bit++) {
+      corrupt[byte] ^= static_cast<uint8_t>(1 << bit);
+      flatbuffers::Verifier bit_verifier(corrupt.data(), length);
+      if (VerifyMonsterBuffer(bit_verifier)) {
+        TEST_EQ(bit_verifier.GetComputedSize() <= length, true);
+      }
+      corrupt[byte] ^= static_cast<uint8_t>(1 << bit);
+    }
+  }
+}
+
 // Change a FlatBuffer in-place, after it has been constructed.
 void MutateFlatBuffersTest(uint8_t *flatbuf, std::size_t length) {
   // Get non-const pointer to root.
@@ -437,6 +477,543 @@ void ObjectFlatBuffersTest(uint8_t *flatbuf) {
   TEST_EQ(tests[1].b(), 40);
 }
 
+// Build a buffer from a (deliberately undersized) arena, forcing in-place
+// growth, and check the result is identical to a default-allocated one.
+void ArenaAllocatorTest() {
+  flatbuffers::arena_allocator arena(16384);
+  flatbuffers::FlatBufferBuilder fbb(64, &arena);
+  auto cheese = fbb.CreateString("cheese");
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int i = 0; i < 10; i++) {
+    monsters.push_back(CreateMonster(fbb, 0, 150, 80, cheese));
+  }
+  fbb.Finish(CreateMonster(fbb, 0, 200, 300, fbb.CreateString("bob"), 0,
+                           Color_Blue, Any_NONE, 0, 0, 0,
+                           fbb.CreateVector(monsters)));
+
+  flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(verifier.VerifyBuffer<Monster>(nullptr), true);
+  auto m = flatbuffers::GetRoot<Monster>(fbb.GetBufferPointer());
+  TEST_EQ(m->hp(), 300);
+  TEST_EQ(m->testarrayoftables()->size(), 10U);
+  TEST_EQ_STR(m->testarrayoftables()->Get(9)->name()->c_str(), "cheese");
+}
+
+// Build enough distinct vtable layouts to push EndTable's dedup onto its
+// hashed index, then repeat them, and check dedup still collapses repeats.
+static size_t BuildManyVtables(bool dedup) {
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.DedupVtables(dedup);
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int rep = 0; rep < 3; rep++) {
+    for (int16_t i = 0; i < 32; i++) {
+      auto name = fbb.CreateString("dedup");
+      // Vary which fields are present so each i yields a distinct vtable.
+      MonsterBuilder mb(fbb);
+      mb.add_name(name);
+      if (i & 1) mb.add_hp(i);
+      if (i & 2) mb.add_mana(i);
+      if (i & 4) mb.add_testf(1.0f);
+      if (i & 8) mb.add_testbool(true);
+      if (i & 16) mb.add_testhashs32_fnv1(i);
+      monsters.push_back(mb.Finish());
+    }
+  }
+  fbb.Finish(CreateMonster(fbb, 0, 200, 300, fbb.CreateString("root"), 0,
+                           Color_Blue, Any_NONE, 0, 0, 0,
+                           fbb.CreateVector(monsters)));
+  flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(verifier.VerifyBuffer<Monster>(nullptr), true);
+  auto m = flatbuffers::GetRoot<Monster>(fbb.GetBufferPointer());
+  TEST_EQ(m->testarrayoftables()->size(), 96U);
+  TEST_EQ(m->testarrayoftables()->Get(95)->hp(), 31);
+  return fbb.GetSize();
+}
+
+// Check CreateSharedString interning: equal contents must yield equal
+// offsets, including after the pool has grown past its initial size.
+void SharedStringTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<flatbuffers::String>> offsets;
+  for (int i = 0; i < 50; i++) {
+    offsets.push_back(fbb.CreateSharedString("str" + flatbuffers::NumToString(i)));
+  }
+  for (int i = 0; i < 50; i++) {
+    auto off = fbb.CreateSharedString("str" + flatbuffers::NumToString(i));
+    TEST_EQ(off.o, offsets[i].o);
+  }
+  // Distinct contents must not be interned together.
+  TEST_EQ(offsets[0].o != offsets[1].o, true);
+}
+
+void VtableDedupTest() {
+  // The repeated layouts must dedup away, so the deduped buffer is smaller.
+  TEST_EQ(BuildManyVtables(true) < BuildManyVtables(false), true);
+}
+
+// Write vector contents in place through the CreateUninitializedVector
+// family, rather than staging them in a temporary array first.
+void UninitializedVectorTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  uint8_t *inv = nullptr;
+  auto inv_off = fbb.CreateUninitializedVector(10, &inv);
+  for (uint8_t i = 0; i < 10; i++) inv[i] = i;
+  Test *tests = nullptr;
+  auto test4_off = fbb.CreateUninitializedVectorOfStructs(2, &tests);
+  tests[0] = Test(10, 20);
+  tests[1] = Test(30, 40);
+  fbb.Finish(CreateMonster(fbb, 0, 150, 80, fbb.CreateString("uninit"),
+                           inv_off, Color_Blue, Any_NONE, 0, test4_off));
+
+  flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(verifier.VerifyBuffer<Monster>(nullptr), true);
+  auto m = flatbuffers::GetRoot<Monster>(fbb.GetBufferPointer());
+  TEST_EQ(m->inventory()->size(), 10U);
+  TEST_EQ(m->inventory()->Get(9), 9);
+  TEST_EQ(m->test4()->size(), 2U);
+  TEST_EQ(m->test4()->Get(1)->a(), 30);
+  TEST_EQ(m->test4()->Get(1)->b(), 40);
+}
+
+// Build vectors one element at a time with VectorStreamer, without any
+// intermediate element array. Forward fill exercises the in-place reversal
+// (and, for the odd-length byte vector, the length-field alignment slide);
+// reverse fill lands elements directly.
+void VectorStreamerTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+
+  // Offsets, forward order: stored relative offsets must be rebased when
+  // the elements are flipped into place. As with any other vector build,
+  // the subobjects have to be serialized before the vector is started.
+  const char *names[] = { "Herman", "Horst", "Hein" };
+  flatbuffers::Offset<flatbuffers::String> name_offs[3];
+  for (int i = 0; i < 3; i++) name_offs[i] = fbb.CreateString(names[i]);
+  flatbuffers::VectorStreamer<flatbuffers::Offset<flatbuffers::String>>
+      strings(fbb);
+  for (int i = 0; i < 3; i++) strings.Push(name_offs[i]);
+  TEST_EQ(strings.Count(), 3U);
+  auto strings_off = strings.Finish();
+
+  // Scalars, forward order, odd byte count: the length field needs padding,
+  // which Finish() creates by sliding the elements down.
+  flatbuffers::VectorStreamer<uint8_t> inv(fbb);
+  for (uint8_t i = 0; i < 5; i++) inv.Push(i);
+  auto inv_off = inv.Finish();
+
+  // Structs, reverse order: the last element is pushed first and lands in
+  // its final position straight away.
+  flatbuffers::VectorStreamer<Test> tests(
+      fbb, flatbuffers::VectorStreamer<Test>::kReverse);
+  tests.Push(Test(30, 40));
+  tests.Push(Test(10, 20));
+  auto test4_off = tests.Finish();
+
+  fbb.Finish(CreateMonster(fbb, 0, 150, 80, fbb.CreateString("streamed"),
+                           inv_off, Color_Blue, Any_NONE, 0, test4_off,
+                           strings_off));
+
+  flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(verifier.VerifyBuffer<Monster>(nullptr), true);
+  auto m = flatbuffers::GetRoot<Monster>(fbb.GetBufferPointer());
+  TEST_EQ(m->inventory()->size(), 5U);
+  for (uint8_t i = 0; i < 5; i++) TEST_EQ(m->inventory()->Get(i), i);
+  TEST_EQ(m->test4()->size(), 2U);
+  TEST_EQ(m->test4()->Get(0)->a(), 10);
+  TEST_EQ(m->test4()->Get(1)->b(), 40);
+  TEST_EQ(m->testarrayofstring()->size(), 3U);
+  for (int i = 0; i < 3; i++) {
+    TEST_EQ(strcmp(m->testarrayofstring()->Get(i)->c_str(), names[i]), 0);
+  }
+}
+
+// Exercise the bulk endian-conversion kernels. EndianSwapBuffer must swap
+// regardless of host order; EndianCopy converts between native and wire
+// order, which on a little endian host is a straight copy.
+void EndianKernelTest() {
+  uint32_t buf[3] = { 0x01020304, 0x05060708, 0x090A0B0C };
+  flatbuffers::EndianSwapBuffer(buf, 3);
+  TEST_EQ(buf[0], 0x04030201U);
+  TEST_EQ(buf[2], 0x0C0B0A09U);
+
+  // Round-trip a scalar vector through the builder's bulk path and read it
+  // back out with the batch helper.
+  flatbuffers::FlatBufferBuilder fbb;
+  int32_t src[4] = { -1, 0, 0x12345678, -0x12345678 };
+  auto vec_off = fbb.CreateVector(src, 4);
+  fbb.Finish(CreateStat(fbb, 0, 0, 0));  // Any root, to finish the buffer.
+  auto vec = flatbuffers::GetTemporaryPointer(fbb, vec_off);
+  TEST_EQ(vec->size(), 4U);
+  int32_t dst[4] = { 0, 0, 0, 0 };
+  vec->CopyToNative(dst, 0, 4);
+  for (int i = 0; i < 4; i++) TEST_EQ(dst[i], src[i]);
+}
+
+// Compose a buffer out of independently finished sub-buffers, as worker
+// threads would produce, and check the spliced subtrees read back intact.
+void SpliceBufferTest() {
+  // Each of these builders could live on its own thread; they share no
+  // state with each other or with the parent until SpliceBuffer.
+  flatbuffers::FlatBufferBuilder workers[4];
+  for (int i = 0; i < 4; i++) {
+    auto name = workers[i].CreateString("worker" +
+                                        flatbuffers::NumToString(i));
+    workers[i].Finish(CreateMonster(workers[i], 0, 150,
+                                    static_cast<int16_t>(i), name));
+  }
+
+  flatbuffers::FlatBufferBuilder parent;
+  std::vector<flatbuffers::Offset<Monster>> roots;
+  for (int i = 0; i < 4; i++) {
+    roots.push_back(parent.SpliceBuffer<Monster>(workers[i]));
+  }
+  parent.Finish(CreateMonster(parent, 0, 200, 300,
+                              parent.CreateString("parent"), 0, Color_Blue,
+                              Any_NONE, 0, 0, 0,
+                              parent.CreateVector(roots)));
+
+  flatbuffers::Verifier verifier(parent.GetBufferPointer(),
+                                 parent.GetSize());
+  TEST_EQ(verifier.VerifyBuffer<Monster>(nullptr), true);
+  auto m = flatbuffers::GetRoot<Monster>(parent.GetBufferPointer());
+  TEST_EQ(m->testarrayoftables()->size(), 4U);
+  for (flatbuffers::uoffset_t i = 0; i < 4; i++) {
+    auto sub = m->testarrayoftables()->Get(i);
+    TEST_EQ(sub->hp(), static_cast<int16_t>(i));
+    TEST_EQ_STR(sub->name()->c_str(),
+                ("worker" + flatbuffers::NumToString(i)).c_str());
+  }
+}
+
+// Stream several size-prefixed messages through a StreamWriter and walk
+// them back out of the resulting byte region.
+void StreamWriterTest() {
+  std::ostringstream out;
+  flatbuffers::StreamWriter writer(out);
+  for (int16_t i = 0; i < 3; i++) {
+    auto &fbb = writer.builder();
+    TEST_EQ(writer.WriteMessage(
+                CreateMonster(fbb, 0, 150, i, fbb.CreateString("stream"))),
+            true);
+  }
+  auto log = out.str();
+  TEST_EQ(log.size(), writer.offset());
+
+  auto region = reinterpret_cast<const uint8_t *>(log.data());
+  size_t offset = 0;
+  int16_t num_messages = 0;
+  while (auto msg = flatbuffers::NextSizePrefixedMessage(region, log.size(),
+                                                         &offset)) {
+    auto size = flatbuffers::ReadScalar<flatbuffers::uoffset_t>(msg);
+    flatbuffers::Verifier verifier(msg, size + sizeof(flatbuffers::uoffset_t));
+    TEST_EQ(verifier.VerifySizePrefixedBuffer<Monster>(nullptr), true);
+    auto m = flatbuffers::GetSizePrefixedRoot<Monster>(msg);
+    TEST_EQ(m->hp(), num_messages);
+    TEST_EQ_STR(m->name()->c_str(), "stream");
+    num_messages++;
+  }
+  TEST_EQ(num_messages, 3);
+}
+
+void BuilderStatsTest() {
+  // Small initial size so the buffer has to regrow.
+  flatbuffers::FlatBufferBuilder fbb(16);
+  auto &stats = fbb.stats();
+
+  // Two tables with identical layout: the second vtable gets deduped.
+  auto m1 = CreateMonster(fbb, 0, 150, 1, fbb.CreateString("stats1"));
+  auto m2 = CreateMonster(fbb, 0, 150, 2, fbb.CreateString("stats2"));
+  auto stat = CreateStat(fbb, fbb.CreateString("id"), 0, 0);
+  auto wrapper_name = fbb.CreateString("wrapper");
+  MonsterBuilder mb(fbb);
+  mb.add_name(wrapper_name);
+  mb.add_enemy(m1);
+  mb.add_testempty(stat);
+  (void)m2;
+  fbb.Finish(mb.Finish());
+
+  TEST_EQ(stats.finished_buffers, 1U);
+  TEST_EQ(stats.finished_bytes, static_cast<uint64_t>(fbb.GetSize()));
+  // Three distinct layouts (two of them Monster, deduped) plus Stat.
+  TEST_EQ(stats.vtables_written, 3U);
+  TEST_EQ(stats.vtables_deduped, 1U);
+  TEST_EQ(stats.vtable_bytes_saved > 0, true);
+  TEST_EQ(stats.regrowths > 0, true);
+  TEST_EQ(stats.regrown_bytes > 0, true);
+  TEST_EQ(stats.align_calls > 0, true);
+
+  // Counters accumulate across Clear() but reset on demand.
+  fbb.Clear();
+  TEST_EQ(stats.finished_buffers, 1U);
+  fbb.ResetStats();
+  TEST_EQ(stats.finished_buffers, 0U);
+  TEST_EQ(stats.vtables_written, 0U);
+  TEST_EQ(stats.regrowths, 0U);
+}
+
+void ArchiveTest() {
+  // Write an archive of monsters, appended in increasing key (name) order.
+  std::ostringstream out;
+  flatbuffers::ArchiveWriter writer(out);
+  const char *names[] = { "alice", "bob", "carol", "dave" };
+  for (int16_t i = 0; i < 4; i++) {
+    auto &fbb = writer.builder();
+    TEST_EQ(writer.Append(
+                CreateMonster(fbb, 0, 150, i, fbb.CreateString(names[i]))),
+            true);
+  }
+  TEST_EQ(writer.num_records(), static_cast<size_t>(4));
+  TEST_EQ(writer.Finish(), true);
+
+  auto file = out.str();
+  auto region = reinterpret_cast<const uint8_t *>(file.data());
+  flatbuffers::ArchiveReader reader(region, file.size());
+  TEST_EQ(reader.Valid(), true);
+  TEST_EQ(reader.num_records(), static_cast<size_t>(4));
+  // O(1) access to any record, usable in place.
+  for (int16_t i = 3; i >= 0; i--) {
+    auto msg = reader.Record(static_cast<size_t>(i));
+    auto size = flatbuffers::ReadScalar<flatbuffers::uoffset_t>(msg);
+    flatbuffers::Verifier verifier(msg, size + sizeof(flatbuffers::uoffset_t));
+    TEST_EQ(verifier.VerifySizePrefixedBuffer<Monster>(nullptr), true);
+    TEST_EQ(reader.RecordRoot<Monster>(static_cast<size_t>(i))->hp(), i);
+  }
+  // Keyed binary search over the records.
+  auto carol = reader.LookupRecord<Monster>("carol");
+  TEST_NOTNULL(carol);
+  TEST_EQ(carol->hp(), 2);
+  TEST_EQ(reader.LookupRecord<Monster>("mallory") == nullptr, true);
+  // A region without a footer is rejected.
+  flatbuffers::ArchiveReader bogus(region, 7);
+  TEST_EQ(bogus.Valid(), false);
+}
+
+// Release a finished buffer as a DetachedBuffer, move it around, and hand
+// its memory back to a builder with Reattach.
+void DetachedBufferTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(CreateMonster(fbb, 0, 150, 123, fbb.CreateString("detached")));
+  auto detached = fbb.Release();
+
+  flatbuffers::Verifier verifier(detached.data(), detached.size());
+  TEST_EQ(verifier.VerifyBuffer<Monster>(nullptr), true);
+  auto m = flatbuffers::GetRoot<Monster>(detached.data());
+  TEST_EQ(m->hp(), 123);
+
+  // Moving transfers ownership; the moved-from buffer is empty.
+  flatbuffers::DetachedBuffer moved(std::move(detached));
+  TEST_EQ(detached.data() == nullptr, true);
+  TEST_EQ(flatbuffers::GetRoot<Monster>(moved.data())->hp(), 123);
+
+  // Reuse the allocation for the next message.
+  fbb.Reattach(std::move(moved));
+  fbb.Finish(CreateMonster(fbb, 0, 150, 456, fbb.CreateString("again")));
+  TEST_EQ(flatbuffers::GetRoot<Monster>(fbb.GetBufferPointer())->hp(), 456);
+}
+
+void SharedBufferTest() {
+  // A custom release callback runs exactly once, when the last handle
+  // (copies and moves included) goes away.
+  int released = 0;
+  auto count_release = [](const uint8_t *, void *userdata) {
+    (*static_cast<int *>(userdata))++;
+  };
+  auto bytes = static_cast<uint8_t *>(malloc(4));
+  memset(bytes, 0, 4);
+  {
+    flatbuffers::SharedBuffer outer;
+    {
+      flatbuffers::SharedBuffer shared(bytes, 4, count_release, &released);
+      TEST_EQ(shared.use_count(), 1);
+      auto copy = shared;
+      TEST_EQ(shared.use_count(), 2);
+      outer = copy;
+      flatbuffers::SharedBuffer moved(std::move(copy));
+      TEST_EQ(copy.data() == nullptr, true);
+      TEST_EQ(shared.use_count(), 3);
+    }
+    TEST_EQ(outer.use_count(), 1);
+    TEST_EQ(released, 0);
+  }
+  TEST_EQ(released, 1);
+  free(bytes);
+
+  // Adopting a DetachedBuffer shares a finished message without copying,
+  // and SharedBufferRefs of it are copyable, unlike plain BufferRefs.
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(CreateMonster(fbb, 0, 150, 17, fbb.CreateString("shared")));
+  flatbuffers::SharedBuffer message(fbb.Release());
+  TEST_EQ(message.GetRoot<Monster>()->hp(), 17);
+  {
+    flatbuffers::SharedBufferRef<Monster> ref1(message);
+    auto ref2 = ref1;
+    TEST_EQ(message.use_count(), 3);
+    TEST_EQ(ref2.Verify(), true);
+    TEST_EQ(ref1.GetRoot()->hp(), 17);
+    TEST_EQ(ref2.GetRoot() == ref1.GetRoot(), true);
+  }
+  TEST_EQ(message.use_count(), 1);
+  // Release() empties the handle early; the last owner still frees.
+  auto keep = message;
+  message.Release();
+  TEST_EQ(message.data() == nullptr, true);
+  TEST_EQ(keep.GetRoot<Monster>()->hp(), 17);
+}
+
+// Shard verification of a root vector of tables over a "pool" (run inline
+// here; the scheduler contract only requires completion before return).
+void ParallelVerifyTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int16_t i = 0; i < 100; i++) {
+    monsters.push_back(CreateMonster(fbb, 0, 150, i,
+                                     fbb.CreateString("shard")));
+  }
+  fbb.Finish(CreateMonster(fbb, 0, 200, 300, fbb.CreateString("root"), 0,
+                           Color_Blue, Any_NONE, 0, 0, 0,
+                           fbb.CreateVector(monsters)));
+
+  auto m = flatbuffers::GetRoot<Monster>(fbb.GetBufferPointer());
+  auto vec = m->testarrayoftables();
+  auto parallel_for = [](size_t n,
+                         const std::function<void(size_t)> &fn) {
+    for (size_t i = 0; i < n; i++) fn(i);
+  };
+
+  flatbuffers::Verifier verifier(fbb.GetBufferPointer(), fbb.GetSize());
+  TEST_EQ(verifier.Verify(vec), true);
+  TEST_EQ(verifier.VerifyVectorOfTablesParallel(vec, parallel_for, 4), true);
+  // (No negative case here: this test binary builds the verifier with
+  // FLATBUFFERS_DEBUG_VERIFICATION_FAILURE, which asserts on any failed
+  // Check.)
+}
+
+// Build an Eytzinger side index over a sorted vector of tables and check
+// lookups land on the right elements (and misses stay misses).
+void EytzingerIndexTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<Stat>> stats;
+  std::vector<int64_t> keys;
+  for (int64_t i = 0; i < 50; i++) {
+    stats.push_back(CreateStat(fbb, fbb.CreateString("stat"), i * 2,
+                               static_cast<uint16_t>(i)));
+    keys.push_back(i * 2);  // Sorted by construction.
+  }
+  auto vec_off = fbb.CreateVector(stats);
+  flatbuffers::Offset<flatbuffers::Vector<flatbuffers::uoffset_t>> pos_off;
+  auto keys_off = fbb.CreateEytzingerIndex(
+      flatbuffers::data(keys), keys.size(), &pos_off);
+  fbb.Finish(CreateStat(fbb, 0, 0, 0));  // Any root, to finish the buffer.
+
+  auto vec = flatbuffers::GetTemporaryPointer(fbb, vec_off);
+  auto index_keys = flatbuffers::GetTemporaryPointer(fbb, keys_off);
+  auto index_pos = flatbuffers::GetTemporaryPointer(fbb, pos_off);
+  for (int64_t i = 0; i < 50; i++) {
+    auto stat = flatbuffers::LookupByKeyFast(vec, index_keys, index_pos,
+                                             i * 2);
+    TEST_NOTNULL(stat);
+    TEST_EQ(stat->val(), i * 2);
+    TEST_EQ(stat->count(), static_cast<uint16_t>(i));
+    // Odd keys are absent.
+    TEST_EQ(flatbuffers::LookupByKeyFast(vec, index_keys, index_pos,
+                                         i * 2 + 1) == nullptr, true);
+  }
+}
+
+// Resolve vector elements through GetBatch and check it agrees with Get()
+// for both table and scalar vectors.
+void GetBatchTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int16_t i = 0; i < 20; i++) {
+    monsters.push_back(CreateMonster(fbb, 0, 150, i,
+                                     fbb.CreateString("batch")));
+  }
+  std::vector<uint8_t> bytes(20);
+  for (uint8_t i = 0; i < 20; i++) bytes[i] = i;
+  fbb.Finish(CreateMonster(fbb, 0, 200, 300, fbb.CreateString("root"),
+                           fbb.CreateVector(bytes), Color_Blue, Any_NONE, 0,
+                           0, 0, fbb.CreateVector(monsters)));
+
+  auto m = flatbuffers::GetRoot<Monster>(fbb.GetBufferPointer());
+  const Monster *batch[8];
+  m->testarrayoftables()->GetBatch(4, 8, batch);
+  for (flatbuffers::uoffset_t i = 0; i < 8; i++) {
+    TEST_EQ(batch[i], m->testarrayoftables()->Get(4 + i));
+    TEST_EQ(batch[i]->hp(), static_cast<int16_t>(4 + i));
+  }
+  uint8_t scalars[20];
+  m->inventory()->GetBatch(0, 20, scalars);
+  for (flatbuffers::uoffset_t i = 0; i < 20; i++) {
+    TEST_EQ(scalars[i], m->inventory()->Get(i));
+  }
+}
+
+// Unpack objects from an arena and release them wholesale.
+void ObjectArenaTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  fbb.Finish(CreateMonster(fbb, 0, 150, 50, fbb.CreateString("arena"),
+                           fbb.CreateVector(std::vector<uint8_t>(10, 7))));
+  auto m = flatbuffers::GetRoot<Monster>(fbb.GetBufferPointer());
+
+  flatbuffers::ObjectArena arena(256);
+  // Unpack enough copies to force the arena onto multiple blocks.
+  for (int reuse = 0; reuse < 2; reuse++) {
+    std::vector<MonsterT *> monsters;
+    for (int i = 0; i < 50; i++) {
+      monsters.push_back(m->UnPack(arena));
+    }
+    for (size_t i = 0; i < monsters.size(); i++) {
+      TEST_EQ(monsters[i]->hp, 50);
+      TEST_EQ_STR(monsters[i]->name.c_str(), "arena");
+      TEST_EQ(monsters[i]->inventory.size(), static_cast<size_t>(10));
+    }
+    // Destroys all unpacked objects at once; the arena is usable again.
+    arena.Reset();
+  }
+}
+
+// Extract one field column-wise across a vector of tables (--gen-columnar).
+void ColumnExtractTest() {
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<Monster>> monsters;
+  for (int16_t i = 0; i < 10; i++) {
+    // Even monsters leave mana at its default, so it is absent from the
+    // buffer and the extractor must fill in the default.
+    monsters.push_back(CreateMonster(fbb, 0, i % 2 ? i * 3 : 150, i,
+                                     fbb.CreateString("col")));
+  }
+  fbb.Finish(CreateMonster(fbb, 0, 200, 300, fbb.CreateString("root"), 0,
+                           Color_Blue, Any_NONE, 0, 0, 0,
+                           fbb.CreateVector(monsters)));
+  auto m = flatbuffers::GetRoot<Monster>(fbb.GetBufferPointer());
+  int16_t hps[10];
+  ExtractMonsterHp(m->testarrayoftables(), hps);
+  int16_t manas[10];
+  ExtractMonsterMana(m->testarrayoftables(), manas);
+  for (int16_t i = 0; i < 10; i++) {
+    TEST_EQ(hps[i], i);
+    TEST_EQ(manas[i], i % 2 ? i * 3 : 150);
+  }
+}
+
+// The fast number formatting must agree with what stringstream produced.
+void NumToStringTest() {
+  TEST_EQ_STR(flatbuffers::NumToString(0).c_str(), "0");
+  TEST_EQ_STR(flatbuffers::NumToString(42).c_str(), "42");
+  TEST_EQ_STR(flatbuffers::NumToString(-12345).c_str(), "-12345");
+  TEST_EQ_STR(flatbuffers::NumToString(-9223372036854775807LL - 1).c_str(),
+              "-9223372036854775808");
+  TEST_EQ_STR(flatbuffers::NumToString(18446744073709551615ULL).c_str(),
+              "18446744073709551615");
+  TEST_EQ_STR(flatbuffers::NumToString(static_cast<signed char>(-5)).c_str(),
+              "-5");
+  TEST_EQ_STR(flatbuffers::NumToString(3.5).c_str(), "3.5");
+  TEST_EQ_STR(flatbuffers::NumToString(1.0).c_str(), "1");
+  TEST_EQ_STR(flatbuffers::NumToString(-0.25).c_str(), "-0.25");
+  TEST_EQ_STR(flatbuffers::IntToStringHex(0x23, 8).c_str(), "00000023");
+  TEST_EQ_STR(flatbuffers::IntToStringHex(0xBEEF, 4).c_str(), "BEEF");
+}
+
 // Prefix a FlatBuffer with a size field.
 void SizePrefixedTest() {
   // Create size prefixed buffer.
@@ -546,6 +1123,27 @@ void ReflectionTest(uint8_t *flatbuf, size_t length) {
   auto hp_string = flatbuffers::GetAnyFieldS(root, hp_field, &schema);
   TEST_EQ_STR(hp_string.c_str(), "80");
 
+  // For bulk extraction, resolve the schema lookups once into a plan and
+  // read fields through that.
+  std::vector<const reflection::Field *> plan_fields;
+  plan_fields.push_back(&hp_field);
+  plan_fields.push_back(fields->LookupByKey("mana"));
+  plan_fields.push_back(fields->LookupByKey("name"));
+  flatbuffers::FieldAccessPlan plan(*root_table, plan_fields);
+  TEST_EQ(plan.num_fields(), static_cast<size_t>(3));
+  int64_t row_i[3];
+  plan.ExtractI(root, row_i);
+  TEST_EQ(row_i[0], 80);
+  TEST_EQ(row_i[1], 150);  // mana is absent: schema default.
+  double row_f[3];
+  plan.ExtractF(root, row_f);
+  TEST_EQ(row_f[0], 80.0);
+  const uint8_t *row_addr[3];
+  plan.ExtractAddressOf(root, row_addr);
+  TEST_EQ(row_addr[0] == root.GetAddressOf(hp_field.offset()), true);
+  TEST_EQ(row_addr[1] == nullptr, true);  // mana not present in the buffer.
+  TEST_NOTNULL(row_addr[2]);
+
   // Get struct field through reflection
   auto pos_struct = flatbuffers::GetFieldStruct(root, *pos_field_ptr);
   TEST_NOTNULL(pos_struct);
@@ -652,6 +1250,32 @@ void ReflectionTest(uint8_t *flatbuf, size_t length) {
   SetFieldT(*rroot, name_field, string_ptr);
   TEST_EQ_STR(GetFieldS(**rroot, name_field)->c_str(), "hank");
 
+  // Multiple resizes can also be batched into a mutation session, which
+  // fixes up the buffer once for the whole lot rather than once per call.
+  // Mutations get queued against the buffer as it is now; pointers into
+  // the buffer (including piv ones, whose offset may shift) must be
+  // re-acquired after Apply().
+  flatbuffers::BufferMutationSession session(schema, &resizingbuf);
+  session.SetString(rtestarrayofstring->Get(0), "robert");
+  session.SetString(rtestarrayofstring->Get(1), "frederick");
+  session.ResizeVector<uint8_t>(*rinventory, 115);
+  session.Apply();
+  auto sroot = flatbuffers::GetAnyRoot(resizingbuf.data());
+  auto sarrayofstring =
+      flatbuffers::GetFieldV<flatbuffers::Offset<flatbuffers::String>>(
+          *sroot, testarrayofstring_field);
+  TEST_EQ_STR(sarrayofstring->Get(0)->c_str(), "robert");
+  TEST_EQ_STR(sarrayofstring->Get(1)->c_str(), "frederick");
+  auto sinventory = flatbuffers::GetFieldV<uint8_t>(*sroot, inventory_field);
+  TEST_EQ(sinventory->size(), 115);
+  TEST_EQ(sinventory->Get(10), 50);
+  TEST_EQ(sinventory->Get(114), 0);
+  flatbuffers::Verifier session_verifier(resizingbuf.data(),
+                                         resizingbuf.size());
+  TEST_EQ(VerifyMonsterBuffer(session_verifier), true);
+  TEST_EQ(flatbuffers::Verify(schema, *schema.root_table(), resizingbuf.data(),
+                              resizingbuf.size()), true);
+
   // Using reflection, rather than mutating binary FlatBuffers, we can also copy
   // tables and other things out of other FlatBuffers into a FlatBufferBuilder,
   // either part or whole.
@@ -666,6 +1290,20 @@ void ReflectionTest(uint8_t *flatbuf, size_t length) {
   // Test buffer is valid using reflection as well
   TEST_EQ(flatbuffers::Verify(schema, *schema.root_table(),
                               fbb.GetBufferPointer(), fbb.GetSize()), true);
+
+  // Subtrees can also be sliced out with a bulk copy instead of a
+  // field-by-field rebuild, since all offsets within them are relative.
+  std::vector<uint8_t> subtree;
+  flatbuffers::ExtractSubtree(schema, *root_table,
+                              *flatbuffers::GetAnyRoot(flatbuf), &subtree);
+  // The extracted buffer carries no file identifier, so verify and read it
+  // through reflection.
+  TEST_EQ(flatbuffers::Verify(schema, *schema.root_table(), subtree.data(),
+                              subtree.size()), true);
+  auto &subroot = *flatbuffers::GetAnyRoot(subtree.data());
+  TEST_EQ(flatbuffers::GetAnyFieldI(subroot, hp_field), 80);
+  TEST_EQ_STR(flatbuffers::GetAnyFieldS(subroot, name_field, &schema).c_str(),
+              "MyMonster");
 }
 
 // Parse a .proto schema, output as .fbs
@@ -1095,6 +1733,139 @@ void IntegerOutOfRangeTest() {
             "constant does not fit");
 }
 
+void ParseAndGenerateTextFromBinarySchemaTest() {
+  // load the binary schema (.bfbs) and JSON from disk
+  std::string bfbsfile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.bfbs", true, &bfbsfile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+
+  // Initialize the parser from the binary schema: no schema text involved.
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Deserialize(
+            reinterpret_cast<const uint8_t *>(bfbsfile.c_str()),
+            bfbsfile.length()), true);
+  TEST_EQ(parser.Parse(jsonfile.c_str()), true);
+
+  flatbuffers::Verifier verifier(parser.builder_.GetBufferPointer(),
+                                 parser.builder_.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+
+  // The generated text must match what the text-schema-based path produces.
+  std::string jsongen;
+  auto result = GenerateText(parser, parser.builder_.GetBufferPointer(),
+                             &jsongen);
+  TEST_EQ(result, true);
+
+  if (jsongen != jsonfile) {
+    printf("%s----------------\n%s", jsongen.c_str(), jsonfile.c_str());
+    TEST_NOTNULL(NULL);
+  }
+}
+
+void SchemaCacheTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+  const char *include_directories[] = { "tests", nullptr };
+
+  // The schema the cached runs must reproduce exactly.
+  flatbuffers::Parser plain;
+  TEST_EQ(plain.Parse(schemafile.c_str(), include_directories), true);
+  plain.Serialize();
+  std::string expected(
+      reinterpret_cast<const char *>(plain.builder_.GetBufferPointer()),
+      plain.builder_.GetSize());
+
+  flatbuffers::IDLOptions opts;
+  opts.use_schema_cache = true;
+  // The first run writes .bfbsc artifacts next to the include files, the
+  // second run loads them; both must match an uncached parse.
+  for (int i = 0; i < 2; i++) {
+    flatbuffers::Parser parser(opts);
+    TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+    parser.Serialize();
+    std::string serialized(
+        reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+        parser.builder_.GetSize());
+    TEST_EQ(serialized == expected, true);
+    // The merged schema must still parse data normally:
+    TEST_EQ(parser.Parse(jsonfile.c_str(), include_directories), true);
+    flatbuffers::Verifier verifier(parser.builder_.GetBufferPointer(),
+                                   parser.builder_.GetSize());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  }
+
+  remove("tests/include_test1.fbs.bfbsc");
+  remove("tests/include_test2.fbs.bfbsc");
+}
+
+void ParserReuseTest() {
+  std::string schemafile;
+  std::string jsonfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.fbs", false, &schemafile), true);
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monsterdata_test.golden", false, &jsonfile), true);
+  const char *include_directories[] = { "tests", nullptr };
+
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse(schemafile.c_str(), include_directories), true);
+
+  // The same parser can ingest many documents without re-parsing the
+  // schema; each ParseJson() resets the previous document's state.
+  for (int i = 0; i < 3; i++) {
+    TEST_EQ(parser.ParseJson(jsonfile.c_str()), true);
+    flatbuffers::Verifier verifier(parser.builder_.GetBufferPointer(),
+                                   parser.builder_.GetSize());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  }
+
+  // Reset() releases the last document without touching the schema.
+  parser.Reset();
+  TEST_EQ(parser.builder_.GetSize(), 0);
+  TEST_EQ(parser.ParseJson("{ name: \"Fred\", hp: 20 }"), true);
+  {
+    flatbuffers::Verifier verifier(parser.builder_.GetBufferPointer(),
+                                   parser.builder_.GetSize());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+    TEST_EQ_STR(GetMonster(parser.builder_.GetBufferPointer())->name()
+                  ->c_str(), "Fred");
+  }
+
+  // Views share the compiled schema read-only, each with its own builder
+  // and error state, as one would use per thread.
+  flatbuffers::Parser view1, view2;
+  view1.UseSharedSchema(parser);
+  view2.UseSharedSchema(parser);
+  TEST_EQ(view1.ParseJson(jsonfile.c_str()), true);
+  TEST_EQ(view2.ParseJson("{ name: \"Barney\", color: \"Blue\" }"), true);
+  {
+    flatbuffers::Verifier verifier(view1.builder_.GetBufferPointer(),
+                                   view1.builder_.GetSize());
+    TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  }
+  TEST_EQ(GetMonster(view2.builder_.GetBufferPointer())->color(), Color_Blue);
+
+  // A failed document leaves an error on its own view only, and the view
+  // recovers on the next document.
+  TEST_EQ(view2.ParseJson("{ nosuchfield: 1 }"), false);
+  TEST_EQ(view2.error_.length() > 0, true);
+  TEST_EQ(view1.error_.length(), 0);
+  TEST_EQ(view2.ParseJson("{ name: \"Wilma\" }"), true);
+
+  // The round trip through a view matches the owning parser's output.
+  std::string jsongen;
+  TEST_EQ(GenerateText(view1, view1.builder_.GetBufferPointer(), &jsongen),
+          true);
+  TEST_EQ(jsongen == jsonfile, true);
+}
+
 void UnicodeTest() {
   flatbuffers::Parser parser;
   // Without setting allow_non_utf8 = true, we treat \x sequences as byte sequences
@@ -1163,6 +1934,28 @@ void UnicodeSurrogatesTest() {
   TEST_EQ(strcmp(string->c_str(), "\xF0\x9F\x92\xA9"), 0);
 }
 
+void LongStringLexTest() {
+  // Exercise the bulk span scanning in the string lexer with a constant
+  // that is much longer than one SIMD chunk and mixes plain runs with
+  // escapes at various (mis)alignments.
+  std::string value;
+  std::string json = "{ F:\"";
+  for (int i = 0; i < 10; i++) {
+    std::string run(static_cast<size_t>(i * 7 + 1), 'a' + static_cast<char>(i));
+    value += run + "\t\"";
+    json += run + "\\t\\\"";
+  }
+  json += "\" }";
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse(("table T { F:string (id: 0); }"
+                        "root_type T;" + json).c_str()), true);
+  auto root = flatbuffers::GetRoot<flatbuffers::Table>(
+    parser.builder_.GetBufferPointer());
+  auto string = root->GetPointer<flatbuffers::String *>(
+    flatbuffers::FieldIndexToOffset(0));
+  TEST_EQ_STR(string->c_str(), value.c_str());
+}
+
 void UnicodeInvalidSurrogatesTest() {
   TestError(
     "table T { F:string; }"
@@ -1394,6 +2187,168 @@ void ConformTest() {
   test_conform("enum E:byte { B, A }", "values differ for enum");
 }
 
+void SchemaEvolutionTest() {
+  // Version 1 of a schema, and a record written under it.
+  const char *v1 =
+    "table Weapon { name:string (key); damage:short; }"
+    "table Monster { name:string (required); hp:short = 100; mana:short;"
+    "  inventory:[ubyte]; weapons:[Weapon]; legacy:int; }"
+    "root_type Monster;";
+  // Version 2 drops "legacy" and adds "level"; everything else matches.
+  const char *v2 =
+    "table Weapon { name:string (key); damage:short; }"
+    "table Monster { name:string (required); hp:short = 100; mana:short;"
+    "  inventory:[ubyte]; weapons:[Weapon]; level:short = 1; }"
+    "root_type Monster;";
+  flatbuffers::Parser src_parser, dst_parser;
+  TEST_EQ(src_parser.Parse(v1), true);
+  src_parser.Serialize();
+  std::string src_bfbs(
+      reinterpret_cast<const char *>(src_parser.builder_.GetBufferPointer()),
+      src_parser.builder_.GetSize());
+  TEST_EQ(dst_parser.Parse(v2), true);
+  dst_parser.Serialize();
+  std::string dst_bfbs(
+      reinterpret_cast<const char *>(dst_parser.builder_.GetBufferPointer()),
+      dst_parser.builder_.GetSize());
+  auto &src_schema = *reflection::GetSchema(src_bfbs.c_str());
+  auto &dst_schema = *reflection::GetSchema(dst_bfbs.c_str());
+
+  TEST_EQ(src_parser.ParseJson(
+    "{ name: \"Orc\", hp: 80, inventory: [1, 2, 3], weapons:"
+    "  [{ name: \"Axe\", damage: 5 }, { name: \"Bow\", damage: 3 }],"
+    "  legacy: 99 }"), true);
+
+  // Migrate the record to version 2, binary to binary.
+  flatbuffers::SchemaTranscoder transcoder(src_schema, dst_schema);
+  TEST_EQ(transcoder.Valid(), true);
+  flatbuffers::FlatBufferBuilder fbb;
+  TEST_EQ(transcoder.Transcode(src_parser.builder_.GetBufferPointer(), fbb),
+          true);
+  TEST_EQ(flatbuffers::Verify(dst_schema, *dst_schema.root_table(),
+                              fbb.GetBufferPointer(), fbb.GetSize()), true);
+  auto root = flatbuffers::GetAnyRoot(fbb.GetBufferPointer());
+  auto fields = dst_schema.root_table()->fields();
+  TEST_EQ_STR(flatbuffers::GetFieldS(*root, *fields->LookupByKey("name"))
+                  ->c_str(), "Orc");
+  TEST_EQ(flatbuffers::GetFieldI<int16_t>(
+              *root, *fields->LookupByKey("hp")), 80);
+  // The dropped field is gone from the output.
+  std::string jsongen;
+  TEST_EQ(GenerateText(dst_parser, fbb.GetBufferPointer(), &jsongen), true);
+  TEST_EQ(strstr(jsongen.c_str(), "legacy") == nullptr, true);
+  TEST_NOTNULL(strstr(jsongen.c_str(), "Axe"));
+
+  // Transcoding to the same version takes the bulk-copy path for the
+  // whole (unchanged) subtree and must reproduce an equivalent buffer.
+  flatbuffers::SchemaTranscoder same(src_schema, src_schema);
+  TEST_EQ(same.Valid(), true);
+  flatbuffers::FlatBufferBuilder fbb2;
+  TEST_EQ(same.Transcode(src_parser.builder_.GetBufferPointer(), fbb2), true);
+  TEST_EQ(flatbuffers::Verify(src_schema, *src_schema.root_table(),
+                              fbb2.GetBufferPointer(), fbb2.GetSize()), true);
+  std::string json1, json2;
+  TEST_EQ(GenerateText(src_parser, src_parser.builder_.GetBufferPointer(),
+                       &json1), true);
+  TEST_EQ(GenerateText(src_parser, fbb2.GetBufferPointer(), &json2), true);
+  TEST_EQ(json1 == json2, true);
+
+  // A changed field type cannot be mapped.
+  flatbuffers::Parser bad_parser;
+  TEST_EQ(bad_parser.Parse(
+    "table Monster { name:string (required); hp:int; } root_type Monster;"),
+    true);
+  bad_parser.Serialize();
+  std::string bad_bfbs(
+      reinterpret_cast<const char *>(bad_parser.builder_.GetBufferPointer()),
+      bad_parser.builder_.GetSize());
+  flatbuffers::SchemaTranscoder bad(
+      src_schema, *reflection::GetSchema(bad_bfbs.c_str()));
+  TEST_EQ(bad.Valid(), false);
+  TEST_NOTNULL(strstr(bad.error().c_str(), "hp"));
+}
+
+void StructuralDiffTest() {
+  flatbuffers::Parser parser;
+  TEST_EQ(parser.Parse(
+    "table Weapon { name:string (key); damage:short; }"
+    "table Monster { name:string (required); hp:short = 100; mana:short;"
+    "  inventory:[ubyte]; weapons:[Weapon]; friend:Monster;"
+    "  aliases:[string]; }"
+    "root_type Monster;"), true);
+  parser.Serialize();
+  std::string bfbs(
+      reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+      parser.builder_.GetSize());
+  auto &schema = *reflection::GetSchema(bfbs.c_str());
+  auto &objectdef = *schema.root_table();
+
+  // An "old" snapshot with plenty of data the diff should not resend.
+  TEST_EQ(parser.ParseJson(
+    "{ name: \"Orc\", hp: 80,"
+    "  inventory: [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15],"
+    "  weapons: [{ name: \"Axe\", damage: 5 }, { name: \"Bow\", damage: 3 },"
+    "            { name: \"Club\", damage: 2 }],"
+    "  friend: { name: \"Slime\", hp: 5 },"
+    "  aliases: [\"Grunt\", \"Brute\", \"Basher\"] }"), true);
+  std::string old_buf(
+      reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+      parser.builder_.GetSize());
+  // The "new" snapshot changes one scalar, one weapon and one alias.
+  TEST_EQ(parser.ParseJson(
+    "{ name: \"Orc\", hp: 77,"
+    "  inventory: [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15],"
+    "  weapons: [{ name: \"Axe\", damage: 5 }, { name: \"Bow\", damage: 8 },"
+    "            { name: \"Club\", damage: 2 }],"
+    "  friend: { name: \"Slime\", hp: 5 },"
+    "  aliases: [\"Grunt\", \"Brute\", \"Smasher\"] }"), true);
+  std::string new_buf(
+      reinterpret_cast<const char *>(parser.builder_.GetBufferPointer()),
+      parser.builder_.GetSize());
+  auto &old_root = *flatbuffers::GetAnyRoot(
+      reinterpret_cast<const uint8_t *>(old_buf.c_str()));
+  auto &new_root = *flatbuffers::GetAnyRoot(
+      reinterpret_cast<const uint8_t *>(new_buf.c_str()));
+
+  TEST_EQ(flatbuffers::TablesEqual(schema, objectdef, old_root, old_root),
+          true);
+  TEST_EQ(flatbuffers::TablesEqual(schema, objectdef, old_root, new_root),
+          false);
+
+  // Identical buffers produce a trivial (header-only) delta.
+  std::vector<uint8_t> delta;
+  TEST_EQ(flatbuffers::MakeDelta(schema, objectdef, old_root, old_root,
+                                 &delta), false);
+  TEST_EQ(delta.size(), sizeof(uint64_t) + 1);
+
+  // The real delta only carries the changed fields, so it is much smaller
+  // than resending the buffer.
+  TEST_EQ(flatbuffers::MakeDelta(schema, objectdef, old_root, new_root,
+                                 &delta), true);
+  TEST_EQ(delta.size() < new_buf.size() / 2, true);
+
+  // Patching the old buffer reproduces the new one.
+  flatbuffers::FlatBufferBuilder fbb;
+  TEST_EQ(flatbuffers::ApplyDelta(schema, objectdef, old_root, delta.data(),
+                                  delta.size(), fbb), true);
+  TEST_EQ(flatbuffers::Verify(schema, objectdef, fbb.GetBufferPointer(),
+                              fbb.GetSize()), true);
+  std::string json_new, json_patched;
+  TEST_EQ(GenerateText(parser, new_buf.c_str(), &json_new), true);
+  TEST_EQ(GenerateText(parser, fbb.GetBufferPointer(), &json_patched), true);
+  TEST_EQ(json_new == json_patched, true);
+
+  // A truncated or corrupted delta is rejected, not misapplied.
+  flatbuffers::FlatBufferBuilder fbb2;
+  TEST_EQ(flatbuffers::ApplyDelta(schema, objectdef, old_root, delta.data(),
+                                  delta.size() - 3, fbb2), false);
+  auto corrupt = delta;
+  corrupt[0] ^= 0xFF;  // Break the magic.
+  flatbuffers::FlatBufferBuilder fbb3;
+  TEST_EQ(flatbuffers::ApplyDelta(schema, objectdef, old_root, corrupt.data(),
+                                  corrupt.size(), fbb3), false);
+}
+
 void FlexBuffersTest() {
   flexbuffers::Builder slb(512,
                            flexbuffers::BUILDER_FLAG_SHARE_KEYS_AND_STRINGS);
@@ -1437,6 +2392,15 @@ void FlexBuffersTest() {
   auto tvec3 = map["bar3"].AsFixedTypedVector();
   TEST_EQ(tvec3.size(), 3);
   TEST_EQ(tvec3[2].AsInt8(), 3);
+  // Bulk kernels dispatch once on the element type/width.
+  TEST_EQ(tvec.Sum<int64_t>(), 6);
+  int64_t tvmin = 0, tvmax = 0;
+  TEST_EQ(tvec.MinMax(&tvmin, &tvmax), true);
+  TEST_EQ(tvmin, 1);
+  TEST_EQ(tvmax, 3);
+  double bar_doubles[3];
+  tvec.CopyTo(bar_doubles);
+  TEST_EQ(bar_doubles[2], 3.0);
   TEST_EQ(map["foo"].AsUInt8(), 100);
   TEST_EQ(map["unknown"].IsNull(), true);
   auto mymap = map["mymap"].AsMap();
@@ -1452,6 +2416,282 @@ void FlexBuffersTest() {
   TEST_EQ(vec[2].MutateFloat(2.0f), true);
   TEST_EQ(vec[2].AsFloat(), 2.0f);
   TEST_EQ(vec[2].MutateFloat(3.14159), false);  // Double does not fit in float.
+
+  // Keys pushed in sorted order can skip the EndMap sort.
+  flexbuffers::Builder ps;
+  auto pstart = ps.StartMap();
+  ps.Int("aaa", 1);
+  ps.Int("bbb", 2);
+  ps.Int("ccc", 3);
+  ps.EndMapPresorted(pstart);
+  ps.Finish();
+  auto pmap = flexbuffers::GetRoot(ps.GetBuffer()).AsMap();
+  TEST_EQ(pmap.size(), 3);
+  TEST_EQ(pmap["bbb"].AsInt64(), 2);
+
+  // Maps with a fixed key set: the sorted key vector is serialized once
+  // and shared by every record, which then only writes its values.
+  flexbuffers::Builder rec;
+  const char *record_keys[] = { "x", "a", "m" };
+  auto keyset = rec.CreateKeySet(record_keys, 3);
+  auto rstart = rec.StartVector();
+  for (int i = 0; i < 3; i++) {
+    auto mstart = rec.StartMap();
+    // Values in sorted key order: a, m, x.
+    rec += i;
+    rec += i * 10;
+    rec += i * 100;
+    rec.EndMap(mstart, keyset);
+  }
+  rec.EndVector(rstart, false, false);
+  rec.Finish();
+  auto records = flexbuffers::GetRoot(rec.GetBuffer()).AsVector();
+  TEST_EQ(records.size(), 3);
+  for (int i = 0; i < 3; i++) {
+    auto m = records[i].AsMap();
+    TEST_EQ(m.size(), 3);
+    TEST_EQ(m["a"].AsInt64(), i);
+    TEST_EQ(m["m"].AsInt64(), i * 10);
+    TEST_EQ(m["x"].AsInt64(), i * 100);
+    // All records point at the same key vector.
+    TEST_EQ(m.Keys()[0].AsKey(), records[0].AsMap().Keys()[0].AsKey());
+  }
+}
+
+void HashFunctionsTest() {
+  // Known-answer vectors for the hardware-accelerated backends, checked
+  // against the reference implementations. The same values must come out
+  // of every build, hardware instructions or fallback.
+  TEST_EQ(flatbuffers::HashCrc32c(""), 0U);
+  TEST_EQ(flatbuffers::HashCrc32c("123456789"), 0xE3069283U);
+  TEST_EQ(flatbuffers::HashXxHash64(""), 0xEF46DB3751D8E999ULL);
+  TEST_EQ(flatbuffers::HashXxHash64("abc"), 0x44BC2CF5AD770999ULL);
+  // Long enough to exercise the four-lane 32-bytes-per-round main loop.
+  TEST_EQ(flatbuffers::HashXxHash64(
+            "The quick brown fox jumps over the lazy dog"),
+          0x0B242D361FDA71BCULL);
+  // The new backends are reachable through the attribute lookup tables.
+  TEST_EQ(flatbuffers::FindHashFunction32("crc32c_32") ==
+          flatbuffers::HashCrc32c, true);
+  TEST_EQ(flatbuffers::FindHashFunction64("xxhash_64") ==
+          flatbuffers::HashXxHash64, true);
+}
+
+// monster_test_generated.h is built with --gen-eq-hash: check the generated
+// buffer-level Equals() and HashOf() functions across scalar, string,
+// vector and subtable differences.
+void EqHashTest() {
+  auto build = [](flatbuffers::FlatBufferBuilder &fbb, const char *name,
+                  int16_t hp, uint8_t inv_last, const char *str1,
+                  const char *enemy_name) {
+    auto enemy_name_off = fbb.CreateString(enemy_name);
+    MonsterBuilder eb(fbb);
+    eb.add_name(enemy_name_off);
+    auto enemy_off = eb.Finish();
+    auto name_off = fbb.CreateString(name);
+    uint8_t inv[] = { 0, 1, 2, 3, inv_last };
+    auto inv_off = fbb.CreateVector(inv, 5);
+    const char *strs[] = { str1, "omega" };
+    std::vector<flatbuffers::Offset<flatbuffers::String>> str_offs;
+    for (int i = 0; i < 2; i++) str_offs.push_back(fbb.CreateString(strs[i]));
+    auto strs_off = fbb.CreateVector(str_offs);
+    MonsterBuilder mb(fbb);
+    mb.add_name(name_off);
+    mb.add_hp(hp);
+    mb.add_inventory(inv_off);
+    mb.add_testarrayofstring(strs_off);
+    mb.add_enemy(enemy_off);
+    FinishMonsterBuffer(fbb, mb.Finish());
+  };
+  flatbuffers::FlatBufferBuilder same1, same2, scal, vec, str, tab;
+  build(same1, "EqMonster", 80, 4, "alpha", "Fred");
+  build(same2, "EqMonster", 80, 4, "alpha", "Fred");  // Identical content.
+  build(scal,  "EqMonster", 81, 4, "alpha", "Fred");  // Scalar differs.
+  build(vec,   "EqMonster", 80, 5, "alpha", "Fred");  // Vector differs.
+  build(str,   "EqMonster", 80, 4, "beta",  "Fred");  // String differs.
+  build(tab,   "EqMonster", 80, 4, "alpha", "Barney");  // Subtable differs.
+
+  auto m_same1 = GetMonster(same1.GetBufferPointer());
+  auto m_same2 = GetMonster(same2.GetBufferPointer());
+  TEST_EQ(Equals(m_same1, m_same1), true);
+  TEST_EQ(Equals(m_same1, m_same2), true);
+  // Equal content must hash identically, and the hash is a pure function
+  // of the content: recomputing it can't give a different answer.
+  TEST_EQ(HashOf(m_same1), HashOf(m_same2));
+  TEST_EQ(HashOf(m_same1), HashOf(m_same1));
+
+  flatbuffers::FlatBufferBuilder *diffs[] = { &scal, &vec, &str, &tab };
+  for (size_t i = 0; i < 4; i++) {
+    auto m_diff = GetMonster(diffs[i]->GetBufferPointer());
+    TEST_EQ(Equals(m_same1, m_diff), false);
+    TEST_EQ(Equals(m_diff, m_same1), false);
+    TEST_EQ(HashOf(m_same1) != HashOf(m_diff), true);
+  }
+}
+
+void MappedFileTest() {
+  // Map a checked-in binary file and compare against the stream loader.
+  std::string loaded;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.bfbs", true, &loaded), true);
+  flatbuffers::MappedFile mapped;
+  TEST_EQ(mapped.Open("tests/monster_test.bfbs"), true);
+  TEST_EQ(mapped.size(), loaded.size());
+  TEST_EQ(memcmp(mapped.data(), loaded.c_str(), loaded.size()), 0);
+  // The mapped contents can be used in place.
+  flatbuffers::Verifier verifier(mapped.data(), mapped.size());
+  TEST_EQ(reflection::VerifySchemaBuffer(verifier), true);
+  mapped.Close();
+  TEST_EQ(mapped.data() == nullptr, true);
+  // Missing files fail.
+  TEST_EQ(mapped.Open("tests/does_not_exist.bin"), false);
+
+  // Copy-on-write mappings support in-place mutation: only the touched
+  // pages are materialized privately, and the file is never modified.
+  flatbuffers::MappedFile cow;
+  TEST_EQ(cow.OpenCopyOnWrite("tests/monsterdata_test.mon"), true);
+  auto monster = MyGame::Example::GetMutableMonster(cow.mutable_data());
+  TEST_EQ(monster->hp(), 80);
+  TEST_EQ(monster->mutate_hp(10), true);
+  TEST_EQ(monster->hp(), 10);
+  // A second, independent view of the file still sees the original data.
+  flatbuffers::MappedFile pristine;
+  TEST_EQ(pristine.Open("tests/monsterdata_test.mon"), true);
+  TEST_EQ(MyGame::Example::GetMonster(pristine.data())->hp(), 80);
+}
+
+void OptimizeLayoutTest() {
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.bfbs", true, &bfbsfile), true);
+  auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+
+  // Build a buffer with deliberately poor locality: duplicated strings,
+  // and a subtable that is referenced twice (a DAG).
+  flatbuffers::FlatBufferBuilder fbb;
+  auto shared_mon = CreateMonster(fbb, nullptr, 0, 1,
+                                  fbb.CreateString("Shared"));
+  std::vector<flatbuffers::Offset<Monster>> mlocs;
+  for (int i = 0; i < 3; i++) {
+    mlocs.push_back(CreateMonster(fbb, nullptr, 0,
+                                  static_cast<int16_t>(10 + i),
+                                  fbb.CreateString("duplicated")));
+  }
+  mlocs.push_back(shared_mon);
+  auto tables = fbb.CreateVector(mlocs);
+  auto root_name = fbb.CreateString("Root");
+  MonsterBuilder mb(fbb);
+  mb.add_hp(80);
+  mb.add_name(root_name);
+  mb.add_testarrayoftables(tables);
+  mb.add_enemy(shared_mon);
+  fbb.Finish(mb.Finish(), MonsterIdentifier());
+
+  flatbuffers::FlatBufferBuilder opt;
+  auto newroot = flatbuffers::OptimizeLayout(
+      opt, schema, *schema.root_table(),
+      *flatbuffers::GetAnyRoot(fbb.GetBufferPointer()));
+  opt.Finish(flatbuffers::Offset<Monster>(newroot.o), MonsterIdentifier());
+
+  flatbuffers::Verifier verifier(opt.GetBufferPointer(), opt.GetSize());
+  TEST_EQ(VerifyMonsterBuffer(verifier), true);
+  auto m = GetMonster(opt.GetBufferPointer());
+  TEST_EQ(m->hp(), 80);
+  TEST_EQ_STR(m->name()->c_str(), "Root");
+  TEST_EQ(m->testarrayoftables()->size(), 4);
+  TEST_EQ(m->testarrayoftables()->Get(1)->hp(), 11);
+
+  // String pooling makes the rewritten buffer smaller.
+  TEST_EQ(opt.GetSize() < fbb.GetSize(), true);
+  // The shared subtable stays shared instead of being duplicated.
+  TEST_EQ(m->enemy() == m->testarrayoftables()->Get(3), true);
+  // Depth-first field order: the root precedes its subobjects, and
+  // sibling vector elements read in index order.
+  auto raw = [](const void *p) { return reinterpret_cast<uintptr_t>(p); };
+  TEST_EQ(raw(m) < raw(m->testarrayoftables()), true);
+  TEST_EQ(raw(m->testarrayoftables()) <
+          raw(m->testarrayoftables()->Get(0)), true);
+  TEST_EQ(raw(m->testarrayoftables()->Get(0)) <
+          raw(m->testarrayoftables()->Get(1)), true);
+}
+
+void FlexToFlatConversionTest() {
+  // Load the binary schema and compile a conversion plan from it.
+  std::string bfbsfile;
+  TEST_EQ(flatbuffers::LoadFile(
+    "tests/monster_test.bfbs", true, &bfbsfile), true);
+  auto &schema = *reflection::GetSchema(bfbsfile.c_str());
+  flatbuffers::FlexToFlatConverter converter(schema);
+
+  // A FlexBuffer document shaped like a Monster.
+  flexbuffers::Builder slb;
+  slb.Map([&]() {
+    slb.Int("hp", 80);
+    slb.Int("mana", 150);  // The schema default: should stay absent.
+    slb.String("name", "MyMonster");
+    uint8_t inv[] = { 0, 1, 2, 3, 4 };
+    slb.Vector("inventory", inv, 5);  // Width 1: taken by the bulk copy path.
+    slb.Vector("testarrayofstring", [&]() {
+      slb += "bob";
+      slb += "fred";
+    });
+    slb.Map("enemy", [&]() {
+      slb.String("name", "Fred");
+    });
+    slb.Int("ignored_key", 1);  // Not in the schema: skipped.
+  });
+  slb.Finish();
+
+  flatbuffers::FlatBufferBuilder fbb;
+  TEST_EQ(converter.Convert(flexbuffers::GetRoot(slb.GetBuffer()), fbb), true);
+  TEST_EQ(flatbuffers::Verify(schema, *schema.root_table(),
+                              fbb.GetBufferPointer(), fbb.GetSize()), true);
+  auto monster = GetMonster(fbb.GetBufferPointer());
+  TEST_EQ(monster->hp(), 80);
+  TEST_EQ(monster->mana(), 150);
+  TEST_EQ(monster->inventory()->size(), 5);
+  TEST_EQ(monster->inventory()->Get(3), 3);
+  TEST_EQ_STR(monster->name()->c_str(), "MyMonster");
+  TEST_EQ(monster->testarrayofstring()->size(), 2);
+  TEST_EQ_STR(monster->testarrayofstring()->Get(1)->c_str(), "fred");
+  TEST_EQ_STR(monster->enemy()->name()->c_str(), "Fred");
+
+  // A document missing a required field must be rejected.
+  flexbuffers::Builder bad;
+  bad.Map([&]() { bad.Int("hp", 80); });
+  bad.Finish();
+  flatbuffers::FlatBufferBuilder fbb2;
+  TEST_EQ(converter.Convert(flexbuffers::GetRoot(bad.GetBuffer()), fbb2),
+          false);
+
+  // The converter caches matched key sets by the key vector's address, so
+  // a different document whose keys land at a reused address must not be
+  // converted with the stale match.
+  flexbuffers::Builder doc1;
+  doc1.Map([&]() {
+    doc1.Int("hp", 1);
+    doc1.String("name", "A");
+  });
+  doc1.Finish();
+  flexbuffers::Builder doc2;
+  doc2.Map([&]() {
+    doc2.String("name", "B");
+    doc2.Int("xp", 1);  // Unknown key, same length as "hp".
+  });
+  doc2.Finish();
+  // Identical layout, so replaying doc2 over doc1's storage puts its key
+  // vector at the very same address doc1's was matched at.
+  TEST_EQ(doc1.GetBuffer().size(), doc2.GetBuffer().size());
+  auto storage = doc1.GetBuffer();
+  flatbuffers::FlatBufferBuilder fbb3;
+  TEST_EQ(converter.Convert(flexbuffers::GetRoot(storage), fbb3), true);
+  TEST_EQ(GetMonster(fbb3.GetBufferPointer())->hp(), 1);
+  memcpy(storage.data(), doc2.GetBuffer().data(), storage.size());
+  flatbuffers::FlatBufferBuilder fbb4;
+  TEST_EQ(converter.Convert(flexbuffers::GetRoot(storage), fbb4), true);
+  auto remonster = GetMonster(fbb4.GetBufferPointer());
+  TEST_EQ(remonster->hp(), 100);  // The schema default: absent in doc2.
+  TEST_EQ_STR(remonster->name()->c_str(), "B");
 }
 
 int main(int /*argc*/, const char * /*argv*/[]) {
@@ -1463,15 +2703,44 @@ int main(int /*argc*/, const char * /*argv*/[]) {
                        rawbuf.length());
   AccessFlatBufferTest(flatbuf.get(), rawbuf.length());
 
+  FastVerifierTest(flatbuf.get(), rawbuf.length());
+
   MutateFlatBuffersTest(flatbuf.get(), rawbuf.length());
 
   ObjectFlatBuffersTest(flatbuf.get());
 
+  ArenaAllocatorTest();
+  VtableDedupTest();
+  SharedStringTest();
+  UninitializedVectorTest();
+  VectorStreamerTest();
+  EndianKernelTest();
+  SpliceBufferTest();
+  StreamWriterTest();
+  ArchiveTest();
+  BuilderStatsTest();
+  DetachedBufferTest();
+  SharedBufferTest();
+  ParallelVerifyTest();
+  EytzingerIndexTest();
+  GetBatchTest();
+  ObjectArenaTest();
+  ColumnExtractTest();
+  NumToStringTest();
+
   SizePrefixedTest();
+  HashFunctionsTest();
+  EqHashTest();
 
   #ifndef FLATBUFFERS_NO_FILE_TESTS
   ParseAndGenerateTextTest();
+  ParseAndGenerateTextFromBinarySchemaTest();
+  SchemaCacheTest();
+  ParserReuseTest();
   ReflectionTest(flatbuf.get(), rawbuf.length());
+  FlexToFlatConversionTest();
+  OptimizeLayoutTest();
+  MappedFileTest();
   ParseProtoTest();
   UnionVectorTest();
   #endif
@@ -1487,11 +2756,14 @@ int main(int /*argc*/, const char * /*argv*/[]) {
   UnicodeTestAllowNonUTF8();
   UnicodeTestGenerateTextFailsOnNonUTF8();
   UnicodeSurrogatesTest();
+  LongStringLexTest();
   UnicodeInvalidSurrogatesTest();
   InvalidUTF8Test();
   UnknownFieldsTest();
   ParseUnionTest();
   ConformTest();
+  SchemaEvolutionTest();
+  StructuralDiffTest();
 
   FlexBuffersTest();
 